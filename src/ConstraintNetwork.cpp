@@ -7,10 +7,12 @@ namespace templ {
 
 ConstraintNetwork::ConstraintNetwork(graph_analysis::BaseGraph::ImplementationType type)
     : mGraph(BaseGraph::getInstance(type))
+    , mRevision(0)
 {}
 
 ConstraintNetwork::ConstraintNetwork(const ConstraintNetwork& other)
     : mGraph(other.mGraph->cloneEdges())
+    , mRevision(0)
 {
 }
 
@@ -23,11 +25,13 @@ ConstraintNetwork::Ptr ConstraintNetwork::clone() const
 
 void ConstraintNetwork::addVariable(const Variable::Ptr& variable)
 {
+    markModified();
     mGraph->addVertex(variable);
 }
 
 void ConstraintNetwork::addConstraint(const Constraint::Ptr& constraint)
 {
+    markModified();
     Edge::Ptr edge = dynamic_pointer_cast<Edge>(constraint);
     if(edge)
     {
@@ -45,6 +49,7 @@ void ConstraintNetwork::addConstraint(const Constraint::Ptr& constraint)
 
 void ConstraintNetwork::removeConstraint(const Constraint::Ptr& constraint)
 {
+    markModified();
     Edge::Ptr edge = dynamic_pointer_cast<Edge>(constraint);
     if(edge)
     {
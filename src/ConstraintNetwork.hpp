@@ -17,6 +17,8 @@ class ConstraintNetwork
 protected:
     // Internal representation of the constraint network
     graph_analysis::BaseGraph::Ptr mGraph;
+    // Modification counter, see getRevision
+    uint64_t mRevision;
 
 public:
     typedef shared_ptr<ConstraintNetwork> Ptr;
@@ -74,11 +76,27 @@ public:
      */
     graph_analysis::BaseGraph::Ptr getGraph() const { return mGraph; }
 
+    /**
+     * Get the revision of this constraint network, which is incremented with
+     * every modification through this interface, so that derived information
+     * can be cached
+     *
+     * Note that modifications applied directly to the underlying graph are
+     * not accounted for
+     */
+    uint64_t getRevision() const { return mRevision; }
+
 protected:
+    /**
+     * Mark this constraint network as modified, e.g., after changing the type
+     * of an existing constraint
+     */
+    void markModified() { ++mRevision; }
+
     /**
      * Set the underlying graph of this constraint network
      */
-    graph_analysis::BaseGraph::Ptr setGraph(const graph_analysis::BaseGraph::Ptr& graph) { return mGraph = graph; }
+    graph_analysis::BaseGraph::Ptr setGraph(const graph_analysis::BaseGraph::Ptr& graph) { markModified(); return mGraph = graph; }
 
     virtual ConstraintNetwork* getClone() const { return new ConstraintNetwork(*this); }
 
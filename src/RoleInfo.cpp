@@ -27,26 +27,94 @@ std::map<RoleInfo::Attribute, std::string> RoleInfo::AttributeTxt =
 }
  ;
 
+namespace {
+
+/**
+ * Get the index of a tag in RoleInfo::mTagged, NUMBER_OF_TAGS for untagged
+ * roles
+ * \return false if this is not a predefined tag
+ */
+bool getTagIndex(const std::string& tag, size_t& index)
+{
+    if(tag.empty())
+    {
+        index = RoleInfo::NUMBER_OF_TAGS;
+        return true;
+    }
+    for(const std::pair<const RoleInfo::Tag, std::string>& p : RoleInfo::TagTxt)
+    {
+        if(p.second == tag)
+        {
+            index = p.first;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // end anonymous namespace
+
 RoleInfo::RoleInfo()
-    : mRoles()
-    , mTaggedRoles()
+    : mCustomTagged()
 {}
 
+utils::BitSet& RoleInfo::getTaggedRoleIds(const std::string& tag)
+{
+    size_t index;
+    if(getTagIndex(tag, index))
+    {
+        return mTagged[index];
+    }
+    return mCustomTagged[tag];
+}
+
+const utils::BitSet& RoleInfo::getRoleIds(const std::string& tag) const
+{
+    size_t index;
+    if(getTagIndex(tag, index))
+    {
+        return mTagged[index];
+    }
+    std::map<std::string, utils::BitSet>::const_iterator cit = mCustomTagged.find(tag);
+    if(cit != mCustomTagged.end())
+    {
+        return cit->second;
+    }
+    static const utils::BitSet empty;
+    return empty;
+}
+
+Role::Set RoleInfo::toRoleSet(const utils::BitSet& ids)
+{
+    const RoleRegistry& registry = RoleRegistry::getInstance();
+    Role::Set roles;
+    for(size_t id = ids.findNext(0); id != utils::BitSet::npos; id = ids.findNext(id+1))
+    {
+        roles.insert(roles.end(), registry.getRole(id));
+    }
+    return roles;
+}
+
+Role::List RoleInfo::toRoleList(const utils::BitSet& ids)
+{
+    Role::Set roles = toRoleSet(ids);
+    return Role::List(roles.begin(), roles.end());
+}
+
 void RoleInfo::addRole(const Role& role, const Tag& tag)
 {
-    addRole(role, TagTxt[ tag ]);
+    assert(!role.getName().empty());
+    RoleRegistry::Id id = RoleRegistry::getInstance().getId(role);
+    mTagged[tag].set(id);
+    mAllRoles.set(id);
 }
 
 void RoleInfo::addRole(const Role& role, const std::string& tag)
 {
     assert(!role.getName().empty());
-    if(tag.empty())
-    {
-        mRoles.insert(role);
-    } else {
-        mTaggedRoles[tag].insert(role);
-    }
-    mAllRoles.insert(role);
+    RoleRegistry::Id id = RoleRegistry::getInstance().getId(role);
+    getTaggedRoleIds(tag).set(id);
+    mAllRoles.set(id);
 }
 
 void RoleInfo::removeRole(const Role& role, const Tag& tag)
@@ -57,86 +125,90 @@ void RoleInfo::removeRole(const Role& role, const Tag& tag)
 void RoleInfo::removeRole(const Role& role, const std::string& tag)
 {
     assert(!role.getName().empty());
+    RoleRegistry::Id id;
+    if(!RoleRegistry::getInstance().findId(role, id))
+    {
+        return;
+    }
+
+    utils::BitSet& taggedRoles = getTaggedRoleIds(tag);
     if(tag.empty())
     {
-        if(mRoles.erase(role) != 0)
+        if(taggedRoles.test(id))
         {
+            taggedRoles.reset(id);
             throw std::runtime_error("templ::RoleInfo::removeRole failed to remove (any) role");
         }
     } else {
-        mTaggedRoles[tag].erase(role);
+        taggedRoles.reset(id);
     }
-
-    // mAllRoles.insert(role);
 }
 
 
-const std::set<Role>& RoleInfo::getRoles(const std::string& tag) const
+std::set<Role> RoleInfo::getRoles(const std::string& tag) const
 {
-    if(tag.empty())
-    {
-        return mRoles;
-    }
-    return mTaggedRoles[tag];
+    return toRoleSet(getRoleIds(tag));
 }
 
-const std::set<Role>& RoleInfo::getRoles(const Tag& tag) const
+std::set<Role> RoleInfo::getRoles(const Tag& tag) const
 {
-    return getRoles( TagTxt[tag] );
+    return toRoleSet(mTagged[tag]);
 }
 
 const std::set<Role> RoleInfo::getRoles(const std::set<Tag>& tags) const
 {
-    std::set<Role> roles;
+    utils::BitSet ids;
     for(const Tag& t : tags)
     {
-        const std::set<Role>& tagRoles = getRoles( t );
-        roles.insert(tagRoles.begin(), tagRoles.end());
+        ids |= mTagged[t];
     }
-    return roles;
+    return toRoleSet(ids);
 }
 
 moreorg::ModelPool RoleInfo::getModelPool(const std::set<Tag>& tags) const
 {
-    std::set<Role> roles = getRoles(tags);
+    utils::BitSet ids;
+    for(const Tag& t : tags)
+    {
+        ids |= mTagged[t];
+    }
 
+    const RoleRegistry& registry = RoleRegistry::getInstance();
     moreorg::ModelPool agentPool;
-    for(const Role& r : roles)
+    for(size_t id = ids.findNext(0); id != utils::BitSet::npos; id = ids.findNext(id+1))
     {
-        agentPool[r.getModel()] += 1;
+        agentPool[registry.getRole(id).getModel()] += 1;
     }
     return agentPool;
 }
 
 bool RoleInfo::hasRole(const Role& role, const std::string& tag) const
 {
-    const std::set<Role>* roleSet = 0;
-    if(tag.empty())
-    {
-        roleSet = &mRoles;
-    } else {
-        roleSet = &mTaggedRoles[tag];
-    }    return roleSet->end() != roleSet->find(role);
+    RoleRegistry::Id id;
+    return RoleRegistry::getInstance().findId(role, id) && getRoleIds(tag).test(id);
 }
 
 bool RoleInfo::hasRole(const Role& role, const Tag& tag) const
 {
-    return hasRole(role, TagTxt[tag]);
+    RoleRegistry::Id id;
+    return RoleRegistry::getInstance().findId(role, id) && mTagged[tag].test(id);
 }
 
 std::string RoleInfo::toString(uint32_t indent) const
 {
     std::stringstream ss;
     std::string hspace(indent,' ');
-    if(!mRoles.empty())
+    const utils::BitSet& untagged = mTagged[NUMBER_OF_TAGS];
+    if(untagged.any())
     {
         ss << hspace << "    roles:" << std::endl;
-        Role::TypeMap typeMap = Role::toTypeMap(mRoles);
+        Role::TypeMap typeMap = Role::toTypeMap(toRoleSet(untagged));
         ss << Role::toString(typeMap, indent + 8);
     }
 
-    std::map<std::string, std::set<Role> >::const_iterator rit = mTaggedRoles.begin();
-    for(; rit != mTaggedRoles.end(); ++rit)
+    std::map<std::string, std::set<Role> > taggedRoles = getTaggedRoleSets();
+    std::map<std::string, std::set<Role> >::const_iterator rit = taggedRoles.begin();
+    for(; rit != taggedRoles.end(); ++rit)
     {
         const std::set<Role>& roles = rit->second;
         if(!roles.empty())
@@ -149,46 +221,38 @@ std::string RoleInfo::toString(uint32_t indent) const
     return ss.str();
 }
 
-const Role::Set& RoleInfo::getAllRoles() const
+Role::Set RoleInfo::getAllRoles() const
 {
-    if(mAllRoles.empty() && !(mRoles.empty() && mTaggedRoles.empty()))
-    {
-        mAllRoles.insert(mRoles.begin(), mRoles.end());
-	std::map<std::string, std::set<Role> >::const_iterator cit = mTaggedRoles.begin();
-  	for( ; cit != mTaggedRoles.end(); ++cit)
-        {
-            const std::set<Role>& taggedRoles = cit->second;
-            mAllRoles.insert(taggedRoles.begin(), taggedRoles.end());
-        }
-    }
-    return mAllRoles;
+    return toRoleSet(mAllRoles);
 }
 
 RoleInfo::Status RoleInfo::getStatus(const owlapi::model::IRI& model, uint32_t id) const
 {
-    try {
-        const Role& role = getRole(model, id);
-        if(hasRole(role, REQUIRED))
+    RoleRegistry::Id roleId;
+    if(!RoleRegistry::getInstance().findId(Role(id, model), roleId)
+            || !mAllRoles.test(roleId))
+    {
+        // role unknown
+        return UNKNOWN_STATUS;
+    }
+
+    if(mTagged[REQUIRED].test(roleId))
+    {
+        if(mTagged[ASSIGNED].test(roleId))
         {
-            if(hasRole(role, ASSIGNED))
-            {
-                return REQUIRED_ASSIGNED;
-            } else {
-                return REQUIRED_UNASSIGNED;
-            }
-        } else { // NOT REQUIRED
+            return REQUIRED_ASSIGNED;
+        } else {
+            return REQUIRED_UNASSIGNED;
+        }
+    } else { // NOT REQUIRED
+        if(mTagged[ASSIGNED].test(roleId))
         {
-            if(hasRole(role, ASSIGNED))
-            {
-                return NOTREQUIRED_ASSIGNED;
-            }
-	    if(hasRole(role, AVAILABLE))
-                return NOTREQUIRED_AVAILABLE;
-            }
+            return NOTREQUIRED_ASSIGNED;
+        }
+        if(mTagged[AVAILABLE].test(roleId))
+        {
+            return NOTREQUIRED_AVAILABLE;
         }
-    } catch(const std::invalid_argument& e)
-    {
-        // role unknown
     }
     return UNKNOWN_STATUS;
 }
@@ -196,10 +260,11 @@ RoleInfo::Status RoleInfo::getStatus(const owlapi::model::IRI& model, uint32_t i
 std::set<RoleInfo::Status> RoleInfo::getStati() const
 {
     std::set<RoleInfo::Status> stati;
-    Role::Set roles = getAllRoles();
-    for(const Role& role : roles)
+    const RoleRegistry& registry = RoleRegistry::getInstance();
+    const utils::BitSet& ids = mAllRoles;
+    for(size_t id = ids.findNext(0); id != utils::BitSet::npos; id = ids.findNext(id+1))
     {
-        stati.insert( getStatus(role) );
+        stati.insert( getStatus(registry.getRole(id)) );
     }
     return stati;
 }
@@ -207,13 +272,24 @@ std::set<RoleInfo::Status> RoleInfo::getStati() const
 std::set<std::string> RoleInfo::getTags(const Role& role) const
 {
     std::set<std::string> tags;
-    for(const std::pair<std::string, Role::Set>& p : mTaggedRoles)
+    RoleRegistry::Id id;
+    if(!RoleRegistry::getInstance().findId(role, id))
+    {
+        return tags;
+    }
+
+    for(size_t t = 0; t < NUMBER_OF_TAGS; ++t)
+    {
+        if(mTagged[t].test(id))
+        {
+            tags.insert(TagTxt[ static_cast<Tag>(t) ]);
+        }
+    }
+    for(const std::pair<const std::string, utils::BitSet>& p : mCustomTagged)
     {
-        const std::string& tag = p.first;
-        const Role::Set& roles = p.second;
-        if(roles.end() != std::find(roles.begin(), roles.end(), role))
+        if(p.second.test(id))
         {
-            tags.insert(tag);
+            tags.insert(p.first);
         }
     }
     return tags;
@@ -221,11 +297,22 @@ std::set<std::string> RoleInfo::getTags(const Role& role) const
 
 bool RoleInfo::hasTag(const Role& role) const
 {
-    std::set<std::string> tags;
-    for(const std::pair<std::string, Role::Set>& p : mTaggedRoles)
+    RoleRegistry::Id id;
+    if(!RoleRegistry::getInstance().findId(role, id))
+    {
+        return false;
+    }
+
+    for(size_t t = 0; t < NUMBER_OF_TAGS; ++t)
+    {
+        if(mTagged[t].test(id))
+        {
+            return true;
+        }
+    }
+    for(const std::pair<const std::string, utils::BitSet>& p : mCustomTagged)
     {
-        const Role::Set& roles = p.second;
-        if(roles.end() != std::find(roles.begin(), roles.end(), role))
+        if(p.second.test(id))
         {
             return true;
         }
@@ -235,14 +322,11 @@ bool RoleInfo::hasTag(const Role& role) const
 
 const Role& RoleInfo::getRole(const owlapi::model::IRI& model, uint32_t id) const
 {
-    Role::Set::const_iterator cit;
-    cit = std::find_if(mAllRoles.begin(), mAllRoles.end(), [&model,id](const Role& other)
-            {
-                return other.getModel() == model && other.getId() == id;
-            });
-    if(cit != mAllRoles.end())
+    const RoleRegistry& registry = RoleRegistry::getInstance();
+    RoleRegistry::Id roleId;
+    if(registry.findId(Role(id, model), roleId) && mAllRoles.test(roleId))
     {
-        return *cit;
+        return registry.getRole(roleId);
     }
 
     throw std::invalid_argument("templ::RoleInfo::getRole: could not find role: " +
@@ -251,47 +335,13 @@ const Role& RoleInfo::getRole(const owlapi::model::IRI& model, uint32_t id) cons
 
 Role::List RoleInfo::getRelativeComplement(const std::string& tag0, const std::string& tag1) const
 {
-    std::set<Role> tag0Roles = getRoles(tag0);
-    std::set<Role> tag1Roles = getRoles(tag1);
-    std::vector<Role> delta(tag0Roles.begin(), tag0Roles.end());
-
-    for(size_t r0 = 0; r0 < delta.size();)
-    {
-        bool found = false;
-        for(const Role& tag1Role : tag1Roles)
-        {
-            if( delta[r0] == tag1Role)
-            {
-                delta.erase( delta.begin() + r0);
-                found = true;
-                break;
-            }
-        }
-        if(!found)
-        {
-            ++r0;
-        }
-    }
-
-    return delta;
+    return toRoleList( getRoleIds(tag0) - getRoleIds(tag1) );
 }
 
 
 Role::List RoleInfo::getIntersection(const std::string& tag0, const std::string& tag1) const
 {
-
-    std::set<Role> tag0Roles = getRoles(tag0);
-    std::set<Role> tag1Roles = getRoles(tag1);
-
-    Role::List result(tag0Roles.size() + tag1Roles.size());
-    Role::List::iterator it;
-
-    it = std::set_intersection(tag0Roles.begin(), tag0Roles.end(),
-            tag1Roles.begin(),
-            tag1Roles.end(), result.begin());
-
-    result.resize(it - result.begin());
-    return result;
+    return toRoleList( getRoleIds(tag0) & getRoleIds(tag1) );
 }
 
 Role::List RoleInfo::getIntersection(const Role::Set& set0, const Role::Set& set1)
@@ -309,26 +359,64 @@ Role::List RoleInfo::getIntersection(const Role::Set& set0, const Role::Set& set
 
 Role::List RoleInfo::getSymmetricDifference(const std::string& tag0, const std::string& tag1) const
 {
+    return toRoleList( getRoleIds(tag0) ^ getRoleIds(tag1) );
+}
 
-    std::set<Role> tag0Roles = getRoles(tag0);
-    std::set<Role> tag1Roles = getRoles(tag1);
+std::map<std::string, Role::Set> RoleInfo::getTaggedRoleSets() const
+{
+    std::map<std::string, Role::Set> taggedRoles;
+    for(size_t t = 0; t < NUMBER_OF_TAGS; ++t)
+    {
+        if(mTagged[t].any())
+        {
+            taggedRoles[ TagTxt[ static_cast<Tag>(t) ] ] = toRoleSet(mTagged[t]);
+        }
+    }
+    for(const std::pair<const std::string, utils::BitSet>& p : mCustomTagged)
+    {
+        if(p.second.any())
+        {
+            taggedRoles[p.first] = toRoleSet(p.second);
+        }
+    }
+    return taggedRoles;
+}
 
-    Role::List result(tag0Roles.size() + tag1Roles.size());
-    Role::List::iterator it;
+void RoleInfo::setRoles(const Role::Set& roles, const std::string& tag)
+{
+    RoleRegistry& registry = RoleRegistry::getInstance();
+    utils::BitSet& taggedRoles = getTaggedRoleIds(tag);
+    taggedRoles.clear();
+    for(const Role& role : roles)
+    {
+        RoleRegistry::Id id = registry.getId(role);
+        taggedRoles.set(id);
+        mAllRoles.set(id);
+    }
+}
 
-    it = std::set_symmetric_difference(tag0Roles.begin(), tag0Roles.end(),
-            tag1Roles.begin(),
-            tag1Roles.end(), result.begin());
+void RoleInfo::setTaggedRoleSets(const std::map<std::string, Role::Set>& taggedRoles)
+{
+    for(size_t t = 0; t < NUMBER_OF_TAGS; ++t)
+    {
+        mTagged[t].clear();
+    }
+    mCustomTagged.clear();
 
-    result.resize(it - result.begin());
-    return result;
+    for(const std::pair<const std::string, Role::Set>& p : taggedRoles)
+    {
+        setRoles(p.second, p.first);
+    }
 }
 
 void RoleInfo::clear()
 {
+    for(size_t t = 0; t <= NUMBER_OF_TAGS; ++t)
+    {
+        mTagged[t].clear();
+    }
+    mCustomTagged.clear();
     mAllRoles.clear();
-    mRoles.clear();
-    mTaggedRoles.clear();
 }
 
 void RoleInfo::setAttribute(const std::string& attributeName, double value)
@@ -2,13 +2,21 @@
 #define TEMPL_ROLE_INFO_HPP
 
 #include <set>
+#include <map>
 #include "SharedPtr.hpp"
 #include "Role.hpp"
+#include "RoleRegistry.hpp"
+#include "utils/BitSet.hpp"
 
 namespace templ {
 
 /**
  * Allow to collect related roles into a single object
+ *
+ * Roles are stored per tag as sets of ids of the RoleRegistry, so that
+ * lookups and set operations do not need to compare roles. Only the ids
+ * are stored: the std::set based accessors create the set of roles on
+ * request, so that performance critical code should use getRoleIds instead.
  */
 class RoleInfo
 {
@@ -19,7 +27,8 @@ public:
         ASSIGNED = 1,
         REQUIRED,
         AVAILABLE,
-        INFEASIBLE
+        INFEASIBLE,
+        NUMBER_OF_TAGS
     };
 
     // assigned (according to current solution -- CSP step)
@@ -55,15 +64,20 @@ public:
 
     bool hasRole(const Role& role, const Tag& tag) const;
 
-    const std::set<Role>& getRoles(const std::string& tag ="") const;
+    std::set<Role> getRoles(const std::string& tag ="") const;
 
-    const std::set<Role>& getRoles(const Tag& tag) const;
+    std::set<Role> getRoles(const Tag& tag) const;
 
     const std::set<Role> getRoles(const std::set<Tag>& tags) const;
 
     moreorg::ModelPool getModelPool(const std::set<Tag>& tags) const;
 
-    const std::set<Role>& getAllRoles() const;
+    std::set<Role> getAllRoles() const;
+
+    /**
+     * Get the ids (see RoleRegistry) of all roles
+     */
+    const utils::BitSet& getAllRoleIds() const { return mAllRoles; }
 
     /**
      * Get the status a particular role
@@ -111,6 +125,13 @@ public:
 
     static Role::List getIntersection(const Role::Set& set0, const Role::Set& set1);
 
+    /**
+     * Get the ids (see RoleRegistry) of the roles with the given tag
+     */
+    const utils::BitSet& getRoleIds(const Tag& tag) const { return mTagged[tag]; }
+
+    const utils::BitSet& getRoleIds(const std::string& tag = "") const;
+
     /**
      * Get the symmetric difference between tag0 and tag1 set
      */
@@ -133,9 +154,38 @@ public:
     double getAttribute(const std::string& attributeName) const;
 
 protected:
-    mutable std::set<Role> mAllRoles;
-    std::set<Role> mRoles;
-    mutable std::map<std::string, Role::Set> mTaggedRoles;
+    /**
+     * Get the role ids for a tag, which are created if they do not
+     * exist yet
+     */
+    utils::BitSet& getTaggedRoleIds(const std::string& tag);
+
+    /**
+     * Get all tagged roles (excluding untagged roles), e.g., for
+     * serialization
+     */
+    std::map<std::string, Role::Set> getTaggedRoleSets() const;
+
+    /**
+     * Replace the roles for the given tag
+     */
+    void setRoles(const Role::Set& roles, const std::string& tag = "");
+
+    /**
+     * Replace all tagged roles
+     */
+    void setTaggedRoleSets(const std::map<std::string, Role::Set>& taggedRoles);
+
+    static Role::Set toRoleSet(const utils::BitSet& ids);
+    static Role::List toRoleList(const utils::BitSet& ids);
+
+    /// Role ids for the predefined tags, index NUMBER_OF_TAGS holds
+    /// the untagged roles
+    utils::BitSet mTagged[NUMBER_OF_TAGS + 1];
+    /// Role ids for all other tags
+    std::map<std::string, utils::BitSet> mCustomTagged;
+    /// Ids of all roles that have ever been added
+    utils::BitSet mAllRoles;
     std::map<std::string, double> mAttributes;
 };
 
@@ -0,0 +1,168 @@
+#include "RoleRegistry.hpp"
+#include <stdexcept>
+#include <limits>
+
+namespace templ {
+
+const size_t RoleRegistry::FIRST_CHUNK_BITS;
+const size_t RoleRegistry::MAX_CHUNKS;
+const size_t RoleRegistry::MIN_TABLE_CAPACITY;
+
+size_t RoleRegistry::RoleHash::operator()(const Role& role) const
+{
+    return std::hash<std::string>()(role.getModel().toString()) ^ (static_cast<size_t>(role.getId()) * 0x9e3779b9);
+}
+
+RoleRegistry::Table::Table(size_t capacity)
+    : capacity(capacity)
+    , slots(new std::atomic<Id>[capacity])
+{
+    for(size_t i = 0; i < capacity; ++i)
+    {
+        slots[i].store(0, std::memory_order_relaxed);
+    }
+}
+
+RoleRegistry& RoleRegistry::getInstance()
+{
+    static RoleRegistry registry;
+    return registry;
+}
+
+RoleRegistry::RoleRegistry()
+    : mSize(0)
+    , mTable(nullptr)
+{
+    for(size_t k = 0; k < MAX_CHUNKS; ++k)
+    {
+        mChunks[k] = nullptr;
+    }
+    mTables.push_back(std::unique_ptr<Table>(new Table(MIN_TABLE_CAPACITY)));
+    mTable.store(mTables.back().get(), std::memory_order_release);
+}
+
+RoleRegistry::~RoleRegistry()
+{
+    for(size_t k = 0; k < MAX_CHUNKS; ++k)
+    {
+        delete[] mChunks[k];
+    }
+}
+
+size_t RoleRegistry::getChunk(size_t index, size_t& offset)
+{
+    // chunk k starts at index (2^k - 1)*2^FIRST_CHUNK_BITS
+    size_t n = (index >> FIRST_CHUNK_BITS) + 1;
+    size_t k = 0;
+    while(n >>= 1)
+    {
+        ++k;
+    }
+    offset = index - (((size_t(1) << k) - 1) << FIRST_CHUNK_BITS);
+    return k;
+}
+
+const Role& RoleRegistry::at(Id id) const
+{
+    size_t offset;
+    size_t k = getChunk(id, offset);
+    return *mChunks[k][offset];
+}
+
+void RoleRegistry::insert(Table& table, Id id) const
+{
+    size_t mask = table.capacity - 1;
+    size_t slot = RoleHash()(at(id)) & mask;
+    while(table.slots[slot].load(std::memory_order_relaxed) != 0)
+    {
+        slot = (slot + 1) & mask;
+    }
+    table.slots[slot].store(id + 1, std::memory_order_release);
+}
+
+RoleRegistry::Id RoleRegistry::getId(const Role& role)
+{
+    Id id;
+    if(findId(role, id))
+    {
+        return id;
+    }
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    // the role might have been registered in the meantime
+    if(findId(role, id))
+    {
+        return id;
+    }
+
+    size_t size = mSize.load(std::memory_order_relaxed);
+    size_t offset;
+    size_t k = getChunk(size, offset);
+    if(k >= MAX_CHUNKS || size >= std::numeric_limits<Id>::max())
+    {
+        throw std::overflow_error("templ::RoleRegistry::getId: maximum number of roles reached");
+    }
+    if(!mChunks[k])
+    {
+        mChunks[k] = new const Role*[size_t(1) << (FIRST_CHUNK_BITS + k)];
+    }
+
+    id = static_cast<Id>(size);
+    mRoles.push_back(role);
+    mChunks[k][offset] = &mRoles.back();
+    // publish the role before it can be found through the table
+    mSize.store(size + 1, std::memory_order_release);
+
+    Table* table = mTable.load(std::memory_order_relaxed);
+    // keep the load factor at most 0.5
+    if(2*(size + 1) > table->capacity)
+    {
+        std::unique_ptr<Table> grown(new Table(2*table->capacity));
+        for(Id i = 0; i <= id; ++i)
+        {
+            insert(*grown, i);
+        }
+        mTables.push_back(std::move(grown));
+        mTable.store(mTables.back().get(), std::memory_order_release);
+    } else {
+        insert(*table, id);
+    }
+    return id;
+}
+
+bool RoleRegistry::findId(const Role& role, Id& id) const
+{
+    const Table* table = mTable.load(std::memory_order_acquire);
+    size_t mask = table->capacity - 1;
+    size_t slot = RoleHash()(role) & mask;
+    for(;;)
+    {
+        Id value = table->slots[slot].load(std::memory_order_acquire);
+        if(value == 0)
+        {
+            return false;
+        }
+        if(at(value - 1) == role)
+        {
+            id = value - 1;
+            return true;
+        }
+        slot = (slot + 1) & mask;
+    }
+}
+
+const Role& RoleRegistry::getRole(Id id) const
+{
+    if(id >= mSize.load(std::memory_order_acquire))
+    {
+        throw std::out_of_range("templ::RoleRegistry::getRole: unknown role id " + std::to_string(id));
+    }
+    return at(id);
+}
+
+size_t RoleRegistry::size() const
+{
+    return mSize.load(std::memory_order_acquire);
+}
+
+} // end namespace templ
@@ -0,0 +1,124 @@
+#ifndef TEMPL_ROLE_REGISTRY_HPP
+#define TEMPL_ROLE_REGISTRY_HPP
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "Role.hpp"
+
+namespace templ {
+
+/**
+ * Interning table which maps roles to dense integer ids
+ *
+ * Comparing roles involves comparing model IRIs as strings, so that sets of
+ * roles are stored as sets of ids instead (see RoleInfo). An id remains
+ * valid for the lifetime of the process and the registry is shared by all
+ * missions, since RoleInfo objects are also created without a mission at
+ * hand, e.g., when loading a solution from file.
+ *
+ * Lookups, i.e., findId and getRole, do not lock, since they are performed
+ * for every role query of every RoleInfo object. Registration of new roles
+ * is serialized by a mutex.
+ */
+class RoleRegistry
+{
+public:
+    typedef uint32_t Id;
+
+    static RoleRegistry& getInstance();
+
+    ~RoleRegistry();
+
+    /**
+     * Get the id of a role, the role is registered if it is not known yet
+     */
+    Id getId(const Role& role);
+
+    /**
+     * Get the id of a role without registering it
+     * \return true if the role is known, false otherwise
+     */
+    bool findId(const Role& role, Id& id) const;
+
+    /**
+     * Get the role for an id
+     * \throw std::out_of_range if the id is not known
+     */
+    const Role& getRole(Id id) const;
+
+    /**
+     * Number of registered roles
+     */
+    size_t size() const;
+
+private:
+    RoleRegistry();
+    RoleRegistry(const RoleRegistry&);
+    RoleRegistry& operator=(const RoleRegistry&);
+
+    struct RoleHash
+    {
+        size_t operator()(const Role& role) const;
+    };
+
+    /**
+     * Hash table with open addressing, which maps the hash of a role to
+     * its id. A slot stores the id + 1, 0 marks an empty slot.
+     * Slots are only written while holding the mutex, and a full table is
+     * replaced by a larger copy instead of being resized.
+     */
+    struct Table
+    {
+        Table(size_t capacity);
+
+        size_t capacity;
+        std::unique_ptr< std::atomic<Id>[] > slots;
+    };
+
+    /// Size of the first chunk of role pointers (as power of two)
+    static const size_t FIRST_CHUNK_BITS = 6;
+    /// Number of chunks to cover all ids, chunk k has the size
+    /// 2^(FIRST_CHUNK_BITS + k)
+    static const size_t MAX_CHUNKS = 27;
+    static const size_t MIN_TABLE_CAPACITY = 64;
+
+    /**
+     * Get the chunk of a role pointer
+     * \param index Index of the role pointer
+     * \param offset Will be set to the offset of the pointer in the chunk
+     * \return chunk index
+     */
+    static size_t getChunk(size_t index, size_t& offset);
+
+    /**
+     * Get the role for an id, which has to be smaller than the published
+     * size
+     */
+    const Role& at(Id id) const;
+
+    /**
+     * Insert an id into the given table
+     */
+    void insert(Table& table, Id id) const;
+
+    /// Serializes registration
+    std::mutex mMutex;
+    /// Roles by id, a deque keeps references valid when growing
+    std::deque<Role> mRoles;
+    /// Pointers to the roles by id, which are split into chunks so that
+    /// they never have to be moved
+    const Role** mChunks[MAX_CHUNKS];
+    /// Number of roles which are accessible for lookups
+    std::atomic<size_t> mSize;
+    /// Current hash table
+    std::atomic<Table*> mTable;
+    /// All tables, replaced tables are kept since lookups might still use
+    /// them
+    std::vector< std::unique_ptr<Table> > mTables;
+};
+
+} // end namespace templ
+#endif // TEMPL_ROLE_REGISTRY_HPP
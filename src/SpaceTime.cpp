@@ -134,7 +134,7 @@ SpaceTime::Network::tuple_t::Ptr SpaceTime::getHorizonEndTuple()
 void SpaceTime::injectVirtualStartAndEnd(SpaceTime::Network& network)
 {
     using namespace graph_analysis;
-    const BaseGraph::Ptr& graph = network.getGraph();
+    const BaseGraph::Ptr& graph = network.getMutableGraph();
     VertexIterator::Ptr vertexIt = graph->getVertexIterator();
     while(vertexIt->next())
     {
@@ -10,13 +10,9 @@ SpaceTimeNetwork::SpaceTimeNetwork(const SpaceTimeNetwork& other)
     : mValues(other.mValues)
     , mTimepoints(other.mTimepoints)
     , mpLocalTransitionEdge(other.mpLocalTransitionEdge)
-    , mTupleMap(other.mTupleMap)
-{
-    if(other.mpGraph)
-    {
-        mpGraph = other.mpGraph->copy();
-    }
-}
+    , mpGraph(other.mpGraph)
+    , mTupleIndex(other.mTupleIndex)
+{}
 
 /**
  * Constructor for a temporally expanded network from a set of values and
@@ -65,19 +61,22 @@ SpaceTimeNetwork::~SpaceTimeNetwork()
 void SpaceTimeNetwork::initialize()
 {
     mpGraph = graph_analysis::BaseGraph::getInstance();
+    initializeTupleIndex();
+    TupleIndex& tupleIndex = mTupleIndex.write();
+    size_t numberOfValues = mValues.size();
 
-    typename ValueList::const_iterator lit = mValues.begin();
-    for(; lit != mValues.end(); ++lit)
+    for(size_t valueIdx = 0; valueIdx < numberOfValues; ++valueIdx)
     {
+        const value_t& value = mValues[valueIdx];
         typename tuple_t::Ptr previousTuple;
 
-        typename TimePointList::const_iterator tit = mTimepoints.begin();
-        for(; tit != mTimepoints.end(); ++tit)
+        for(size_t timepointIdx = 0; timepointIdx < mTimepoints.size(); ++timepointIdx)
         {
-            typename tuple_t::Ptr currentTuple(new tuple_t(*lit, *tit));
+            const timepoint_t& timepoint = mTimepoints[timepointIdx];
+            typename tuple_t::Ptr currentTuple(new tuple_t(value, timepoint));
             mpGraph->addVertex(currentTuple);
 
-            mTupleMap[ ValueTimePair(*lit, *tit) ] = currentTuple;
+            tupleIndex.tuples[timepointIdx*numberOfValues + valueIdx] = currentTuple;
 
             if(previousTuple)
             {
@@ -99,19 +98,113 @@ void SpaceTimeNetwork::initialize()
  */
 void SpaceTimeNetwork::reconstructTupleMap()
 {
+    initializeTupleIndex();
     graph_analysis::VertexIterator::Ptr vertexIt = mpGraph->getVertexIterator();
     while(vertexIt->next())
     {
         typename tuple_t::Ptr currentTuple = dynamic_pointer_cast<tuple_t>( vertexIt->current() );
-        mTupleMap[ ValueTimePair(currentTuple->first(), currentTuple->second()) ] = currentTuple;
+        addTuple(currentTuple->first(), currentTuple->second(), currentTuple);
+    }
+}
+
+void SpaceTimeNetwork::initializeTupleIndex()
+{
+    TupleIndex tupleIndex;
+    for(size_t i = 0; i < mValues.size(); ++i)
+    {
+        tupleIndex.valueIndices.insert(std::make_pair(mValues[i], i));
+    }
+    for(size_t i = 0; i < mTimepoints.size(); ++i)
+    {
+        tupleIndex.timepointIndices.insert(std::make_pair(mTimepoints[i], i));
     }
+    tupleIndex.tuples.resize(mValues.size()*mTimepoints.size());
+    mTupleIndex = std::move(tupleIndex);
 }
 
 void SpaceTimeNetwork::addTuple(const value_t& value,
         const timepoint_t& timepoint,
         const typename tuple_t::Ptr& tuple)
 {
-    mTupleMap[ ValueTimePair(value, timepoint) ] = tuple;
+    size_t valueIdx;
+    size_t timepointIdx;
+    if(getValueIndex(value, valueIdx) && getTimepointIndex(timepoint, timepointIdx))
+    {
+        mTupleIndex.write().tuples[timepointIdx*mValues.size() + valueIdx] = tuple;
+    } else {
+        mTupleIndex.write().otherTuples[ ValueTimePair(value, timepoint) ] = tuple;
+    }
+}
+
+bool SpaceTimeNetwork::getValueIndex(const value_t& value, size_t& valueIdx) const
+{
+    std::unordered_map<value_t, size_t>::const_iterator cit = mTupleIndex->valueIndices.find(value);
+    if(cit != mTupleIndex->valueIndices.end())
+    {
+        valueIdx = cit->second;
+        return true;
+    }
+    return false;
+}
+
+bool SpaceTimeNetwork::getTimepointIndex(const timepoint_t& timepoint, size_t& timepointIdx) const
+{
+    std::unordered_map<timepoint_t, size_t>::const_iterator cit = mTupleIndex->timepointIndices.find(timepoint);
+    if(cit != mTupleIndex->timepointIndices.end())
+    {
+        timepointIdx = cit->second;
+        return true;
+    }
+    return false;
+}
+
+typename SpaceTimeNetwork::tuple_t::Ptr SpaceTimeNetwork::tryTupleByIndex(size_t valueIdx, size_t timepointIdx) const
+{
+    if(valueIdx >= mValues.size() || timepointIdx >= mTimepoints.size())
+    {
+        return typename tuple_t::Ptr();
+    }
+    return mTupleIndex->tuples[timepointIdx*mValues.size() + valueIdx];
+}
+
+typename SpaceTimeNetwork::tuple_t::Ptr SpaceTimeNetwork::tryTupleByKeys(const value_t& value, const timepoint_t& timepoint) const
+{
+    size_t valueIdx;
+    size_t timepointIdx;
+    if(getValueIndex(value, valueIdx) && getTimepointIndex(timepoint, timepointIdx))
+    {
+        return mTupleIndex->tuples[timepointIdx*mValues.size() + valueIdx];
+    }
+
+    typename TupleMap::const_iterator cit = mTupleIndex->otherTuples.find( ValueTimePair(value,timepoint) );
+    if(cit != mTupleIndex->otherTuples.end())
+    {
+        return cit->second;
+    }
+    return typename tuple_t::Ptr();
+}
+
+typename SpaceTimeNetwork::tuple_t::PtrList::const_iterator SpaceTimeNetwork::layerBegin(size_t timepointIdx) const
+{
+    if(timepointIdx >= mTimepoints.size())
+    {
+        throw std::out_of_range("templ::SpaceTimeNetwork::layerBegin: timepoint index out of range");
+    }
+    return mTupleIndex->tuples.begin() + timepointIdx*mValues.size();
+}
+
+typename SpaceTimeNetwork::tuple_t::PtrList::const_iterator SpaceTimeNetwork::layerEnd(size_t timepointIdx) const
+{
+    return layerBegin(timepointIdx) + mValues.size();
+}
+
+const graph_analysis::BaseGraph::Ptr& SpaceTimeNetwork::getMutableGraph()
+{
+    if(isGraphShared())
+    {
+        mpGraph = mpGraph->copy();
+    }
+    return mpGraph;
 }
 
 /**
@@ -122,10 +215,10 @@ void SpaceTimeNetwork::addTuple(const value_t& value,
  */
 typename SpaceTimeNetwork::tuple_t::Ptr SpaceTimeNetwork::tupleByKeys(const value_t& value, const timepoint_t& timepoint) const
 {
-    typename TupleMap::const_iterator cit = mTupleMap.find( ValueTimePair(value,timepoint) );
-    if(cit != mTupleMap.end())
+    typename tuple_t::Ptr tuple = tryTupleByKeys(value, timepoint);
+    if(tuple)
     {
-        return cit->second;
+        return tuple;
     }
 
     throw std::invalid_argument("SpaceTimeNetwork::tupleByKeys: key does not exist");
@@ -229,27 +322,47 @@ SpaceTimeNetwork SpaceTimeNetwork::fromGraph(const graph_analysis::BaseGraph::Pt
     return network;
 }
 
-const SpaceTimeNetwork::ValueTimePair& SpaceTimeNetwork::getValueTimePair(const typename tuple_t::Ptr& searchTuple) const
+SpaceTimeNetwork::ValueTimePair SpaceTimeNetwork::getValueTimePair(const typename tuple_t::Ptr& searchTuple) const
 {
-    typename TupleMap::const_iterator cit = mTupleMap.begin();
-    for(; cit != mTupleMap.end(); ++cit)
+    if(searchTuple)
     {
-        const ValueTimePair& valueTimePair = cit->first;
-        typename tuple_t::Ptr tuple = cit->second;
-        if(tuple ==  searchTuple)
+        // Tuples are usually stored with their own value and timepoint as key
+        size_t valueIdx;
+        size_t timepointIdx;
+        if(getValueIndex(searchTuple->first(), valueIdx)
+                && getTimepointIndex(searchTuple->second(), timepointIdx)
+                && tryTupleByIndex(valueIdx, timepointIdx) == searchTuple)
+        {
+            return ValueTimePair(mValues[valueIdx], mTimepoints[timepointIdx]);
+        }
+
+        const TupleIndex& tupleIndex = *mTupleIndex;
+        for(size_t i = 0; i < tupleIndex.tuples.size(); ++i)
         {
-            return valueTimePair;
+            if(tupleIndex.tuples[i] == searchTuple)
+            {
+                return ValueTimePair(mValues[i % mValues.size()], mTimepoints[i / mValues.size()]);
+            }
+        }
+
+        typename TupleMap::const_iterator cit = tupleIndex.otherTuples.begin();
+        for(; cit != tupleIndex.otherTuples.end(); ++cit)
+        {
+            if(cit->second == searchTuple)
+            {
+                return cit->first;
+            }
         }
     }
     throw std::invalid_argument("templ::SpaceTimeNetwork::getValueTimePair: could not find provided tuple in network");
 }
 
-const SpaceTimeNetwork::value_t& SpaceTimeNetwork::getValue(const typename tuple_t::Ptr& tuple) const
+SpaceTimeNetwork::value_t SpaceTimeNetwork::getValue(const typename tuple_t::Ptr& tuple) const
 {
     return getValueTimePair(tuple).first;
 }
 
-const SpaceTimeNetwork::timepoint_t& SpaceTimeNetwork::getTimepoint(const typename tuple_t::Ptr& tuple) const
+SpaceTimeNetwork::timepoint_t SpaceTimeNetwork::getTimepoint(const typename tuple_t::Ptr& tuple) const
 {
     return getValueTimePair(tuple).second;
 }
@@ -257,25 +370,23 @@ const SpaceTimeNetwork::timepoint_t& SpaceTimeNetwork::getTimepoint(const typena
 size_t SpaceTimeNetwork::getColumn(const graph_analysis::Vertex::Ptr& vertex) const
 {
     typename tuple_t::Ptr tuple = dynamic_pointer_cast<tuple_t>(vertex);
-    const value_t& value = getValue(tuple);
-
-    typename ValueList::const_iterator cit = std::find_if(mValues.begin(), mValues.end(), [value](const value_t& other)
-            {
-                return value == other;
-            });
-    return std::distance(mValues.begin(), cit);
+    size_t valueIdx;
+    if(getValueIndex(getValue(tuple), valueIdx))
+    {
+        return valueIdx;
+    }
+    return mValues.size();
 }
 
 size_t SpaceTimeNetwork::getRow(const graph_analysis::Vertex::Ptr& vertex) const
 {
     typename tuple_t::Ptr tuple = dynamic_pointer_cast<tuple_t>(vertex);
-    const timepoint_t& timepoint = getTimepoint(tuple);
-
-    typename TimePointList::const_iterator cit = std::find_if(mTimepoints.begin(), mTimepoints.end(), [timepoint](const timepoint_t& other)
-            {
-                return timepoint == other;
-            });
-    return std::distance(mTimepoints.begin(), cit);
+    size_t timepointIdx;
+    if(getTimepointIndex(getTimepoint(tuple), timepointIdx))
+    {
+        return timepointIdx;
+    }
+    return mTimepoints.size();
 }
 
 /**
@@ -326,12 +437,11 @@ SpaceTimeNetwork::TuplePtrList SpaceTimeNetwork::getTuples(const timepoint_t& t_
     TimePointList timepoints = getTimepoints(t_start, t_end);
     for(const timepoint_t& t : timepoints)
     {
-        try {
-            tuples.push_back( tupleByKeys(value,t) );
-        } catch(const std::exception& e)
+        // only the relevant and ones available are considered
+        typename tuple_t::Ptr tuple = tryTupleByKeys(value,t);
+        if(tuple)
         {
-            // only the relevant and ones available are considered
-            LOG_DEBUG_S << "Query with unregistered key: " << e.what();
+            tuples.push_back(tuple);
         }
     }
     return tuples;
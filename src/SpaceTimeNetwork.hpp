@@ -5,6 +5,7 @@
 #include <vector>
 #include <stdexcept>
 #include <algorithm>
+#include <unordered_map>
 #include <graph_analysis/BaseGraph.hpp>
 #include <graph_analysis/GraphIO.hpp>
 #include <graph_analysis/io/GraphvizWriter.hpp>
@@ -17,6 +18,7 @@
 #include "solvers/temporal/QualitativeTemporalConstraintNetwork.hpp"
 #include "solvers/csp/TemporalConstraintNetwork.hpp"
 #include "Tuple.hpp"
+#include "utils/CopyOnWrite.hpp"
 
 #include "RoleInfoTuple.hpp"
 #include "RoleInfoWeightedEdge.hpp"
@@ -46,10 +48,38 @@ protected:
     /// map allows to resolve from key-value --> tuple Ptr
     typedef std::map< ValueTimePair, typename tuple_t::Ptr > TupleMap;
     typedef typename tuple_t::PtrList TuplePtrList;
-    TupleMap mTupleMap;
+
+    /**
+     * Dense storage of the tuples
+     * Tuples are stored by timepoint layer, i.e. at index
+     * timepointIdx*|values| + valueIdx, so that the tuples of one timepoint are
+     * contiguous
+     */
+    struct TupleIndex
+    {
+        std::unordered_map<value_t, size_t> valueIndices;
+        std::unordered_map<timepoint_t, size_t> timepointIndices;
+        TuplePtrList tuples;
+        /// Tuples whose value or timepoint is not part of the network's lists
+        TupleMap otherTuples;
+    };
+    utils::CopyOnWrite<TupleIndex> mTupleIndex;
+
+    /**
+     * (Re)create the dense tuple storage for the current values and
+     * timepoints, all entries are NULL afterwards
+     */
+    void initializeTupleIndex();
 
 public:
     SpaceTimeNetwork();
+
+    /**
+     * Copy a network
+     * The copy shares the graph and the tuple storage with the original until
+     * one of them is modified, see getMutableGraph(). Vertices and edges are
+     * always shared between copies.
+     */
     SpaceTimeNetwork(const SpaceTimeNetwork& other);
 
     /**
@@ -87,8 +117,25 @@ public:
      */
     void reconstructTupleMap();
 
+    /**
+     * Get the graph for read access
+     * The graph might be shared with copies of this network, so use
+     * getMutableGraph() to add or remove vertices or edges
+     */
     const graph_analysis::BaseGraph::Ptr& getGraph() const { return mpGraph; }
 
+    /**
+     * Get the graph to add or remove vertices or edges
+     * The graph is copied first, if it is shared with another network
+     */
+    const graph_analysis::BaseGraph::Ptr& getMutableGraph();
+
+    /**
+     * Check whether the graph is shared with another network (or other
+     * owners)
+     */
+    bool isGraphShared() const { return mpGraph.use_count() > 1; }
+
     /**
      * Return the list of values, e.g. for the SpaceTime::Network that will mean
      * the locations
@@ -110,9 +157,43 @@ public:
      * \param value
      * \param timepoint
      * \return tuple
+     * \throw std::invalid_argument if the key does not exist
      */
     typename tuple_t::Ptr tupleByKeys(const value_t& value, const timepoint_t& timepoint) const;
 
+    /**
+     * Retrieve a tuple by the given key tuple
+     * \return tuple, or NULL if the key does not exist
+     */
+    typename tuple_t::Ptr tryTupleByKeys(const value_t& value, const timepoint_t& timepoint) const;
+
+    /**
+     * Retrieve a tuple by the index of the value in getValues() and the index
+     * of the timepoint in getTimepoints()
+     * \return tuple, or NULL if the indices are out of range
+     */
+    typename tuple_t::Ptr tryTupleByIndex(size_t valueIdx, size_t timepointIdx) const;
+
+    /**
+     * Get the index of a value in getValues()
+     * \return true if the value is known, false otherwise
+     */
+    bool getValueIndex(const value_t& value, size_t& valueIdx) const;
+
+    /**
+     * Get the index of a timepoint in getTimepoints()
+     * \return true if the timepoint is known, false otherwise
+     */
+    bool getTimepointIndex(const timepoint_t& timepoint, size_t& timepointIdx) const;
+
+    /**
+     * Get the tuples of all values for a given timepoint (index), ordered as
+     * getValues()
+     * \return iterator to the first tuple of the layer
+     */
+    typename tuple_t::PtrList::const_iterator layerBegin(size_t timepointIdx) const;
+    typename tuple_t::PtrList::const_iterator layerEnd(size_t timepointIdx) const;
+
     void save(const std::string& filename, const std::string& type = "") const;
 
     static SpaceTimeNetwork fromFile(const std::string& filename,
@@ -123,10 +204,10 @@ public:
 
     static SpaceTimeNetwork fromGraph(const graph_analysis::BaseGraph::Ptr& graph, const std::vector<value_t>& values, const std::vector<timepoint_t>& timepoints);
 
-    const ValueTimePair& getValueTimePair(const typename tuple_t::Ptr& searchTuple) const;
+    ValueTimePair getValueTimePair(const typename tuple_t::Ptr& searchTuple) const;
 
-    const SpaceTimeNetwork::value_t& getValue(const typename tuple_t::Ptr& tuple) const;
-    const SpaceTimeNetwork::timepoint_t& getTimepoint(const typename tuple_t::Ptr& tuple) const;
+    SpaceTimeNetwork::value_t getValue(const typename tuple_t::Ptr& tuple) const;
+    SpaceTimeNetwork::timepoint_t getTimepoint(const typename tuple_t::Ptr& tuple) const;
 
     size_t getColumn(const graph_analysis::Vertex::Ptr& vertex) const;
 
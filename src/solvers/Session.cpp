@@ -4,11 +4,90 @@ namespace templ {
 namespace solvers {
 
 Session::Session()
+    : mFinished(false)
+    , mStopRequested(false)
 {}
 
 Session::Session(const Mission::Ptr& mission)
     : mpMission(mission)
+    , mFinished(false)
+    , mStopRequested(false)
 {}
 
+void Session::setSolutions(const Solution::List& solutions)
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSolutions = solutions;
+    }
+    mSolutionAdded.notify_all();
+}
+
+Solution::List Session::getSolutions() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mSolutions;
+}
+
+void Session::setSolutionCallback(const SolutionCallback& callback)
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    mSolutionCallback = callback;
+}
+
+bool Session::addSolution(const Solution& solution)
+{
+    SolutionCallback callback;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mSolutions.push_back(solution);
+        callback = mSolutionCallback;
+    }
+    mSolutionAdded.notify_all();
+
+    // call without holding the lock, so that the callback can access the
+    // session
+    if(callback && !callback(solution))
+    {
+        requestStop();
+    }
+    return !mStopRequested;
+}
+
+bool Session::waitForSolution(size_t index, Solution& solution) const
+{
+    std::unique_lock<std::mutex> lock(mMutex);
+    mSolutionAdded.wait(lock, [this, index]()
+            {
+                return index < mSolutions.size() || mFinished;
+            });
+    if(index < mSolutions.size())
+    {
+        solution = mSolutions[index];
+        return true;
+    }
+    return false;
+}
+
+void Session::requestStop()
+{
+    mStopRequested = true;
+}
+
+void Session::setFinished()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mFinished = true;
+    }
+    mSolutionAdded.notify_all();
+}
+
+bool Session::isFinished() const
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mFinished;
+}
+
 } // end namespace solvers
 } // end namespace templ
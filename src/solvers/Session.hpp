@@ -1,26 +1,98 @@
 #ifndef TEMPL_SOLVERS_SESSION_HPP
 #define TEMPL_SOLVERS_SESSION_HPP
 
+#include <mutex>
+#include <functional>
+#include <atomic>
+#include <condition_variable>
 #include "../Mission.hpp"
 #include "Solution.hpp"
 
 namespace templ {
 namespace solvers {
 
+/**
+ * A solver session, which collects the solutions of a solver run
+ *
+ * Solutions are delivered as soon as the solver finds them, either via a
+ * callback or by pulling them with waitForSolution, e.g., while the solver
+ * runs in a separate thread:
+ * \verbatim
+ Session::Ptr session = make_shared<Session>(mission);
+ std::thread worker([&]() { solver->run(session, 0, configuration); });
+
+ Solution solution;
+ for(size_t i = 0; session->waitForSolution(i, solution); ++i)
+ {
+     if(goodEnough(solution))
+     {
+         session->requestStop();
+     }
+ }
+ worker.join();
+ \endverbatim
+ */
 class Session
 {
 public:
     typedef shared_ptr<Session> Ptr;
 
+    /**
+     * Callback for each solution, return false to stop the solver
+     */
+    typedef std::function<bool (const Solution&)> SolutionCallback;
+
     Session();
     Session(const Mission::Ptr& mission);
 
-    void setSolutions(const Solution::List& solutions) { mSolutions = solutions; }
-    const Solution::List& getSolutions() const { return mSolutions; }
+    const Mission::Ptr& getMission() const { return mpMission; }
+
+    void setSolutions(const Solution::List& solutions);
+    Solution::List getSolutions() const;
+
+    /**
+     * Set the callback, which is called from the solver thread for each
+     * solution
+     */
+    void setSolutionCallback(const SolutionCallback& callback);
+
+    /**
+     * Add a solution, notify waiting consumers and call the solution
+     * callback
+     * \return false if the solver should stop
+     */
+    bool addSolution(const Solution& solution);
+
+    /**
+     * Get the solution at the given index, blocking until it is available
+     * \return false if the session finished before the solution became
+     * available
+     */
+    bool waitForSolution(size_t index, Solution& solution) const;
+
+    /**
+     * Request the solver to stop as soon as possible
+     */
+    void requestStop();
+
+    bool isStopRequested() const { return mStopRequested; }
+
+    /**
+     * Mark the session as finished, i.e., no further solutions will be added
+     */
+    void setFinished();
+
+    bool isFinished() const;
 
 private:
     Mission::Ptr mpMission;
+
+    mutable std::mutex mMutex;
+    mutable std::condition_variable mSolutionAdded;
     Solution::List mSolutions;
+    SolutionCallback mSolutionCallback;
+    bool mFinished;
+    std::atomic<bool> mStopRequested;
 };
 
 } // end namespace solvers
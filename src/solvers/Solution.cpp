@@ -117,11 +117,11 @@ SpaceTime::RoleInfoSpaceTimeTuple::Ptr Solution::removeRole(const Role& role,
             {
                 e->removeRole(role, tag);
 
-                if(e->getRoles(RoleInfo::ASSIGNED).empty())
+                if(e->getRoleIds(RoleInfo::ASSIGNED).none())
                 {
                     if( e->getWeight() != std::numeric_limits<double>::max() )
                     {
-                        mSpaceTimeNetwork.getGraph()->removeEdge(e);
+                        mSpaceTimeNetwork.getMutableGraph()->removeEdge(e);
                     }
                 }
                 break;
@@ -138,11 +138,11 @@ SpaceTime::RoleInfoSpaceTimeTuple::Ptr Solution::removeRole(const Role& role,
             {
                 e->removeRole(role, tag);
 
-                if(e->getAllRoles().empty())
+                if(e->getAllRoleIds().none())
                 {
                     if( e->getWeight() != std::numeric_limits<double>::max() )
                     {
-                        mSpaceTimeNetwork.getGraph()->removeEdge(e);
+                        mSpaceTimeNetwork.getMutableGraph()->removeEdge(e);
                     }
                 }
                 break;
@@ -239,7 +239,7 @@ SpaceTime::RoleInfoSpaceTimeTuple::Ptr Solution::addRole(const Role& role,
             if(edges.empty())
             {
                 edge = make_shared<RoleInfoWeightedEdge>(prevTuple, roleInfoTuple, 0);
-                mSpaceTimeNetwork.getGraph()->addEdge(edge);
+                mSpaceTimeNetwork.getMutableGraph()->addEdge(edge);
             } else if(edges.size() == 1)
             {
                 edge = edges[0];
@@ -290,7 +290,7 @@ SpaceTime::RoleInfoSpaceTimeTuple::Ptr Solution::addRole(const Role& role,
                         {
                             // create edge
                             RoleInfoWeightedEdge::Ptr edge = make_shared<RoleInfoWeightedEdge>(prevTuple, roleInfoTuple, 0);
-                            mSpaceTimeNetwork.getGraph()->addEdge(edge);
+                            mSpaceTimeNetwork.getMutableGraph()->addEdge(edge);
                             edge->addRole(role, tag);
                         } else {
                             throw
@@ -38,9 +38,18 @@ public:
     void setSpaceTimeNetwork(const SpaceTime::Network& network) { mSpaceTimeNetwork = network; }
 
     /**
-     * return the underlying graph of the space time network
+     * Return the underlying graph of the space time network for read access
+     * The graph might be shared with copies of this solution, so use
+     * getMutableGraph() to add or remove vertices or edges
      */
-    graph_analysis::BaseGraph::Ptr getGraph() { return mSpaceTimeNetwork.getGraph(); }
+    const graph_analysis::BaseGraph::Ptr& getGraph() const { return mSpaceTimeNetwork.getGraph(); }
+
+    /**
+     * Return the underlying graph of the space time network to add or remove
+     * vertices or edges
+     * The graph is copied first, if it is shared with another network
+     */
+    const graph_analysis::BaseGraph::Ptr& getMutableGraph() { return mSpaceTimeNetwork.getMutableGraph(); }
 
     /**
      * Get list of temporally ordered timepoints
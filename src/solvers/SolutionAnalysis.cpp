@@ -2,6 +2,7 @@
 #include "../RoleInfoVertex.hpp"
 #include "../RoleInfoTuple.hpp"
 #include "../utils/PathConstructor.hpp"
+#include "../utils/PhaseTimer.hpp"
 #include "Cost.hpp"
 
 #include <fstream>
@@ -24,6 +25,7 @@ SolutionAnalysis::SolutionAnalysis()
     , mSigma(1.0)
     , mCost(0.0)
     , mTimeHorizonInS(0)
+    , mTimeConsistent(true)
     , mSafety(0.0)
     , mEfficacy(0.0)
     , mTraveledDistance(0)
@@ -44,6 +46,7 @@ SolutionAnalysis::SolutionAnalysis(const Mission::Ptr& mission,
     , mSigma(1.0)
     , mCost(0.0)
     , mTimeHorizonInS(0)
+    , mTimeConsistent(true)
     , mSafety(0.0)
     , mEfficacy(0.0)
     , mTraveledDistance(0)
@@ -74,6 +77,7 @@ SolutionAnalysis::SolutionAnalysis(const Mission::Ptr& mission,
     , mSigma(1.0)
     , mCost(0.0)
     , mTimeHorizonInS(0)
+    , mTimeConsistent(true)
     , mSafety(0.0)
     , mEfficacy(0.0)
     , mTraveledDistance(0)
@@ -299,30 +303,41 @@ std::vector<moreorg::ModelPool> SolutionAnalysis::getAvailableResources(const sy
 
     // Iterate over all known timepoints and check if the timepoint belongs to
     // the interval (the list of timepoints is sorted)
-    TimePoint::PtrList timepoints = mSolutionNetwork.getTimepoints();
+    const TimePoint::PtrList& timepoints = mSolutionNetwork.getTimepoints();
 
     assert(!timepoints.empty());
 
     Role::Set identifiedRoles;
 
-    for(TimePoint::Ptr timepoint : timepoints)
+    size_t locationIdx;
+    if(!mSolutionNetwork.getValueIndex(location, locationIdx))
     {
+        LOG_WARN_S << "templ::solvers::SolutionAnalysis::getAvailableResources: location '"
+            << location->toString() << "' is not part of the solution network";
+        return modelPools;
+    }
+
+    for(size_t timepointIdx = 0; timepointIdx < timepoints.size(); ++timepointIdx)
+    {
+        const TimePoint::Ptr& timepoint = timepoints[timepointIdx];
         if( mTimepointComparator.inInterval(timepoint, interval.getFrom(), interval.getTo()) )
         {
             // identified relevant tuple
-            try {
-                SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tupleByKeys(location, timepoint);
-                Role::Set foundRoles = tuple->getRoles(RoleInfo::ASSIGNED);
-                Role::List roles(foundRoles.begin(), foundRoles.end());
-
-                identifiedRoles.insert(foundRoles.begin(), foundRoles.end());
-
-                moreorg::ModelPool currentPool = Role::getModelPool(roles);
-                modelPools.push_back(currentPool);
-            } catch(const std::exception& e)
+            SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tryTupleByIndex(locationIdx, timepointIdx);
+            if(!tuple)
             {
-                LOG_WARN_S << e.what();
+                LOG_WARN_S << "templ::solvers::SolutionAnalysis::getAvailableResources: no tuple for location '"
+                    << location->toString() << "' and timepoint '" << timepoint->toString() << "'";
+                continue;
             }
+
+            Role::Set foundRoles = tuple->getRoles(RoleInfo::ASSIGNED);
+            Role::List roles(foundRoles.begin(), foundRoles.end());
+
+            identifiedRoles.insert(foundRoles.begin(), foundRoles.end());
+
+            moreorg::ModelPool currentPool = Role::getModelPool(roles);
+            modelPools.push_back(currentPool);
         }
     }
 
@@ -348,14 +363,15 @@ moreorg::ModelPool SolutionAnalysis::getAvailableResources(const symbols::consta
 {
     ModelPool modelPool;
     // identified relevant tuple
-    try {
-        SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tupleByKeys(location, timepoint);
+    SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tryTupleByKeys(location, timepoint);
+    if(tuple)
+    {
         Role::Set foundRoles = tuple->getRoles(RoleInfo::ASSIGNED);
         Role::List roles(foundRoles.begin(), foundRoles.end());
         modelPool = Role::getModelPool(roles);
-    } catch(const std::exception& e)
-    {
-        LOG_WARN_S << e.what();
+    } else {
+        LOG_WARN_S << "templ::solvers::SolutionAnalysis::getAvailableResources: no tuple for location '"
+            << location->toString() << "' and timepoint '" << timepoint->toString() << "'";
     }
     return modelPool;
 }
@@ -430,6 +446,8 @@ void SolutionAnalysis::propagateTemporalConstraints()
 
 void SolutionAnalysis::analyse()
 {
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::SOLUTION_ANALYSIS);
+
     propagateTemporalConstraints();
 
     mTimepoints = mSolutionNetwork.getTimepoints();
@@ -820,11 +838,31 @@ void SolutionAnalysis::quantifyTime()
         }
     }
 
-    tcn.stpWithConjunctiveIntervals();
-    tcn.stp();
-    tcn.minNetwork();
+    // The solution network is ordered by time, so that the earliest times
+    // follow from a longest path computation - only fall back to the
+    // minimal network otherwise
+    mTimeConsistent = true;
+    if(!tcn.getEarliestAssignment(mTimeAssignment))
+    {
+        if(tcn.getEarliestAssignment(mTimeAssignment, true))
+        {
+            // The solution can be executed in the given order, but the
+            // travel times exceed the upper bounds of the mission
+            LOG_WARN_S << "Travel times violate the temporal constraints of the mission -- using the earliest times without upper bounds";
+            mTimeConsistent = false;
+        } else {
+            LOG_DEBUG_S << "Could not compute earliest assignment directly -- falling back to minimal network";
+            tcn.stpWithConjunctiveIntervals();
+            tcn.stp();
+            if(!tcn.minNetwork())
+            {
+                LOG_WARN_S << "Temporal network of the solution is inconsistent -- using the lower bounds of the simple temporal network";
+                mTimeConsistent = false;
+            }
 
-    mTimeAssignment = tcn.getAssignment();
+            mTimeAssignment = tcn.getAssignment();
+        }
+    }
     mTimeHorizonInS = TemporalConstraintNetwork::getTimeHorizon(mTimeAssignment);
     mTraveledDistance = travelDistanceInM;
 }
@@ -924,18 +962,18 @@ Plan SolutionAnalysis::computePlan() const
         // Find the start point of a role
         for(const Location::Ptr& location : locations)
         {
-            try {
-                SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tupleByKeys(location, startingTimepoint);
+            SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tryTupleByKeys(location, startingTimepoint);
+            if(!tuple)
+            {
+                LOG_WARN_S << "No tuple for " << location->toString() << " " << startingTimepoint->toString();
+                continue;
+            }
 
-                Role::Set assignedRoles = tuple->getRoles(RoleInfo::ASSIGNED);
-                if( assignedRoles.find(role) != assignedRoles.end())
-                {
-                    startTuple = tuple;
-                    break;
-                }
-            } catch(const std::exception& e)
+            Role::Set assignedRoles = tuple->getRoles(RoleInfo::ASSIGNED);
+            if( assignedRoles.find(role) != assignedRoles.end())
             {
-                LOG_WARN_S << e.what() << " " << location->toString() << " " << startingTimepoint->toString();
+                startTuple = tuple;
+                break;
             }
         }
 
@@ -966,12 +1004,12 @@ Plan SolutionAnalysis::computePlan() const
     for(const FluentTimeResource& ftr : mResourceRequirements)
     {
         const Interval& i = ftr.getInterval();
-        try {
-            SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tupleByKeys(ftr.getLocation(),
-                    i.getFrom());
-            openRequirements.push_back(tuple);
-        } catch(const std::invalid_argument& e)
+        SpaceTime::Network::tuple_t::Ptr tuple = mSolutionNetwork.tryTupleByKeys(ftr.getLocation(),
+                i.getFrom());
+        if(tuple)
         {
+            openRequirements.push_back(tuple);
+        } else {
             LOG_WARN_S << "Failed to retrieve key for: " << ftr.getLocation()->toString() << " and " << i.getFrom()->toString();
         }
     }
@@ -1057,7 +1095,7 @@ void SolutionAnalysis::computeReconfigurationCost()
         {
             throw std::runtime_error("templ::solvers::SolutionAnalysis::computeReconfigurationCost: failed to cast to RoleInfo."
                     " Class of node is " + vertex->getClassName());
-        } else if(!roleInfo->getAllRoles().empty())
+        } else if(roleInfo->getAllRoleIds().any())
         {
             try {
                 reconfigurationCost = computeReconfigurationCost(vertex, mPlan.getGraph());
@@ -1146,6 +1184,10 @@ std::string SolutionAnalysis::toString(size_t indent) const
     ss << hspace << "    Resulting plan:" << std::endl;
     ss << mPlan.toString(indent + 8);
     ss << hspace << "        time horizon: " << mTimeHorizonInS << std::endl;
+    if(!mTimeConsistent)
+    {
+        ss << hspace << "        (violates the temporal constraints of the mission)" << std::endl;
+    }
     for(const temporal::point_algebra::TimePoint::Ptr& tp : mSolutionNetwork.getTimepoints())
     {
 
@@ -72,6 +72,12 @@ public:
     double getTravelledDistance() const { return mTraveledDistance; }
     double getTimeHorizon() const { return mTimeHorizonInS; }
 
+    /**
+     * Check if the time assignment meets the temporal constraints of the
+     * mission, i.e., the travel times do not violate any upper bound
+     */
+    bool isTimeConsistent() const { return mTimeConsistent; }
+
     /**
      * Get the metrics, e.g., redundancy of the fluent time resource
      */
@@ -217,6 +223,10 @@ public:
     /**
      * Provide a quantification on the transition times for this planner
      * this update the Time Distance Graph
+     *
+     * If the travel times violate the temporal constraints of the mission,
+     * the earliest times without upper bounds are used and the analysis is
+     * marked as not time consistent (see isTimeConsistent)
      */
     void quantifyTime();
 
@@ -308,6 +318,8 @@ private:
     double mCost;
     solvers::temporal::TemporalConstraintNetwork::Assignment mTimeAssignment;
     double mTimeHorizonInS;
+    /// False if the time assignment violates the mission's constraints
+    bool mTimeConsistent;
 
     double mQuality;
     double mSafety;
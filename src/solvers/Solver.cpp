@@ -32,6 +32,15 @@ Solver::Ptr Solver::getInstance(SolverType type)
     }
 }
 
+Session::Ptr Solver::run(const Mission::Ptr& mission,
+        uint32_t minNumberOfSolutions,
+        const qxcfg::Configuration& configuration)
+{
+    Session::Ptr session = make_shared<Session>(mission);
+    run(session, minNumberOfSolutions, configuration);
+    return session;
+}
+
 Solution Solver::construct(const Mission::Ptr& mission,
         StoppingCriteria c)
 {
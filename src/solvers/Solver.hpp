@@ -22,7 +22,23 @@ public:
 
     static Solver::Ptr getInstance(SolverType type);
 
+    /**
+     * Run the solver for a mission and return after the solver finished
+     * \return session with all solutions
+     */
     virtual Session::Ptr run(const Mission::Ptr& mission,
+            uint32_t minNumberOfSolutions = 0,
+            const qxcfg::Configuration& configuration = qxcfg::Configuration());
+
+    /**
+     * Run the solver for the mission of the given session
+     *
+     * Each solution is added to the session as soon as it has been found,
+     * so that it can be processed while the solver continues, and the solver
+     * stops as soon as possible when a stop is requested through the session.
+     * The session is marked as finished when this function returns
+     */
+    virtual void run(const Session::Ptr& session,
             uint32_t minNumberOfSolutions = 0,
             const qxcfg::Configuration& configuration = qxcfg::Configuration()) = 0;
 
@@ -33,6 +49,9 @@ protected:
 
     /**
      * Identify a starting solution, e.g., using heuristics
+     *
+     * Implementations have to stop as soon as the given criteria are met;
+     * the default implementation does not search and returns an empty solution
      */
     virtual Solution construct(const Mission::Ptr& mission,
             StoppingCriteria c = StoppingCriteria()
@@ -41,6 +60,9 @@ protected:
     /**
      * Perform local search around a given seed solution
      * and iterate of these solutions
+     *
+     * Implementations have to stop as soon as the given criteria are met;
+     * the default implementation does not search and returns the seed
      */
     virtual Solution nextSolution(const Solution& seedSolution,
             StoppingCriteria c = StoppingCriteria()
@@ -0,0 +1,364 @@
+#include "StoppingCriteria.hpp"
+#include <fstream>
+#include <sstream>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace templ {
+namespace solvers {
+
+namespace {
+
+class WallTime : public StoppingCriteria::Criterion
+{
+public:
+    WallTime(double seconds) : mSeconds(seconds) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.elapsedInS >= mSeconds; }
+    std::string toString() const { std::stringstream ss; ss << "wall time of " << mSeconds << " s"; return ss.str(); }
+private:
+    double mSeconds;
+};
+
+class NodeLimit : public StoppingCriteria::Criterion
+{
+public:
+    NodeLimit(uint64_t nodes) : mNodes(nodes) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.nodes >= mNodes; }
+    std::string toString() const { std::stringstream ss; ss << "node limit of " << mNodes; return ss.str(); }
+private:
+    uint64_t mNodes;
+};
+
+class FailLimit : public StoppingCriteria::Criterion
+{
+public:
+    FailLimit(uint64_t fails) : mFails(fails) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.fails >= mFails; }
+    std::string toString() const { std::stringstream ss; ss << "fail limit of " << mFails; return ss.str(); }
+private:
+    uint64_t mFails;
+};
+
+class Stagnation : public StoppingCriteria::Criterion
+{
+public:
+    Stagnation(double seconds) : mSeconds(seconds) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.secondsSinceImprovement >= mSeconds; }
+    std::string toString() const { std::stringstream ss; ss << "no improvement within " << mSeconds << " s"; return ss.str(); }
+private:
+    double mSeconds;
+};
+
+class TargetCost : public StoppingCriteria::Criterion
+{
+public:
+    TargetCost(double cost) : mCost(cost) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.numberOfSolutions > 0 && p.bestCost <= mCost; }
+    std::string toString() const { std::stringstream ss; ss << "target cost of " << mCost; return ss.str(); }
+private:
+    double mCost;
+};
+
+class TargetFlaws : public StoppingCriteria::Criterion
+{
+public:
+    TargetFlaws(size_t numberOfFlaws) : mNumberOfFlaws(numberOfFlaws) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.numberOfSolutions > 0 && p.bestNumberOfFlaws <= mNumberOfFlaws; }
+    std::string toString() const { std::stringstream ss; ss << "target number of flaws of " << mNumberOfFlaws; return ss.str(); }
+private:
+    size_t mNumberOfFlaws;
+};
+
+class MemoryLimit : public StoppingCriteria::Criterion
+{
+public:
+    MemoryLimit(size_t bytes) : mBytes(bytes) {}
+    bool isMet(const StoppingCriteria::Progress& p) const { return p.memoryUsage >= mBytes; }
+    std::string toString() const { std::stringstream ss; ss << "memory limit of " << mBytes/(1024*1024) << " MB"; return ss.str(); }
+private:
+    size_t mBytes;
+};
+
+class Composite : public StoppingCriteria::Criterion
+{
+public:
+    Composite(const StoppingCriteria::Criterion::PtrList& criteria, bool all)
+        : mCriteria(criteria)
+        , mAll(all)
+    {}
+
+    bool isMet(const StoppingCriteria::Progress& p) const
+    {
+        for(const StoppingCriteria::Criterion::Ptr& criterion : mCriteria)
+        {
+            if(criterion->isMet(p) != mAll)
+            {
+                return !mAll;
+            }
+        }
+        return mAll && !mCriteria.empty();
+    }
+
+    std::string toString() const
+    {
+        std::stringstream ss;
+        ss << (mAll ? "all of [" : "any of [");
+        for(size_t i = 0; i < mCriteria.size(); ++i)
+        {
+            ss << (i == 0 ? " " : ", ") << mCriteria[i]->toString();
+        }
+        ss << " ]";
+        return ss.str();
+    }
+
+private:
+    StoppingCriteria::Criterion::PtrList mCriteria;
+    bool mAll;
+};
+
+} // end anonymous namespace
+
+StoppingCriteria::Progress::Progress()
+    : elapsedInS(0)
+    , secondsSinceImprovement(0)
+    , nodes(0)
+    , fails(0)
+    , numberOfSolutions(0)
+    , bestCost(std::numeric_limits<double>::max())
+    , bestNumberOfFlaws(std::numeric_limits<size_t>::max())
+    , memoryUsage(0)
+{}
+
+std::string StoppingCriteria::Progress::toString(size_t indent) const
+{
+    std::string hspace(indent,' ');
+    std::stringstream ss;
+    ss << hspace << "elapsed: " << elapsedInS << " s" << std::endl;
+    ss << hspace << "since last improvement: " << secondsSinceImprovement << " s" << std::endl;
+    ss << hspace << "nodes: " << nodes << std::endl;
+    ss << hspace << "fails: " << fails << std::endl;
+    ss << hspace << "solutions: " << numberOfSolutions << std::endl;
+    if(numberOfSolutions > 0)
+    {
+        ss << hspace << "best cost: " << bestCost << std::endl;
+        ss << hspace << "best # flaws: " << bestNumberOfFlaws << std::endl;
+    }
+    ss << hspace << "memory: " << memoryUsage/(1024*1024) << " MB" << std::endl;
+    return ss.str();
+}
+
+StoppingCriteria::State::State()
+    : startTime(base::Time::now())
+    , lastImprovement(startTime)
+    , memoryUsage(0)
+    , nodes(0)
+    , fails(0)
+{}
+
+StoppingCriteria::StoppingCriteria()
+    : mpState(make_shared<State>())
+{}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::wallTime(double seconds)
+{
+    return make_shared<WallTime>(seconds);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::nodeLimit(uint64_t nodes)
+{
+    return make_shared<NodeLimit>(nodes);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::failLimit(uint64_t fails)
+{
+    return make_shared<FailLimit>(fails);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::stagnation(double seconds)
+{
+    return make_shared<Stagnation>(seconds);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::targetCost(double cost)
+{
+    return make_shared<TargetCost>(cost);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::targetFlaws(size_t numberOfFlaws)
+{
+    return make_shared<TargetFlaws>(numberOfFlaws);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::memoryLimit(size_t bytes)
+{
+    return make_shared<MemoryLimit>(bytes);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::anyOf(const Criterion::PtrList& criteria)
+{
+    return make_shared<Composite>(criteria, false);
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::allOf(const Criterion::PtrList& criteria)
+{
+    return make_shared<Composite>(criteria, true);
+}
+
+StoppingCriteria StoppingCriteria::fromConfiguration(const qxcfg::Configuration& configuration,
+        const std::string& prefix)
+{
+    StoppingCriteria criteria;
+
+    double wallTimeInS = configuration.getValueAs<double>(prefix + "wall-time-in-s", -1);
+    if(wallTimeInS >= 0)
+    {
+        criteria.add( wallTime(wallTimeInS) );
+    }
+    double nodes = configuration.getValueAs<double>(prefix + "node-limit", -1);
+    if(nodes >= 0)
+    {
+        criteria.add( nodeLimit(static_cast<uint64_t>(nodes)) );
+    }
+    double fails = configuration.getValueAs<double>(prefix + "fail-limit", -1);
+    if(fails >= 0)
+    {
+        criteria.add( failLimit(static_cast<uint64_t>(fails)) );
+    }
+    double stagnationInS = configuration.getValueAs<double>(prefix + "stagnation-in-s", -1);
+    if(stagnationInS >= 0)
+    {
+        criteria.add( stagnation(stagnationInS) );
+    }
+    double cost = configuration.getValueAs<double>(prefix + "target-cost", -1);
+    if(cost >= 0)
+    {
+        criteria.add( targetCost(cost) );
+    }
+    int flaws = configuration.getValueAs<int>(prefix + "target-flaws", -1);
+    if(flaws >= 0)
+    {
+        criteria.add( targetFlaws(static_cast<size_t>(flaws)) );
+    }
+    double memoryInMB = configuration.getValueAs<double>(prefix + "memory-limit-in-mb", -1);
+    if(memoryInMB >= 0)
+    {
+        criteria.add( memoryLimit(static_cast<size_t>(memoryInMB*1024*1024)) );
+    }
+    return criteria;
+}
+
+StoppingCriteria& StoppingCriteria::add(const Criterion::Ptr& criterion)
+{
+    if(!criterion)
+    {
+        throw std::invalid_argument("templ::solvers::StoppingCriteria::add: criterion is null");
+    }
+    mCriteria.push_back(criterion);
+    return *this;
+}
+
+void StoppingCriteria::start()
+{
+    std::lock_guard<std::mutex> lock(mpState->mutex);
+    mpState->startTime = base::Time::now();
+    mpState->lastImprovement = mpState->startTime;
+    mpState->lastMemorySample = base::Time();
+    mpState->memoryUsage = 0;
+    mpState->progress = Progress();
+    mpState->nodes = 0;
+    mpState->fails = 0;
+}
+
+void StoppingCriteria::updateSearchStatistics(uint64_t nodes, uint64_t fails)
+{
+    mpState->nodes.store(nodes, std::memory_order_relaxed);
+    mpState->fails.store(fails, std::memory_order_relaxed);
+}
+
+bool StoppingCriteria::updateSolution(double cost, size_t numberOfFlaws)
+{
+    std::lock_guard<std::mutex> lock(mpState->mutex);
+    Progress& progress = mpState->progress;
+    bool improved = progress.numberOfSolutions == 0 || cost < progress.bestCost;
+    ++progress.numberOfSolutions;
+    if(improved)
+    {
+        progress.bestCost = cost;
+        mpState->lastImprovement = base::Time::now();
+    }
+    if(numberOfFlaws < progress.bestNumberOfFlaws)
+    {
+        progress.bestNumberOfFlaws = numberOfFlaws;
+    }
+    return improved;
+}
+
+StoppingCriteria::Progress StoppingCriteria::getProgress() const
+{
+    std::lock_guard<std::mutex> lock(mpState->mutex);
+    base::Time now = base::Time::now();
+
+    Progress progress = mpState->progress;
+    progress.nodes = mpState->nodes.load(std::memory_order_relaxed);
+    progress.fails = mpState->fails.load(std::memory_order_relaxed);
+    progress.elapsedInS = (now - mpState->startTime).toSeconds();
+    progress.secondsSinceImprovement = (now - mpState->lastImprovement).toSeconds();
+
+    if(mpState->lastMemorySample.isNull() || (now - mpState->lastMemorySample).toSeconds() > 0.1)
+    {
+        mpState->memoryUsage = getMemoryUsage();
+        mpState->lastMemorySample = now;
+    }
+    progress.memoryUsage = mpState->memoryUsage;
+    return progress;
+}
+
+StoppingCriteria::Criterion::Ptr StoppingCriteria::findMet() const
+{
+    if(mCriteria.empty())
+    {
+        return Criterion::Ptr();
+    }
+
+    Progress progress = getProgress();
+    for(const Criterion::Ptr& criterion : mCriteria)
+    {
+        if(criterion->isMet(progress))
+        {
+            return criterion;
+        }
+    }
+    return Criterion::Ptr();
+}
+
+bool StoppingCriteria::isMet() const
+{
+    return static_cast<bool>(findMet());
+}
+
+std::string StoppingCriteria::getReason() const
+{
+    Criterion::Ptr criterion = findMet();
+    if(criterion)
+    {
+        return criterion->toString();
+    }
+    return "";
+}
+
+size_t StoppingCriteria::getMemoryUsage()
+{
+    // second entry: resident set size in pages
+    std::ifstream statm("/proc/self/statm");
+    size_t totalPages = 0;
+    size_t residentPages = 0;
+    if(statm >> totalPages >> residentPages)
+    {
+        return residentPages*static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    }
+    return 0;
+}
+
+} // end namespace solvers
+} // end namespace templ
@@ -1,12 +1,187 @@
 #ifndef TEMPL_SOLVERS_STOPPING_CRITERIA_HPP
 #define TEMPL_SOLVERS_STOPPING_CRITERIA_HPP
 
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <base/Time.hpp>
+#include <qxcfg/Configuration.hpp>
+#include "../SharedPtr.hpp"
+
 namespace templ {
 namespace solvers {
 
+/**
+ * Composable criteria to terminate a solver
+ *
+ * A StoppingCriteria object collects a list of criteria and is met as soon as
+ * any of them is met. The progress of the solver, i.e., search statistics and
+ * the best solution found so far, has to be reported via
+ * updateSearchStatistics and updateSolution.
+ *
+ * Copies share the progress, so that the object can be handed to search
+ * engines and to a solver by value
+ *
+ * \verbatim
+ StoppingCriteria criteria;
+ criteria.add( StoppingCriteria::wallTime(60) )
+         .add( StoppingCriteria::allOf({ StoppingCriteria::targetFlaws(0),
+                                         StoppingCriteria::stagnation(10) }) );
+ \endverbatim
+ */
 class StoppingCriteria
 {
 public:
+    /**
+     * Progress of a solver
+     */
+    struct Progress
+    {
+        Progress();
+
+        /// Time since start()
+        double elapsedInS;
+        /// Time since the last improvement of the cost, or since start() if
+        /// no solution has been found yet
+        double secondsSinceImprovement;
+        uint64_t nodes;
+        uint64_t fails;
+        uint64_t numberOfSolutions;
+        /// Cost of the best solution, only valid if numberOfSolutions > 0
+        double bestCost;
+        /// Number of flaws of the best solution, only valid if numberOfSolutions > 0
+        size_t bestNumberOfFlaws;
+        /// Resident memory of the process in bytes
+        size_t memoryUsage;
+
+        std::string toString(size_t indent = 0) const;
+    };
+
+    /**
+     * A single termination criterion
+     */
+    class Criterion
+    {
+    public:
+        typedef shared_ptr<Criterion> Ptr;
+        typedef std::vector<Ptr> PtrList;
+
+        virtual ~Criterion() {}
+
+        /**
+         * Check whether the criterion is met for the given progress
+         */
+        virtual bool isMet(const Progress& progress) const = 0;
+
+        virtual std::string toString() const = 0;
+    };
+
+    /// Met when the given time has passed since start()
+    static Criterion::Ptr wallTime(double seconds);
+    /// Met when the search explored the given number of nodes
+    static Criterion::Ptr nodeLimit(uint64_t nodes);
+    /// Met when the search encountered the given number of failures
+    static Criterion::Ptr failLimit(uint64_t fails);
+    /// Met when the cost has not improved for the given time
+    static Criterion::Ptr stagnation(double seconds);
+    /// Met when a solution with at most the given cost has been found
+    static Criterion::Ptr targetCost(double cost);
+    /// Met when a solution with at most the given number of flaws has been found
+    static Criterion::Ptr targetFlaws(size_t numberOfFlaws);
+    /// Met when the resident memory of the process exceeds the given number of bytes
+    static Criterion::Ptr memoryLimit(size_t bytes);
+    /// Met when any of the given criteria is met
+    static Criterion::Ptr anyOf(const Criterion::PtrList& criteria);
+    /// Met when all of the given criteria are met
+    static Criterion::Ptr allOf(const Criterion::PtrList& criteria);
+
+    StoppingCriteria();
+
+    /**
+     * Create criteria from the configuration
+     *
+     * Reads wall-time-in-s, node-limit, fail-limit, stagnation-in-s,
+     * target-cost, target-flaws and memory-limit-in-mb; criteria which are
+     * not set (or set to a negative value) are not added
+     */
+    static StoppingCriteria fromConfiguration(const qxcfg::Configuration& configuration,
+            const std::string& prefix = "TransportNetwork/search/options/stopping/");
+
+    /**
+     * Add a criterion
+     */
+    StoppingCriteria& add(const Criterion::Ptr& criterion);
+
+    const Criterion::PtrList& getCriteria() const { return mCriteria; }
+
+    bool empty() const { return mCriteria.empty(); }
+
+    /**
+     * Reset the progress and start the clock
+     */
+    void start();
+
+    /**
+     * Update the search statistics -- this does not lock, so that it can be
+     * called from concurrent search threads
+     * \param nodes Total number of explored nodes
+     * \param fails Total number of failures
+     */
+    void updateSearchStatistics(uint64_t nodes, uint64_t fails);
+
+    /**
+     * Report a solution
+     * \return true if the solution improves the best known cost
+     */
+    bool updateSolution(double cost, size_t numberOfFlaws);
+
+    /**
+     * Get the current progress
+     */
+    Progress getProgress() const;
+
+    /**
+     * Check whether any of the criteria is met
+     */
+    bool isMet() const;
+
+    /**
+     * Get a description of the criterion that has been met, or an empty
+     * string if none has been met
+     */
+    std::string getReason() const;
+
+    /**
+     * Get the resident memory of this process in bytes (0 if it cannot be
+     * determined)
+     */
+    static size_t getMemoryUsage();
+
+private:
+    struct State
+    {
+        State();
+
+        mutable std::mutex mutex;
+        base::Time startTime;
+        base::Time lastImprovement;
+        /// Memory is sampled at a limited rate, since this requires a
+        /// system call
+        mutable base::Time lastMemorySample;
+        mutable size_t memoryUsage;
+        /// Progress apart from the search statistics
+        Progress progress;
+
+        std::atomic<uint64_t> nodes;
+        std::atomic<uint64_t> fails;
+    };
+
+    /// Met criterion or NULL
+    Criterion::Ptr findMet() const;
+
+    Criterion::PtrList mCriteria;
+    shared_ptr<State> mpState;
 };
 
 } // end namespace solvers
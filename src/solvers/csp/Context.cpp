@@ -1,6 +1,8 @@
 #include "Context.hpp"
+#include <limits>
 #include <moreorg/Algebra.hpp>
 #include <moreorg/vocabularies/OM.hpp>
+#include "../transshipment/MinCostFlow.hpp"
 
 namespace templ {
 namespace solvers {
@@ -13,12 +15,59 @@ Context::Context(const templ::Mission::Ptr& mission, const qxcfg::Configuration&
             configuration.getValue("TransportNetwork/search/options/connectivity/interface-type",moreorg::vocabulary::OM::ElectroMechanicalInterface().toString()))
     , mLocations(mission->getLocations())
     , mIntervals(mission->getTimeIntervals())
+    , mRoles(mission->getRoles())
     , mConfiguration(configuration)
     , mNumberOfTimepoints(mission->getUnorderedTimepoints().size())
     , mNumberOfFluents(mLocations.size())
+    , mBestCost(std::numeric_limits<uint32_t>::max())
+    , mNumberOfLPRuns(0)
+    , mLPFlowGraphTimeInUs(0)
+    , mLPProblemAndSolveTimeInUs(0)
+    , mLPModelTimeInUs(0)
+    , mLPSolveTimeInUs(0)
 {
 }
 
+bool Context::updateBestCost(uint32_t cost)
+{
+    uint32_t bestCost = mBestCost.load();
+    while(cost < bestCost)
+    {
+        if(mBestCost.compare_exchange_weak(bestCost, cost))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Context::addLPRun(double flowGraphTimeInS, double problemAndSolveTimeInS,
+        double modelTimeInS, double solveTimeInS)
+{
+    ++mNumberOfLPRuns;
+    mLPFlowGraphTimeInUs += static_cast<uint64_t>(flowGraphTimeInS*1.0E6);
+    mLPProblemAndSolveTimeInUs += static_cast<uint64_t>(problemAndSolveTimeInS*1.0E6);
+    mLPModelTimeInUs += static_cast<uint64_t>(modelTimeInS*1.0E6);
+    mLPSolveTimeInUs += static_cast<uint64_t>(solveTimeInS*1.0E6);
+}
+
+shared_ptr<transshipment::IncrementalFlowGraph> Context::getIncrementalFlowGraph()
+{
+    std::lock_guard<std::mutex> lock(mIncrementalFlowGraphsMutex);
+    shared_ptr<transshipment::IncrementalFlowGraph>& flowGraph = mIncrementalFlowGraphs[std::this_thread::get_id()];
+    if(!flowGraph)
+    {
+        flowGraph = make_shared<transshipment::IncrementalFlowGraph>();
+    }
+    return flowGraph;
+}
+
+void Context::clearIncrementalFlowGraphs()
+{
+    std::lock_guard<std::mutex> lock(mIncrementalFlowGraphsMutex);
+    mIncrementalFlowGraphs.clear();
+}
+
 } // end namespace csp
 } // end namespace solvers
 } // end namespace templ
@@ -1,11 +1,19 @@
 #ifndef TEMPL_SOLVERS_CSP_CONTEXT_HPP
 #define TEMPL_SOLVERS_CSP_CONTEXT_HPP
 
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <thread>
 #include "../../Mission.hpp"
 #include <qxcfg/Configuration.hpp>
 
 namespace templ {
 namespace solvers {
+namespace transshipment {
+    class IncrementalFlowGraph;
+}
+
 namespace csp {
 
 class Context
@@ -21,12 +29,82 @@ public:
 
     const std::vector<solvers::temporal::Interval>& intervals() const { return mIntervals; }
 
+    /**
+     * Get all roles (agent instances) of the mission
+     */
+    const Role::List& roles() const { return mRoles; }
+
     size_t getNumberOfTimepoints() const { return mNumberOfTimepoints; }
     size_t getNumberOfFluents() const { return mNumberOfFluents; }
 
     const qxcfg::Configuration& configuration() const { return mConfiguration; }
 
-
+    /**
+     * Get the cost of the best solution found so far by any of the
+     * search threads/assets
+     */
+    uint32_t getBestCost() const { return mBestCost.load(); }
+
+    /**
+     * Update the best known cost, if the given cost is lower
+     * than the existing one
+     * \return true if the cost was an improvement, false otherwise
+     */
+    bool updateBestCost(uint32_t cost);
+
+    /**
+     * Account for a min cost flow optimization, i.e., the time to set up the
+     * flow graph, the time to create and solve the LP problem, and -- for the
+     * in-memory solver -- the time to build the LP model and to solve it
+     * \see transshipment::MinCostFlow::getFlowGraphTime
+     * \see transshipment::MinCostFlow::getProblemAndSolveTime
+     * \see transshipment::MinCostFlow::getModelTime
+     * \see transshipment::MinCostFlow::getSolveTime
+     */
+    void addLPRun(double flowGraphTimeInS, double problemAndSolveTimeInS,
+            double modelTimeInS = 0, double solveTimeInS = 0);
+
+    /**
+     * Get the number of min cost flow optimizations
+     */
+    uint64_t getNumberOfLPRuns() const { return mNumberOfLPRuns.load(); }
+
+    /**
+     * Get the accumulated time to set up the flow graphs in seconds
+     */
+    double getLPFlowGraphTime() const { return mLPFlowGraphTimeInUs.load()/1.0E6; }
+
+    /**
+     * Get the accumulated time to create, write and solve the LP problems in
+     * seconds
+     */
+    double getLPProblemAndSolveTime() const { return mLPProblemAndSolveTimeInUs.load()/1.0E6; }
+
+    /**
+     * Get the accumulated time to build the LP models of the in-memory
+     * solver in seconds
+     */
+    double getLPModelTime() const { return mLPModelTimeInUs.load()/1.0E6; }
+
+    /**
+     * Get the accumulated time spent in the in-memory solver in seconds
+     */
+    double getLPSolveTime() const { return mLPSolveTimeInUs.load()/1.0E6; }
+
+    /**
+     * Get the flow graph for incremental min cost flow optimization of the
+     * calling thread
+     *
+     * Since spaces might be evaluated concurrently, one flow graph is
+     * maintained per thread. The flow graphs are owned by the context, i.e.,
+     * they do not outlive a solver run
+     */
+    shared_ptr<transshipment::IncrementalFlowGraph> getIncrementalFlowGraph();
+
+    /**
+     * Release the flow graphs of all threads
+     */
+    void clearIncrementalFlowGraphs();
 
 private:
     moreorg::OrganizationModelAsk mAsk;
@@ -36,11 +114,28 @@ private:
 
     std::vector<solvers::temporal::Interval> mIntervals;
 
+    /// Constants: Roles (as defined in the mission)
+    Role::List mRoles;
+
     /// Configuration object
     qxcfg::Configuration mConfiguration;
 
     size_t mNumberOfTimepoints;
     size_t mNumberOfFluents;
+
+    /// Best cost shared between all spaces (and threads) of a search
+    std::atomic<uint32_t> mBestCost;
+
+    /// LP statistics shared between all spaces (and threads) of a search
+    std::atomic<uint64_t> mNumberOfLPRuns;
+    std::atomic<uint64_t> mLPFlowGraphTimeInUs;
+    std::atomic<uint64_t> mLPProblemAndSolveTimeInUs;
+    std::atomic<uint64_t> mLPModelTimeInUs;
+    std::atomic<uint64_t> mLPSolveTimeInUs;
+
+    /// Flow graphs for incremental min cost flow optimization per thread
+    std::mutex mIncrementalFlowGraphsMutex;
+    std::map<std::thread::id, shared_ptr<transshipment::IncrementalFlowGraph> > mIncrementalFlowGraphs;
 };
 
 } // end namespace csp
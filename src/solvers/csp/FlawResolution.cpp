@@ -5,6 +5,15 @@
 #include "MissionConstraintManager.hpp"
 #include <moreorg/PropertyConstraint.hpp>
 #include "../../constraints/ModelConstraint.hpp"
+#include "../../utils/Tracer.hpp"
+#include "../../utils/DebugTrace.hpp"
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <exception>
+#include <limits>
+#include <cmath>
+#include <algorithm>
 
 namespace ga = graph_analysis::algorithms;
 
@@ -14,21 +23,36 @@ namespace csp {
 
 FlawResolution::FlawResolution()
     : mGenerator(std::random_device()())
+    , mCombinationsExhausted(true)
+    , mRemainingDraws(0)
 {
 }
 
 FlawResolution::FlawResolution(const FlawResolution& other)
     : mGenerator(other.mGenerator)
+    , mRanking(other.mRanking)
+    , mCombination(other.mCombination)
+    , mCombinationsExhausted(other.mCombinationsExhausted)
     , mDraws(other.mDraws)
+    , mRemainingDraws(other.mRemainingDraws)
     , mCurrentDraw(other.mCurrentDraw)
     , mResolutionOptions(other.mResolutionOptions)
 {
 }
 
+double FlawResolution::getSeverity(const transshipment::Flaw& flaw)
+{
+    return std::abs(flaw.getViolation().getDelta());
+}
+
 void FlawResolution::prepare(const std::vector<transshipment::Flaw>& flaws)
 {
     mResolutionOptions.clear();
+    mRanking.clear();
+    mCombination.clear();
+    mCombinationsExhausted = true;
     mDraws.clear();
+    mRemainingDraws = 0;
 
     if(flaws.empty())
     {
@@ -57,29 +81,87 @@ void FlawResolution::prepare(const std::vector<transshipment::Flaw>& flaws)
         }
     }
 
-    Draw indices;
-    for(size_t i = 0; i < mResolutionOptions.size(); ++i)
+    size_t numberOfOptions = mResolutionOptions.size();
+    if(numberOfOptions == 0)
+    {
+        return;
+    }
+
+    for(size_t i = 0; i < numberOfOptions; ++i)
     {
-        indices.push_back(i);
+        mRanking.push_back(i);
     }
+    std::stable_sort(mRanking.begin(), mRanking.end(), [this](size_t a, size_t b)
+            {
+                return getSeverity(mResolutionOptions[a].first) > getSeverity(mResolutionOptions[b].first);
+            });
 
-    if(!indices.empty())
+    // all non-empty subsets
+    if(numberOfOptions < 64)
     {
-        numeric::Combination<size_t> combinations(indices, 1, numeric::MAX);
-        do {
-            Draw combination = combinations.current();
-            mDraws.push_back(combination);
-        } while(combinations.next());
+        mRemainingDraws = (static_cast<uint64_t>(1) << numberOfOptions) - 1;
+    } else {
+        mRemainingDraws = std::numeric_limits<uint64_t>::max();
     }
+
+    // start with the single most severe flaw
+    mCombination.push_back(0);
+    mCombinationsExhausted = false;
+    fillDrawWindow();
 }
 
-FlawResolution::ResolutionOptions FlawResolution::current() const
+bool FlawResolution::nextCombination() const
+{
+    size_t n = mRanking.size();
+    size_t k = mCombination.size();
+
+    // find the rightmost position that can still be incremented
+    for(size_t i = k; i > 0; --i)
+    {
+        size_t idx = i - 1;
+        if(mCombination[idx] < n - k + idx)
+        {
+            ++mCombination[idx];
+            for(size_t j = idx + 1; j < k; ++j)
+            {
+                mCombination[j] = mCombination[j-1] + 1;
+            }
+            return true;
+        }
+    }
+
+    // continue with the next larger draw size
+    if(k >= n)
+    {
+        return false;
+    }
+    mCombination.clear();
+    for(size_t i = 0; i <= k; ++i)
+    {
+        mCombination.push_back(i);
+    }
+    return true;
+}
+
+void FlawResolution::fillDrawWindow() const
 {
-    if(TransportNetwork::msInteractive)
+    while(!mCombinationsExhausted && mDraws.size() < DRAW_WINDOW_SIZE)
     {
-        std::cout << "Resolutions options: " << mResolutionOptions.size() << " draw:" << toString(mCurrentDraw);
-        std::cin.ignore( std::numeric_limits<std::streamsize>::max(), '\n' );
+        Draw draw;
+        for(size_t position : mCombination)
+        {
+            draw.push_back(mRanking[position]);
+        }
+        mDraws.push_back(draw);
+
+        mCombinationsExhausted = !nextCombination();
     }
+}
+
+FlawResolution::ResolutionOptions FlawResolution::current() const
+{
+    TEMPL_DEBUG_TRACE_IF(TransportNetwork::msInteractive, TransportNetwork::breakpoint,
+            "Resolutions options: " << mResolutionOptions.size() << " draw:" << toString(mCurrentDraw));
     return select<ResolutionOption>(mResolutionOptions, mCurrentDraw);
 }
 
@@ -119,23 +201,28 @@ bool FlawResolution::next(bool random) const
 
     if(!random)
     {
-        mCurrentDraw = mDraws.back();
-        mDraws.pop_back();
+        mCurrentDraw = mDraws.front();
+        mDraws.erase(mDraws.begin());
     } else {
         size_t optionsSize = mDraws.size();
         std::uniform_int_distribution<> dis(0,optionsSize-1);
         size_t idx = dis(mGenerator);
         mCurrentDraw = mDraws.at(idx);
         mDraws.erase( mDraws.begin() + idx);
-        mDraws.resize(optionsSize-1);
     }
+    if(mRemainingDraws != std::numeric_limits<uint64_t>::max())
+    {
+        --mRemainingDraws;
+    }
+    fillDrawWindow();
     return true;
 }
 
 Constraint::PtrList FlawResolution::selectBestResolution(Gecode::Space& space,
         const Gecode::Space& lastSolution,
         uint32_t existingCost,
-        const FlawResolution::ResolutionOptions& resolutionOptions)
+        const FlawResolution::ResolutionOptions& resolutionOptions,
+        size_t numberOfThreads)
 {
     Constraint::PtrList constraints = translate(space, lastSolution, resolutionOptions);
     if(constraints.empty())
@@ -149,6 +236,60 @@ Constraint::PtrList FlawResolution::selectBestResolution(Gecode::Space& space,
     double cost = transportNetwork.cost().val();
     double improvedCost = cost;
 
+    if(numberOfThreads > 1 && constraints.size() > 1)
+    {
+        // Score each constraint independently
+        std::vector<Constraint::PtrList> candidates;
+        for(const Constraint::Ptr& constraint : constraints)
+        {
+            candidates.push_back( Constraint::PtrList(1, constraint) );
+        }
+        EvaluationList evaluationList = evaluate(space, lastSolution, candidates, numberOfThreads);
+
+        EvaluationList improving;
+        for(const Evaluation& eval : evaluationList)
+        {
+            if(eval.second < cost)
+            {
+                improving.push_back(eval);
+            }
+        }
+        if(improving.empty())
+        {
+            return Constraint::PtrList();
+        }
+
+        std::stable_sort(improving.begin(), improving.end(), [](const Evaluation& a, const Evaluation& b)
+                {
+                    return a.second < b.second;
+                });
+
+        Evaluation best = improving.front();
+        if(best.second == 0 || improving.size() == 1)
+        {
+            return best.first;
+        }
+
+        // Combine the improving constraints, starting with the best one and
+        // adding the next best one at a time
+        std::vector<Constraint::PtrList> combinations;
+        Constraint::PtrList combination = best.first;
+        for(size_t i = 1; i < improving.size(); ++i)
+        {
+            combination.push_back( improving[i].first.front() );
+            combinations.push_back(combination);
+        }
+        EvaluationList combinedList = evaluate(space, lastSolution, combinations, numberOfThreads);
+        for(const Evaluation& eval : combinedList)
+        {
+            if(eval.second < best.second)
+            {
+                best = eval;
+            }
+        }
+        return best.first;
+    }
+
     EvaluationList evaluationList;
     Constraint::PtrList testGroup;
     for(size_t a = 0; a < constraints.size(); ++a)
@@ -189,6 +330,8 @@ FlawResolution::Evaluation FlawResolution::evaluate(Gecode::Space& space,
         const Gecode::Space& lastSolution,
         const Constraint::PtrList& constraints)
 {
+    templ::utils::Tracer::Scope traceScope("FlawResolution::evaluate", "flaw-resolution");
+
     Gecode::Space* master = space.clone();
     TransportNetwork* transportNetwork = dynamic_cast<TransportNetwork*>(master);
     MissionConstraintManager::apply(constraints, *transportNetwork);
@@ -219,12 +362,80 @@ FlawResolution::Evaluation FlawResolution::evaluate(Gecode::Space& space,
     {
         cost = solution->cost().val();
         delete solution;
-        delete master;
     }
+    delete master;
 
     return Evaluation(constraints, cost);
 }
 
+FlawResolution::EvaluationList FlawResolution::evaluate(Gecode::Space& space,
+        const Gecode::Space& lastSolution,
+        const std::vector<Constraint::PtrList>& constraintLists,
+        size_t numberOfThreads)
+{
+    EvaluationList evaluationList(constraintLists.size());
+    size_t numberOfWorkers = std::min(std::max<size_t>(1, numberOfThreads), constraintLists.size());
+    if(numberOfWorkers <= 1)
+    {
+        for(size_t i = 0; i < constraintLists.size(); ++i)
+        {
+            evaluationList[i] = evaluate(space, lastSolution, constraintLists[i]);
+        }
+        return evaluationList;
+    }
+
+    // Cloning is not thread-safe with respect to the original space, so
+    // each worker gets its own clone from the calling thread
+    std::vector<Gecode::Space*> workerSpaces;
+    for(size_t i = 0; i < numberOfWorkers; ++i)
+    {
+        workerSpaces.push_back( space.clone() );
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    std::vector<std::thread> workers;
+    for(size_t w = 0; w < numberOfWorkers; ++w)
+    {
+        Gecode::Space* workerSpace = workerSpaces[w];
+        workers.push_back( std::thread([&, workerSpace]()
+            {
+                size_t i;
+                while((i = nextIndex++) < constraintLists.size())
+                {
+                    try {
+                        evaluationList[i] = evaluate(*workerSpace, lastSolution, constraintLists[i]);
+                    } catch(...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if(!error)
+                        {
+                            error = std::current_exception();
+                        }
+                        return;
+                    }
+                }
+            }) );
+    }
+
+    for(std::thread& worker : workers)
+    {
+        worker.join();
+    }
+    for(Gecode::Space* workerSpace : workerSpaces)
+    {
+        delete workerSpace;
+    }
+
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+    return evaluationList;
+}
+
 FluentTimeResource::List FlawResolution::getAffectedRequirements(const SpaceTime::Point& spacetime,
             graph_analysis::algorithms::ConstraintViolation::Type violationType,
             const FluentTimeResource::List allRequirements)
@@ -273,7 +484,7 @@ Constraint::Ptr FlawResolution::translate(Gecode::Space& space,
 
     ga::ConstraintViolation::Type violationType = flaw.getViolation().getType();
     FluentTimeResource::List ftrs = getAffectedRequirements(flaw.getSpaceTime(),
-            violationType, lastSpace.mResourceRequirements);
+            violationType, *lastSpace.mResourceRequirements);
 
     switch(violationType)
     {
@@ -285,8 +496,8 @@ Constraint::Ptr FlawResolution::translate(Gecode::Space& space,
                     case 0:
                     {
                             std::set<Role> uniqueRoles = MissionConstraints::getUniqueRoles(lastSpace.mRoleUsage,
-                                    currentSpace.mRoles,
-                                    currentSpace.mResourceRequirements,
+                                    currentSpace.mpContext->roles(),
+                                    *currentSpace.mResourceRequirements,
                                     ftrs,
                                     flaw.affectedRole().getModel());
 
@@ -300,7 +511,7 @@ Constraint::Ptr FlawResolution::translate(Gecode::Space& space,
                     case 1:
                     {
                         FluentTimeResource::List ftrs = getAffectedRequirements(flaw.getSpaceTime(),
-                            violationType, lastSpace.mResourceRequirements);
+                            violationType, *lastSpace.mResourceRequirements);
 
                         constraints::ModelConstraint::Ptr constraint = make_shared<constraints::ModelConstraint>(
                                 constraints::ModelConstraint::MIN_FUNCTION,
@@ -323,7 +534,7 @@ Constraint::Ptr FlawResolution::translate(Gecode::Space& space,
             {
                 case 0:
                     FluentTimeResource::List ftrs = getAffectedRequirements(flaw.getSpaceTime(),
-                        violationType, lastSpace.mResourceRequirements);
+                        violationType, *lastSpace.mResourceRequirements);
 
                     constraints::ModelConstraint::Ptr constraint = make_shared<constraints::ModelConstraint>(
                             constraints::ModelConstraint::MIN_PROPERTY,
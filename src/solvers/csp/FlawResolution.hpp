@@ -3,7 +3,6 @@
 
 #include <vector>
 #include <random>
-#include <numeric/Combinatorics.hpp>
 #include "../transshipment/Flaw.hpp"
 #include <gecode/search.hh>
 //#include <graph_analysis/algorithms/ConstraintViolation.hpp>
@@ -18,6 +17,11 @@ namespace csp {
  *
  * Computes combinations of resolution options, so that they can
  * be tested
+ *
+ * Combinations (draws) are generated lazily: resolution options are ranked by
+ * the severity of the flaw, and draws are generated by increasing size and
+ * in order of this ranking. Only a small window of upcoming draws is kept in
+ * memory, so that memory use does not depend on the number of combinations
  */
 class FlawResolution
 {
@@ -43,7 +47,10 @@ public:
     void prepare(const std::vector<transshipment::Flaw>& flaws);
 
     /**
-     *
+     * Move to the next draw
+     * \param random If true, pick the draw randomly from the window of
+     * upcoming draws, otherwise take the best ranked draw
+     * \return false if all draws have been used
      */
     bool next(bool random = true) const;
 
@@ -57,9 +64,19 @@ public:
      */
     const ResolutionOptions& getResolutionOptions() const { return mResolutionOptions; }
 
-    const DrawList& remainingDraws() const { return mDraws; }
+    /**
+     * Get the number of draws that have not been used yet (saturates at the
+     * maximum value of uint64_t)
+     */
+    uint64_t remainingDraws() const { return mRemainingDraws; }
+
+    bool exhausted() const { return mDraws.empty(); }
 
-    bool exhausted() { return mDraws.empty(); }
+    /**
+     * Compute the severity of a flaw, which is used to rank the
+     * resolution options
+     */
+    static double getSeverity(const transshipment::Flaw& flaw);
 
     /**
      * Select items from a list according to a given draw
@@ -78,10 +95,32 @@ public:
     static std::string toString(const ResolutionOptions& options);
     static std::string toString(const Draw& draw);
 
+    /**
+     * Select the combination of resolution constraints which improves the
+     * last solution most
+     * \param numberOfThreads If larger than 1, the constraints are first
+     * scored independently by a pool of workers (each operating on its own
+     * clone of space), then the improving ones are combined in order of their
+     * score and the combinations are scored concurrently as well
+     * \return the best combination, or an empty list if no combination
+     * improves the last solution
+     */
     static Constraint::PtrList selectBestResolution(Gecode::Space& space,
             const Gecode::Space& lastSolution,
             uint32_t existingCost,
-            const FlawResolution::ResolutionOptions& resolutionOptions);
+            const FlawResolution::ResolutionOptions& resolutionOptions,
+            size_t numberOfThreads = 1);
+
+    /**
+     * Evaluate each list of constraints using a pool of workers
+     * \param space Space to evaluate the constraints for; it is cloned once
+     * per worker on the calling thread
+     * \return the evaluations in the order of the given constraint lists
+     */
+    static EvaluationList evaluate(Gecode::Space& space,
+            const Gecode::Space& lastSolution,
+            const std::vector<Constraint::PtrList>& constraintLists,
+            size_t numberOfThreads);
 
     static Evaluation evaluate(Gecode::Space& space,
             const Gecode::Space& lastSolution,
@@ -96,9 +135,26 @@ public:
             const ResolutionOptions& resolutionOptions);
 
 private:
+    /// Maximum number of upcoming draws that are kept for a random selection
+    static const size_t DRAW_WINDOW_SIZE = 16;
+
+    /// Fill the window of upcoming draws
+    void fillDrawWindow() const;
+
+    /// Advance mCombination to the next combination of ranked options
+    /// \return false if no further combination exists
+    bool nextCombination() const;
+
     mutable std::mt19937 mGenerator;
 
+    /// Indices of the resolution options ordered by decreasing severity
+    Draw mRanking;
+    /// Positions in mRanking that form the current combination
+    mutable Draw mCombination;
+    mutable bool mCombinationsExhausted;
+    /// Window of upcoming draws
     mutable DrawList mDraws;
+    mutable uint64_t mRemainingDraws;
     mutable Draw mCurrentDraw;
 
     mutable ResolutionOptions mResolutionOptions;
@@ -36,8 +36,8 @@ void MissionConstraintManager::apply(const shared_ptr<constraints::ModelConstrai
 {
     // Variable derived from solver
     Gecode::IntVarArray& roleUsage = transportNetwork.mRoleUsage;
-    const Role::List& roles = transportNetwork.mRoles;
-    FluentTimeResource::List& allRequirements = transportNetwork.mResourceRequirements;
+    const Role::List& roles = transportNetwork.mpContext->roles();
+    const FluentTimeResource::List& allRequirements = *transportNetwork.mResourceRequirements;
 
     const owlapi::model::IRI& roleModel = constraint->getModel();
 
@@ -105,7 +105,7 @@ void MissionConstraintManager::apply(const shared_ptr<constraints::ModelConstrai
             break;
         case ModelConstraint::MIN_FUNCTION:
             MissionConstraints::addResourceRequirement(
-                    allRequirements,
+                    transportNetwork.mResourceRequirements.write(),
                     affectedRequirements,
                     moreorg::Resource(constraint->getModel()),
                     transportNetwork.mpMission->getOrganizationModelAsk());
@@ -124,7 +124,7 @@ void MissionConstraintManager::apply(const shared_ptr<constraints::ModelConstrai
             resource.setPropertyConstraints(constraints);
 
             MissionConstraints::addResourceRequirement(
-                    allRequirements,
+                    transportNetwork.mResourceRequirements.write(),
                     affectedRequirements,
                     resource,
                     transportNetwork.mpMission->getOrganizationModelAsk());
@@ -143,7 +143,7 @@ void MissionConstraintManager::apply(const shared_ptr<constraints::ModelConstrai
             resource.setPropertyConstraints(constraints);
 
             MissionConstraints::addResourceRequirement(
-                    allRequirements,
+                    transportNetwork.mResourceRequirements.write(),
                     affectedRequirements,
                     resource,
                     transportNetwork.mpMission->getOrganizationModelAsk());
@@ -0,0 +1,53 @@
+#include "SearchStop.hpp"
+
+namespace templ {
+namespace solvers {
+namespace csp {
+
+SearchStop::SearchStop(const StoppingCriteria& criteria,
+        double epochTimeoutInMs,
+        const Gecode::Search::Statistics& offset)
+    : mStoppingCriteria(criteria)
+    , mEpochStart(base::Time::now())
+    , mEpochTimeoutInMs(epochTimeoutInMs)
+    , mOffset(offset)
+    , mCalls(0)
+    , mEpochTimedOut(false)
+    , mCriteriaMet(false)
+{
+}
+
+const uint64_t SearchStop::CHECK_INTERVAL;
+
+bool SearchStop::stop(const Gecode::Search::Statistics& s, const Gecode::Search::Options& o)
+{
+    if(mEpochTimedOut || mCriteriaMet)
+    {
+        return true;
+    }
+    if(mCalls.fetch_add(1, std::memory_order_relaxed) % CHECK_INTERVAL != 0)
+    {
+        return false;
+    }
+
+    if(mEpochTimeoutInMs > 0 && (base::Time::now() - mEpochStart).toMilliseconds() >= mEpochTimeoutInMs)
+    {
+        mEpochTimedOut = true;
+        return true;
+    }
+
+    if(!mStoppingCriteria.empty())
+    {
+        mStoppingCriteria.updateSearchStatistics(mOffset.node + s.node, mOffset.fail + s.fail);
+        if(mStoppingCriteria.isMet())
+        {
+            mCriteriaMet = true;
+            return true;
+        }
+    }
+    return false;
+}
+
+} // end namespace csp
+} // end namespace solvers
+} // end namespace templ
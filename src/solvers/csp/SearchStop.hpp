@@ -0,0 +1,66 @@
+#ifndef TEMPL_SOLVERS_CSP_SEARCH_STOP_HPP
+#define TEMPL_SOLVERS_CSP_SEARCH_STOP_HPP
+
+#include <atomic>
+#include <gecode/search.hh>
+#include <base/Time.hpp>
+#include "../StoppingCriteria.hpp"
+
+namespace templ {
+namespace solvers {
+namespace csp {
+
+/**
+ * Stop object for the Gecode search engines, which checks the given stopping
+ * criteria and an optional timeout for the current search epoch
+ *
+ * The statistics reported by the engine are added to the given offset, so
+ * that node and fail budgets can span multiple search engines.
+ * With portfolio search, the statistics are reported per asset.
+ *
+ * Since stop() is called for every search node (by all search threads), the
+ * criteria and the timeout are only checked every CHECK_INTERVAL calls, so
+ * that budgets can be exceeded by at most this number of nodes
+ */
+class SearchStop : public Gecode::Search::Stop
+{
+public:
+    /// Number of calls to stop() between two checks
+    static const uint64_t CHECK_INTERVAL = 64;
+
+    /**
+     * \param criteria Stopping criteria
+     * \param epochTimeoutInMs Timeout for this stop object, 0 to disable
+     * \param offset Statistics of previous search engines
+     */
+    SearchStop(const StoppingCriteria& criteria,
+            double epochTimeoutInMs = 0,
+            const Gecode::Search::Statistics& offset = Gecode::Search::Statistics());
+
+    virtual bool stop(const Gecode::Search::Statistics& s, const Gecode::Search::Options& o);
+
+    /**
+     * Check whether the search has been stopped due to the epoch timeout
+     */
+    bool epochTimedOut() const { return mEpochTimedOut; }
+
+    /**
+     * Check whether the search has been stopped due to the stopping criteria
+     */
+    bool criteriaMet() const { return mCriteriaMet; }
+
+private:
+    StoppingCriteria mStoppingCriteria;
+    base::Time mEpochStart;
+    double mEpochTimeoutInMs;
+    Gecode::Search::Statistics mOffset;
+
+    std::atomic<uint64_t> mCalls;
+    std::atomic<bool> mEpochTimedOut;
+    std::atomic<bool> mCriteriaMet;
+};
+
+} // end namespace csp
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_CSP_SEARCH_STOP_HPP
@@ -7,6 +7,7 @@
 #include <gecode/gist.hh>
 #include <gecode/search.hh>
 
+#include <deque>
 #include <iterator>
 #include <iomanip>
 #include <fstream>
@@ -31,21 +32,52 @@
 #include "utils/Formatter.hpp"
 #include "utils/Converter.hpp"
 #include "../../utils/CSVLogger.hpp"
+#include "../../utils/PhaseTimer.hpp"
+#include "../../utils/Tracer.hpp"
+#include "../../utils/DebugTrace.hpp"
 #include "MissionConstraints.hpp"
 #include "Search.hpp"
+#include "SearchStop.hpp"
 #include "../SolutionAnalysis.hpp"
+#include "../transshipment/GLPKMinCostFlow.hpp"
 #include "MissionConstraintManager.hpp"
 #include "../../constraints/ModelConstraint.hpp"
 
 using namespace templ::solvers::csp::utils;
 using namespace owlapi::model;
 
+/// Show a message and wait for the user in interactive mode, the message is
+/// only formatted when needed
+#define TEMPL_BREAKPOINT(...) TEMPL_DEBUG_TRACE_IF(TransportNetwork::msInteractive, TransportNetwork::breakpoint, __VA_ARGS__)
+
 namespace templ {
 namespace solvers {
 namespace csp {
 
+namespace {
+
+/// Stopping criterion which is met when a stop has been requested for
+/// the session
+class StopRequested : public StoppingCriteria::Criterion
+{
+public:
+    StopRequested(const Session::Ptr& session)
+        : mpSession(session)
+    {}
+
+    bool isMet(const StoppingCriteria::Progress& progress) const { return mpSession->isStopRequested(); }
+
+    std::string toString() const { return "stop requested"; }
+
+private:
+    Session::Ptr mpSession;
+};
+
+} // end anonymous namespace
+
 bool TransportNetwork::msInteractive = false;
-TransportNetwork::FlowSolutions TransportNetwork::msMinCostFlowSolutions;
+transshipment::MinCostFlowCache TransportNetwork::msMinCostFlowSolutions;
+transshipment::PersistentMinCostFlowCache::Ptr TransportNetwork::msPersistentMinCostFlowSolutions;
 
 std::string TransportNetwork::Solution::toString(uint32_t indent) const
 {
@@ -99,6 +131,7 @@ bool TransportNetwork::master(const Gecode::MetaInfo& mi)
     switch(mi.type())
     {
         case Gecode::MetaInfo::RESTART:
+            templ::utils::Tracer::instant("restart", "search");
             if(mi.last() != NULL)
             {
                 constrain(*mi.last());
@@ -116,7 +149,7 @@ bool TransportNetwork::master(const Gecode::MetaInfo& mi)
 
 void TransportNetwork::next(const TransportNetwork& lastSpace, const Gecode::MetaInfo& mi)
 {
-    breakpoint("BEGIN next()");
+    TEMPL_BREAKPOINT("BEGIN next()");
 
     // constrain the next space // but not the first
     if(mi.last() != NULL)
@@ -130,17 +163,17 @@ void TransportNetwork::next(const TransportNetwork& lastSpace, const Gecode::Met
         mRequiredResolutionOptions = lastSpace.mRequiredResolutionOptions;
     }
 
-    breakpointStart()
-        << "next():" << std::endl
-        << "    # flaws: " << mMinCostFlowFlaws.size() << std::endl
-        << "    # resolution options: " <<
-        mFlawResolution.remainingDraws().size() << std::endl
-        ;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("next():" << std::endl
+            << "    # flaws: " << mMinCostFlowFlaws->size() << std::endl
+            << "    # resolution options: " <<
+            mFlawResolution.remainingDraws() << std::endl);
 
     namespace ga = graph_analysis::algorithms;
 
-    Constraint::PtrList constraints = FlawResolution::selectBestResolution(*this, lastSpace, lastSpace.cost().val(), mFlawResolution.getResolutionOptions());
+    size_t flawResolutionThreads = mpContext->configuration().getValueAs<size_t>("TransportNetwork/search/options/flaw-resolution/threads",1);
+    Constraint::PtrList constraints = FlawResolution::selectBestResolution(*this, lastSpace, lastSpace.cost().val(),
+            mFlawResolution.getResolutionOptions(),
+            flawResolutionThreads);
     if(constraints.empty())
     {
         std::cout << "    # no applicable resolvers better than " << lastSpace.cost().val() <<
@@ -176,21 +209,29 @@ void TransportNetwork::constrain(const Gecode::Space& lastSpace)
 {
     const TransportNetwork& lastTransportNetwork = static_cast<const TransportNetwork&>(lastSpace);
 
-    breakpointStart()
-        << "constrain()" << std::endl
-        << "Last state: " << std::endl
-        << "    # cost: "<< lastTransportNetwork.mCost.val() << std::endl
-        << "    # flaws: "<< lastTransportNetwork.mMinCostFlowFlaws.size() << std::endl
-        << "    # resolution options: " << lastTransportNetwork.mFlawResolution.remainingDraws().size() <<
-        std::endl
-        << "Current: " << std::endl
-        << "    # cost: " << cost() << std::endl;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("constrain()" << std::endl
+            << "Last state: " << std::endl
+            << "    # cost: "<< lastTransportNetwork.mCost << std::endl
+            << "    # flaws: "<< lastTransportNetwork.mMinCostFlowFlaws->size() << std::endl
+            << "    # resolution options: " << lastTransportNetwork.mFlawResolution.remainingDraws() <<
+            std::endl
+            << "Current: " << std::endl
+            << "    # cost: " << cost() << std::endl);
 
 
     bool hillClimbing = mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/hill-climbing",false);
     if(hillClimbing)
     {
+        if(!lastTransportNetwork.cost().assigned())
+        {
+            // The min cost flow of the last space is still evaluated
+            // asynchronously, so use the best result known so far
+            if(mpContext->getBestCost() != std::numeric_limits<uint32_t>::max())
+            {
+                rel(*this, cost(), Gecode::IRT_LE, mpContext->getBestCost());
+            }
+            return;
+        }
         rel(*this, cost(), Gecode::IRT_LE, lastTransportNetwork.cost().val());
         // TODO:
         // check on the number of flows and the cost of the solution in order to
@@ -202,12 +243,10 @@ void TransportNetwork::constrainSlave(const Gecode::Space& lastSpace)
 {
     const TransportNetwork& lastTransportNetwork = static_cast<const TransportNetwork&>(lastSpace);
 
-    breakpointStart()
-         << "constrainSlave()" << std::endl
-         << "Last state: " << std::endl
-         << "    # flaws: "<< lastTransportNetwork.mMinCostFlowFlaws.size() << std::endl
-         << "    # resolution options: " << lastTransportNetwork.mFlawResolution.remainingDraws().size() << std::endl;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("constrainSlave()" << std::endl
+            << "Last state: " << std::endl
+            << "    # flaws: "<< lastTransportNetwork.mMinCostFlowFlaws->size() << std::endl
+            << "    # resolution options: " << lastTransportNetwork.mFlawResolution.remainingDraws() << std::endl);
 
     //rel(*this, cost(), Gecode::IRT_LE, lastTransportNetwork.cost().val());
 
@@ -236,6 +275,16 @@ void TransportNetwork::constrainSlave(const Gecode::Space& lastSpace)
 // previous solution
 bool TransportNetwork::slave(const Gecode::MetaInfo& mi)
 {
+    if(mi.type() == Gecode::MetaInfo::PORTFOLIO)
+    {
+        // The master has killed all branchers, so each asset posts
+        // its own with its own settings
+        configureAsset(mi.asset());
+        branchTemporalConstraintNetwork();
+        // search of the asset is complete
+        return true;
+    }
+
     if(!mUseMasterSlave)
     {
         // using default implementation of slave, i.e. search is complete
@@ -244,18 +293,14 @@ bool TransportNetwork::slave(const Gecode::MetaInfo& mi)
         mpMission->getLogger()->incrementSessionId();
     }
 
-    breakpointStart()
-        << "slave() with restarts: " << mi.restart() << std::endl;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("slave() with restarts: " << mi.restart() << std::endl);
 
     if(mi.type() == Gecode::MetaInfo::RESTART)
     {
         if(!mi.last())
         {
             // the previous call with initialize the selected draw
-            breakpointStart()
-                    << "No last space available, thus slave search is complete" << std::endl;
-            breakpointEnd();
+            TEMPL_BREAKPOINT("No last space available, thus slave search is complete" << std::endl);
 
             // slave should only expand an existing solution,
             // but search is not complete at this stage
@@ -268,9 +313,7 @@ bool TransportNetwork::slave(const Gecode::MetaInfo& mi)
         if(!lastSpace.mFlawResolution.next(true))
         {
             // the previous call with initialize the selected draw
-            breakpointStart()
-                << "Flaw resolution: options are exhausted slave search is complete" << std::endl;
-            breakpointEnd();
+            TEMPL_BREAKPOINT("Flaw resolution: options are exhausted slave search is complete" << std::endl);
 
             // Options are exhausted Search is complete
             mpMission->getLogger()->incrementSessionId();
@@ -292,9 +335,9 @@ TransportNetwork::Solution TransportNetwork::getSolution() const
         solution.mRoleDistribution = getRoleDistribution();
         solution.mTimelines = getTimelines();
         solution.mLocations = mpContext->locations();
-        solution.mTimepoints = mTimepoints;
-        solution.mMinCostFlowSolution = mMinCostFlowSolution;
-        solution.mSolutionAnalysis = mSolutionAnalysis;
+        solution.mTimepoints = *mTimepoints;
+        solution.mMinCostFlowSolution = *mMinCostFlowSolution;
+        solution.mSolutionAnalysis = *mSolutionAnalysis;
     } catch(std::exception& e)
     {
         LOG_WARN_S << e.what();
@@ -304,6 +347,9 @@ TransportNetwork::Solution TransportNetwork::getSolution() const
 
 void TransportNetwork::saveSolution(const Solution& solution, const Mission::Ptr& mission)
 {
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::SAVE_SOLUTION);
+    templ::utils::Tracer::Scope traceScope("saveSolution", "io");
+
     std::string filename;
     int i = mission->getLogger()->getSessionId();
     try {
@@ -339,10 +385,10 @@ TransportNetwork::ModelDistribution TransportNetwork::getModelDistribution() con
     ModelDistribution solution;
 
     Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage,
-            mpMission->getAvailableResources().size(), mResourceRequirements.size());
+            mpMission->getAvailableResources().size(), mResourceRequirements->size());
 
     // Check if resource requirements holds
-    for(size_t i = 0; i < mResourceRequirements.size(); ++i)
+    for(size_t i = 0; i < mResourceRequirements->size(); ++i)
     {
         moreorg::ModelPool modelPool;
         for(size_t mi = 0; mi < mpMission->getAvailableResources().size(); ++mi)
@@ -358,7 +404,7 @@ TransportNetwork::ModelDistribution TransportNetwork::getModelDistribution() con
             modelPool[ mpMission->getModels()[mi] ] = v.val();
         }
 
-        solution[ mResourceRequirements[i] ] = modelPool;
+        solution[ (*mResourceRequirements)[i] ] = modelPool;
     }
     return solution;
 }
@@ -367,29 +413,29 @@ TransportNetwork::RoleDistribution TransportNetwork::getRoleDistribution() const
 {
     RoleDistribution solution;
 
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
 
     // Check if resource requirements holds
-    for(size_t i = 0; i < mResourceRequirements.size(); ++i)
+    for(size_t i = 0; i < mResourceRequirements->size(); ++i)
     {
         Role::List roles;
-        for(size_t r = 0; r < mRoles.size(); ++r)
+        for(size_t r = 0; r < mpContext->roles().size(); ++r)
         {
             Gecode::IntVar var = roleDistribution(r, i);
             if(!var.assigned())
             {
-                throw std::runtime_error("templ::solvers::csp::RoleDistribution::getSolution: value has not been assigned for role: '" + mRoles[r].toString() + "'");
+                throw std::runtime_error("templ::solvers::csp::RoleDistribution::getSolution: value has not been assigned for role: '" + mpContext->roles()[r].toString() + "'");
             }
 
             Gecode::IntVarValues v( var );
 
             if( v.val() == 1 )
             {
-                roles.push_back( mRoles[r] );
+                roles.push_back( mpContext->roles()[r] );
             }
         }
 
-        solution[ mResourceRequirements[i] ] = roles;
+        solution[ (*mResourceRequirements)[i] ] = roles;
     }
 
     return solution;
@@ -398,19 +444,19 @@ TransportNetwork::RoleDistribution TransportNetwork::getRoleDistribution() const
 std::map<Role, csp::RoleTimeline> TransportNetwork::getTimelines() const
 {
     std::map<Role, csp::RoleTimeline> roleTimelines;
-    for(size_t i = 0; i < mActiveRoleList.size(); ++i)
+    for(size_t i = 0; i < mActiveRoleList->size(); ++i)
     {
-        const Role& role = mActiveRoleList[i];
-        LOG_INFO_S << "Active role: " << i << " of " << mActiveRoleList.size() << " " << mActiveRoleList[i].toString() << std::endl
+        const Role& role = (*mActiveRoleList)[i];
+        TEMPL_DEBUG_LOG("Active role: " << i << " of " << mActiveRoleList->size() << " " << (*mActiveRoleList)[i].toString() << std::endl
             << Formatter::toString(mTimelines[i],
                     mpContext->locations(),
-                    mTimepoints)
-            << std::endl;
+                    *mTimepoints)
+            << std::endl);
 
         bool doThrow = false;
         SpaceTime::Timeline timeline = TypeConversion::toTimeline(mTimelines[i],
                 mpContext->locations(),
-                mTimepoints,
+                *mTimepoints,
                 doThrow);
 
         csp::RoleTimeline roleTimeline(role, mpContext->ask());
@@ -433,14 +479,16 @@ TransportNetwork::TransportNetwork(const templ::Mission::Ptr& mission, const qxc
     , mpMission(mission)
     , mpContext(make_shared<Context>(mission, configuration))
     , mTimepoints(mission->getUnorderedTimepoints())
-    , mResourceRequirements()
     , mQualitativeTimepoints(*this, mpMission->getQualitativeTemporalConstraintNetwork()->getTimepoints().size(), 0, mpMission->getQualitativeTemporalConstraintNetwork()->getTimepoints().size()-1)
     , mModelUsage()
     , mRoleUsage()
-    , mRoles(mission->getRoles())
     , mCost(*this,0, Gecode::Int::Limits::max)
     , mNumberOfFlaws(*this,0, Gecode::Int::Limits::max)
     , mUseMasterSlave(false)
+    , mModelUsageAfcDecay(configuration.getValueAs<double>("TransportNetwork/search/options/model-usage/afc-decay",0.95))
+    , mRoleUsageAfcDecay(configuration.getValueAs<double>("TransportNetwork/search/options/role-usage/afc-decay",0.95))
+    , mTimelineAfcDecay(configuration.getValueAs<double>("TransportNetwork/search/options/timeline-brancher/afc-decay",0.95))
+    , mSeed(configuration.getValueAs<unsigned int>("TransportNetwork/search/options/portfolio/seed",0))
     , mpCurrentMaster(NULL)
 {
     // FIXME: make sure we use the the same configuration of the ask object
@@ -451,7 +499,7 @@ TransportNetwork::TransportNetwork(const templ::Mission::Ptr& mission, const qxc
     LOG_INFO_S << "TransportNetwork CSP Problem Construction" << std::endl
     << "    requested resources: " << mpMission->getRequestedResources() << std::endl
     << "    intervals: " << mpContext->intervals().size() << std::endl
-    << "    # requirements: " << mResourceRequirements.size() << std::endl;
+    << "    # requirements: " << mResourceRequirements->size() << std::endl;
 
     initializeTemporalConstraintNetwork();
 }
@@ -469,18 +517,70 @@ void TransportNetwork::initializeTemporalConstraintNetwork()
         LOG_WARN_S << "Configuration: no interval overlaps are allowed";
         mTemporalConstraintNetwork.addNoOverlap(mpContext->intervals(), *this, mQualitativeTimepoints);
     }
+    branchTemporalConstraintNetwork();
+}
+
+void TransportNetwork::branchTemporalConstraintNetwork()
+{
     // making sure we get a fully assigned temporal constraint network, i.e.
     // one without gaps before we proceed
-    Gecode::Rnd temporalNetworkRnd;
-    temporalNetworkRnd.hw();
+    Gecode::Rnd temporalNetworkRnd = createRnd();
     Gecode::branch(*this, mQualitativeTimepoints, Gecode::INT_VAR_RND(temporalNetworkRnd), Gecode::INT_VAL_MIN());
     Gecode::branch(*this, &TransportNetwork::doPostTemporalConstraints);
 }
 
+void TransportNetwork::configureAsset(unsigned int asset)
+{
+    // Variations of the afc decay that are used for assets without an
+    // explicit configuration
+    static const std::vector<double> afcDecays = { 0.95, 0.99, 0.9, 0.8, 1.0 };
+
+    const qxcfg::Configuration& configuration = mpContext->configuration();
+    std::stringstream ss;
+    ss << "TransportNetwork/search/options/portfolio/asset-" << asset << "/";
+    std::string prefix = ss.str();
+
+    if(asset != 0)
+    {
+        double afcDecay = afcDecays[asset % afcDecays.size()];
+        mModelUsageAfcDecay = afcDecay;
+        mRoleUsageAfcDecay = afcDecay;
+        mTimelineAfcDecay = afcDecays[(asset + 1) % afcDecays.size()];
+    }
+    mModelUsageAfcDecay = configuration.getValueAs<double>(prefix + "model-usage/afc-decay", mModelUsageAfcDecay);
+    mRoleUsageAfcDecay = configuration.getValueAs<double>(prefix + "role-usage/afc-decay", mRoleUsageAfcDecay);
+    mTimelineAfcDecay = configuration.getValueAs<double>(prefix + "timeline-brancher/afc-decay", mTimelineAfcDecay);
+    if(mSeed != 0)
+    {
+        mSeed = configuration.getValueAs<unsigned int>(prefix + "seed", mSeed + asset);
+    } else {
+        mSeed = configuration.getValueAs<unsigned int>(prefix + "seed", 0);
+    }
+
+    LOG_INFO_S << "Portfolio asset #" << asset << std::endl
+        << "    model-usage/afc-decay: " << mModelUsageAfcDecay << std::endl
+        << "    role-usage/afc-decay: " << mRoleUsageAfcDecay << std::endl
+        << "    timeline-brancher/afc-decay: " << mTimelineAfcDecay << std::endl
+        << "    seed: " << mSeed;
+}
+
+Gecode::Rnd TransportNetwork::createRnd(unsigned int offset) const
+{
+    if(mSeed != 0)
+    {
+        return Gecode::Rnd(mSeed + offset);
+    }
+    Gecode::Rnd rnd;
+    rnd.hw();
+    return rnd;
+}
+
 
 void TransportNetwork::initializeMinMaxConstraints()
 {
-    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements.size());
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::POST_MIN_MAX_CONSTRAINTS);
+
+    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements->size());
 
 
     const IRIList& availableModels = mpMission->getModels();
@@ -490,13 +590,13 @@ void TransportNetwork::initializeMinMaxConstraints()
     // For debugging purposes
     ConstraintMatrix constraintMatrix(availableModels);
     using namespace solvers::temporal;
-    std::vector<FluentTimeResource>::const_iterator fit = mResourceRequirements.begin();
-    for(; fit != mResourceRequirements.end(); ++fit)
+    std::vector<FluentTimeResource>::const_iterator fit = mResourceRequirements->begin();
+    for(; fit != mResourceRequirements->end(); ++fit)
     {
         const FluentTimeResource& fts = *fit;
         // row: index of requirement
         // col: index of model type
-        size_t requirementIndex = fit - mResourceRequirements.begin();
+        size_t requirementIndex = fit - mResourceRequirements->begin();
         for(size_t mi = 0; mi < availableModels.size(); ++mi)
         {
             Gecode::IntVar v = resourceDistribution(mi, requirementIndex);
@@ -539,14 +639,14 @@ void TransportNetwork::initializeMinMaxConstraints()
         }
     }
 
-    std::vector<std::string> rowNames =
-        FluentTimeResource::toQualificationStringList(mResourceRequirements.begin(),
-            mResourceRequirements.end());
-    LOG_INFO_S << constraintMatrix.toString(rowNames);
+    TEMPL_DEBUG_LOG(constraintMatrix.toString(
+                FluentTimeResource::toQualificationStringList(mResourceRequirements->begin(),
+                    mResourceRequirements->end())));
 
-    breakpointStart()
-        << "InitializeMinMax: final constraint matrix: " << constraintMatrix.toString(rowNames) << std::endl;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("InitializeMinMax: final constraint matrix: " <<
+            constraintMatrix.toString(
+                FluentTimeResource::toQualificationStringList(mResourceRequirements->begin(),
+                    mResourceRequirements->end())) << std::endl);
 }
 
 void TransportNetwork::addExtensionalConstraints()
@@ -554,10 +654,10 @@ void TransportNetwork::addExtensionalConstraints()
     size_t availableResourceCount = mpMission->getAvailableResources().size();
     Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage,
             /*width --> col*/ availableResourceCount,
-            /*height --> row*/ mResourceRequirements.size());
+            /*height --> row*/ mResourceRequirements->size());
 
    size_t requirementIndex = 0;
-   for(const FluentTimeResource& ftr: mResourceRequirements)
+   for(const FluentTimeResource& ftr: *mResourceRequirements)
    {
         // Prepare the extensional constraints, i.e. specifying the allowed
         // combinations for each requirement
@@ -568,7 +668,7 @@ void TransportNetwork::addExtensionalConstraints()
             this->fail();
             return;
         }
-        LOG_INFO_S << "Adding extensional constraint:\n" << ftr.toString(4);
+        TEMPL_DEBUG_LOG("Adding extensional constraint:\n" << ftr.toString(4));
 
         // A tuple set is a fully expanded vector describing the cardinality for
         // all available resources
@@ -588,7 +688,7 @@ void TransportNetwork::addExtensionalConstraints()
 
 void TransportNetwork::setUpperBoundForConcurrentRequirements()
 {
-    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements->size());
 
     // - identify overlapping fts, limit resources for these
     std::vector< std::vector<FluentTimeResource> > concurrentRequirements;
@@ -596,7 +696,7 @@ void TransportNetwork::setUpperBoundForConcurrentRequirements()
 
     if(nooverlap)
     {
-        for(const FluentTimeResource& ftr : mResourceRequirements)
+        for(const FluentTimeResource& ftr : *mResourceRequirements)
         {
             concurrentRequirements.push_back( { ftr } );
         }
@@ -604,7 +704,7 @@ void TransportNetwork::setUpperBoundForConcurrentRequirements()
         // Make sure the correct constraints network is used for comparison
         temporal::point_algebra::TimePointComparator tpc(mpQualitativeTemporalConstraintNetwork);
         // Make sure the assignments are within resource bounds for concurrent requirements
-        concurrentRequirements = FluentTimeResource::getMutualExclusive(mResourceRequirements, tpc);
+        concurrentRequirements = FluentTimeResource::getMutualExclusive(*mResourceRequirements, tpc);
     }
 
     const moreorg::ModelPool& modelPool = mpMission->getAvailableResources();
@@ -621,7 +721,7 @@ void TransportNetwork::setUpperBoundForConcurrentRequirements()
             std::vector<FluentTimeResource>::const_iterator fit = concurrentFluents.begin();
             for(; fit != concurrentFluents.end(); ++fit)
             {
-                size_t fluentIdx = FluentTimeResource::getIndex(mResourceRequirements, *fit);
+                size_t fluentIdx = FluentTimeResource::getIndex(*mResourceRequirements, *fit);
                 Gecode::IntVar v = resourceDistribution(mi,fluentIdx);
                 args << v;
             }
@@ -643,8 +743,8 @@ void TransportNetwork::initializeRoleDistributionConstraints()
     bool immobileBoundedRoleUsage = mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/role-usage/immobile/bounded",false);
 
     // Role distribution
-    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements.size());
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements->size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
     {
         Gecode::IntVarArgs mobileModelBounds;
         Gecode::IntVarArgs immobileModelBounds;
@@ -671,11 +771,11 @@ void TransportNetwork::initializeRoleDistributionConstraints()
             uint32_t maxCardinality = modelPool.at(model);
 
             // Enforce bound per requirement
-            for(uint32_t requirementIndex = 0; requirementIndex < mResourceRequirements.size(); ++requirementIndex)
+            for(uint32_t requirementIndex = 0; requirementIndex < mResourceRequirements->size(); ++requirementIndex)
             {
                 Gecode::IntVar modelCount = resourceDistribution(modelIndex,requirementIndex);
                 Gecode::IntVarArgs args;
-                for(uint32_t roleIndex = 0; roleIndex < mRoles.size(); ++roleIndex)
+                for(uint32_t roleIndex = 0; roleIndex < mpContext->roles().size(); ++roleIndex)
                 {
                     if(isRoleForModel(roleIndex, modelIndex))
                     {
@@ -904,20 +1004,20 @@ void TransportNetwork::applyAccessConstraints(ListOfAdjacencyLists& timelines,
 void TransportNetwork::enforceUnaryResourceUsage()
 {
     // Role distribution
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
 
     // Set of available models: mModelPool
     // Make sure the assignments are within resource bounds for concurrent requirements
     temporal::point_algebra::TimePointComparator tpc(mpQualitativeTemporalConstraintNetwork);
     std::vector< std::vector<FluentTimeResource> > concurrentRequirements =
-        FluentTimeResource::getMutualExclusive(mResourceRequirements, tpc);
+        FluentTimeResource::getMutualExclusive(*mResourceRequirements, tpc);
 
     for(const FluentTimeResource::List& concurrentFluents : concurrentRequirements)
     {
-        if(mRoles.size() < concurrentFluents.size())
+        if(mpContext->roles().size() < concurrentFluents.size())
         {
             std::stringstream ss;
-            ss << "The number for agent instances (" << mRoles.size() << ") is too low,"
+            ss << "The number for agent instances (" << mpContext->roles().size() << ") is too low,"
                << " to resolve the concurrent requirements ("
                << concurrentFluents.size() << ") " << std::endl;
 
@@ -925,12 +1025,12 @@ void TransportNetwork::enforceUnaryResourceUsage()
                         + ss.str());
         }
 
-        for(size_t roleIndex = 0; roleIndex < mRoles.size(); ++roleIndex)
+        for(size_t roleIndex = 0; roleIndex < mpContext->roles().size(); ++roleIndex)
         {
             Gecode::IntVarArgs args;
             for(const FluentTimeResource& fts : concurrentFluents)
             {
-                size_t row = FluentTimeResource::getIndex(mResourceRequirements, fts);
+                size_t row = FluentTimeResource::getIndex(*mResourceRequirements, fts);
                 Gecode::IntVar v = roleDistribution(roleIndex, row);
                 args << v;
             }
@@ -943,7 +1043,7 @@ void TransportNetwork::enforceUnaryResourceUsage()
 
 Gecode::Symmetries TransportNetwork::identifySymmetries()
 {
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
 
     Gecode::Symmetries symmetries;
     // define interchangeable columns for roles of the same model type
@@ -953,9 +1053,9 @@ Gecode::Symmetries TransportNetwork::identifySymmetries()
         Gecode::IntVarArgs sameModelColumns;
         for(int c = 0; c < roleDistribution.width(); ++c)
         {
-            if( mRoles[c].getModel() == currentModel)
+            if( mpContext->roles()[c].getModel() == currentModel)
             {
-                LOG_DEBUG_S << "Adding column of " << mRoles[c].toString() << " for symmetry";
+                LOG_DEBUG_S << "Adding column of " << mpContext->roles()[c].toString() << " for symmetry";
                 sameModelColumns << roleDistribution.col(c);
             }
         }
@@ -972,7 +1072,6 @@ TransportNetwork::TransportNetwork(TransportNetwork& other)
     , mTemporalConstraintNetwork(other.mTemporalConstraintNetwork)
     , mTimepoints(other.mTimepoints)
     , mpQualitativeTemporalConstraintNetwork(other.mpQualitativeTemporalConstraintNetwork)
-    , mRoles(other.mRoles)
     , mActiveRoles(other.mActiveRoles)
     , mActiveRoleList(other.mActiveRoleList)
     , mMinRequiredTimelines(other.mMinRequiredTimelines)
@@ -981,17 +1080,21 @@ TransportNetwork::TransportNetwork(TransportNetwork& other)
     , mMinCostFlowFlaws(other.mMinCostFlowFlaws)
     , mFlawResolution(other.mFlawResolution)
     , mUseMasterSlave(other.mUseMasterSlave)
+    , mModelUsageAfcDecay(other.mModelUsageAfcDecay)
+    , mRoleUsageAfcDecay(other.mRoleUsageAfcDecay)
+    , mTimelineAfcDecay(other.mTimelineAfcDecay)
+    , mSeed(other.mSeed)
     , mpCurrentMaster(other.mpCurrentMaster)
+    , mpMinCostFlowPipeline(other.mpMinCostFlowPipeline)
+    , mpPendingMinCostFlow(other.mpPendingMinCostFlow)
     , mSolutionAnalysis(other.mSolutionAnalysis)
 {
-    breakpointStart()
-        << "Space " << std::endl
-        << "    size: " << sizeof(TransportNetwork) << std::endl
-        << "Mission: " << std::endl
-        << "    use count: " << mpMission.use_count() << std::endl
-        << "QualitativeTemporalConstraintNetwork" << std::endl
-        << "    use count: " << mpQualitativeTemporalConstraintNetwork.use_count() << std::endl;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("Space " << std::endl
+            << "    size: " << sizeof(TransportNetwork) << std::endl
+            << "Mission: " << std::endl
+            << "    use count: " << mpMission.use_count() << std::endl
+            << "QualitativeTemporalConstraintNetwork" << std::endl
+            << "    use count: " << mpQualitativeTemporalConstraintNetwork.use_count() << std::endl);
 
     assert( mpMission->getOrganizationModel() );
     assert(!mpContext->intervals().empty());
@@ -1016,7 +1119,10 @@ Gecode::Space* TransportNetwork::copy()
     return new TransportNetwork(*this);
 }
 
-std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mission::Ptr& mission, uint32_t minNumberOfSolutions, const qxcfg::Configuration& configuration)
+std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mission::Ptr& mission, uint32_t minNumberOfSolutions,
+        const qxcfg::Configuration& configuration,
+        const StoppingCriteria& stoppingCriteria,
+        const SolutionCallback& solutionCallback)
 {
     SolutionList solutions;
     mission->prepareForPlanning();
@@ -1025,7 +1131,7 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
     assert(!mission->getTimeIntervals().empty());
 
     /// Allow to log the final results into a csv file
-    CSVLogger csvLogger({"session",
+    CSVLogger::ColumnDescription columns = {"session",
             "alpha",
             "beta",
             "sigma",
@@ -1048,11 +1154,40 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
             "restart",
             "nogood",
             "flaws",
-            "cost"});
+            "cost",
+            "lp-cache-hit",
+            "lp-cache-miss",
+            "lp-cache-eviction",
+            "lp-cache-size",
+            "lp-persistent-cache-hit",
+            "lp-persistent-cache-miss",
+            "lp-runs",
+            "lp-flow-graph-time",
+            "lp-problem-and-solve-time",
+            "lp-model-time",
+            "lp-solve-time"};
+    // Cumulative time and number of executions per phase
+    for(size_t i = 0; i < templ::utils::PhaseTimer::PHASE_END; ++i)
+    {
+        const std::string& phase = templ::utils::PhaseTimer::PhaseTxt[static_cast<templ::utils::PhaseTimer::Phase>(i)];
+        columns.push_back("time-" + phase);
+        columns.push_back("count-" + phase);
+    }
+    CSVLogger csvLogger(columns);
+
+    templ::utils::PhaseTimer::setEnabled( configuration.getValueAs<bool>("TransportNetwork/search/options/phase-timers",true) );
+    templ::utils::PhaseTimer::reset();
 
     std::string baseDir = configuration.getValue("TransportNetwork/logging/basedir","/tmp");
     mission->getLogger()->setBaseDirectory(baseDir);
 
+    std::string traceFilename;
+    if(configuration.getValueAs<bool>("TransportNetwork/search/options/trace",false))
+    {
+        traceFilename = mission->getLogger()->getBasePath() + "trace.json";
+    }
+    templ::utils::Tracer::Recording traceRecording(traceFilename);
+
     if( configuration.getValueAs<bool>("TransportNetwork/use-transfer-location"))
     {
         mission->enableTransferLocation();
@@ -1060,6 +1195,10 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
 
     /// Check if interactive mode should be used during the solution process
     TransportNetwork::msInteractive = configuration.getValueAs<bool>("TransportNetwork/search/interactive",false);
+    if(TransportNetwork::msInteractive && !TEMPL_DEBUG_TRACE_ENABLED)
+    {
+        LOG_WARN_S << "Configuration: interactive mode requires a build with DEBUG_TRACE -- ignoring";
+    }
 
     TransportNetwork* distribution = new TransportNetwork(mission, configuration);
     distribution->mUseMasterSlave = configuration.getValueAs<bool>("TransportNetwork/search/options/master-slave",false);
@@ -1082,6 +1221,42 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
     int nogoods_limit = distribution->mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/nogoods_limit",128);
     int epochTimeoutInS = distribution->mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/epoch_timeout_in_s",180000);
     int abortTimeoutInS = distribution->mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/total_timeout_in_s",600000);
+    int assets = distribution->mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/portfolio/assets",1);
+    msMinCostFlowSolutions.setMaxSize( distribution->mpContext->configuration().getValueAs<size_t>("TransportNetwork/search/options/lp/cache-size",1000) );
+
+    std::string persistentCacheFile = distribution->mpContext->configuration().getValue("TransportNetwork/search/options/lp/persistent-cache/file","");
+    if(persistentCacheFile.empty())
+    {
+        msPersistentMinCostFlowSolutions.reset();
+    } else {
+        if(!msPersistentMinCostFlowSolutions || msPersistentMinCostFlowSolutions->getFilename() != persistentCacheFile)
+        {
+            size_t maxSizeInMB = distribution->mpContext->configuration().getValueAs<size_t>("TransportNetwork/search/options/lp/persistent-cache/max-size-in-mb",256);
+            msPersistentMinCostFlowSolutions = make_shared<transshipment::PersistentMinCostFlowCache>(persistentCacheFile, maxSizeInMB*1024*1024);
+        }
+    }
+
+    if(assets > 1 && distribution->mUseMasterSlave)
+    {
+        LOG_WARN_S << "Configuration: master-slave is not supported in portfolio mode -- disabling master-slave";
+        distribution->mUseMasterSlave = false;
+    }
+
+    // Pipelined mode: the search enumerates candidate solutions, while the
+    // min cost flow is evaluated by a pool of workers
+    size_t asyncQueueSize = 0;
+    if(distribution->mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/lp/async/enabled",false))
+    {
+        if(distribution->mUseMasterSlave)
+        {
+            LOG_WARN_S << "Configuration: asynchronous LP evaluation is not supported with master-slave -- using synchronous evaluation";
+        } else {
+            size_t workers = distribution->mpContext->configuration().getValueAs<size_t>("TransportNetwork/search/options/lp/async/workers",2);
+            asyncQueueSize = distribution->mpContext->configuration().getValueAs<size_t>("TransportNetwork/search/options/lp/async/queue-size",4);
+            distribution->mpMinCostFlowPipeline = make_shared<transshipment::MinCostFlowPipeline>(workers, asyncQueueSize);
+            asyncQueueSize = distribution->mpMinCostFlowPipeline->getMaxQueueSize();
+        }
+    }
 
     Gecode::Search::Options options;
     options.threads = threads;
@@ -1093,9 +1268,27 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
     options.c_d = distribution->mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/computation_distance", options.c_d);
     // adaptive recomputation distance
     options.a_d = distribution->mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/adaptive_computation_distance", options.a_d);
+    if(assets > 1)
+    {
+        // MPG 9.4 Portfolio search: the available threads are distributed
+        // among the assets
+        options.assets = assets;
+    }
     // default failure cutoff
     // options.fail
 
+    // Criteria to terminate the search early, e.g., once a good enough
+    // solution has been found
+    StoppingCriteria criteria = StoppingCriteria::fromConfiguration(distribution->mpContext->configuration());
+    for(const StoppingCriteria::Criterion::Ptr& criterion : stoppingCriteria.getCriteria())
+    {
+        criteria.add(criterion);
+    }
+    criteria.add( StoppingCriteria::wallTime(abortTimeoutInS) );
+    criteria.start();
+    // statistics of all previous epochs
+    Gecode::Search::Statistics searchStatistics;
+
     base::Time allStart = base::Time::now();
     bool stop = false;
     int numberOfEpochs = 0;
@@ -1106,29 +1299,88 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
         // when the corresponding number of failure has been reached
         // restart and continue
         options.cutoff = Gecode::Search::Cutoff::geometric(cutoff,2);
-        options.stop = Gecode::Search::Stop::time(epochTimeoutInS*1000.0);
-        Gecode::RBS< TransportNetwork, Gecode::DFS > searchEngine(distribution, options);
+        // the search stop has to outlive the search engine
+        shared_ptr<SearchStop> searchStop = make_shared<SearchStop>(criteria, epochTimeoutInS*1000.0, searchStatistics);
+        options.stop = searchStop.get();
+        SearchEnginePtr searchEngine;
+        if(assets > 1)
+        {
+            // Each asset gets its branchers posted through slave(), and the
+            // first solution of any asset is returned
+            searchEngine = SearchEnginePtr(new Gecode::PBS< TransportNetwork, Gecode::DFS >(distribution, options));
+        } else {
+            searchEngine = SearchEnginePtr(new Gecode::RBS< TransportNetwork, Gecode::DFS >(distribution, options));
+        }
 
         //Gecode::TemplRBS< TransportNetwork, Gecode::DFS > searchEngine(distribution, options);
 
         TransportNetwork* best = NULL;
         size_t solutionCount = 0;
-        int i = 0;
         base::Time start = base::Time::now();
         base::Time allElapsed;
         base::Time elapsed;
         numeric::Stats<double> stats;
-        while(TransportNetwork* current = searchEngine.next())
+        // Candidate solutions waiting for the asynchronous min cost flow
+        std::deque<TransportNetwork*> pendingSolutions;
+        bool searchExhausted = false;
+        while(true)
         {
+            TransportNetwork* current = NULL;
+            if(!searchExhausted)
+            {
+                current = searchEngine->next();
+                if(!current)
+                {
+                    searchExhausted = true;
+                } else if(distribution->mpMinCostFlowPipeline)
+                {
+                    pendingSolutions.push_back(current);
+                    current = NULL;
+                }
+            }
+
+            if(!pendingSolutions.empty())
+            {
+                // Complete the oldest candidate once its evaluation is
+                // available, or when the search can no longer run ahead
+                if(searchExhausted
+                        || pendingSolutions.size() > asyncQueueSize
+                        || pendingSolutions.front()->isMinCostFlowReady())
+                {
+                    current = pendingSolutions.front();
+                    pendingSolutions.pop_front();
+                    if(!current->completeMinCostFlow())
+                    {
+                        delete current;
+                        continue;
+                    }
+                }
+            }
+
+            if(!current)
+            {
+                if(searchExhausted && pendingSolutions.empty())
+                {
+                    break;
+                }
+                continue;
+            }
+
             allElapsed = (base::Time::now() - allStart);
             elapsed = (base::Time::now() - start);
             stats.update(elapsed.toSeconds());
             delete best;
             best = current;
 
+            templ::utils::Tracer::instant("solution", "search");
+
+            // Deliver the solution before logging and saving
+            Solution solution = current->getSolution();
+            bool continueSearch = !solutionCallback || solutionCallback(solution);
+
             using namespace moreorg;
 
-            LOG_INFO_S << "#" << i << "/" << minNumberOfSolutions << " solution found:" << current->toString();
+            TEMPL_DEBUG_LOG("#" << solutionCount << "/" << minNumberOfSolutions << " solution found:" << current->toString());
             std::cout << "Solution found:" << std::endl;
             std::cout << "    # session id " << current->mpMission->getLogger()->getSessionId() << std::endl;
             std::cout << "    # flaws: " << current->mNumberOfFlaws.val() << std::endl;
@@ -1136,29 +1388,53 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
             std::cout << std::endl;
 
             csvLogger.addToRow(current->mpMission->getLogger()->getSessionId(),"session");
-            csvLogger.addToRow(current->mSolutionAnalysis.getAlpha(), "alpha");
-            csvLogger.addToRow(current->mSolutionAnalysis.getBeta(), "beta");
-            csvLogger.addToRow(current->mSolutionAnalysis.getSigma(), "sigma");
-            csvLogger.addToRow(current->mSolutionAnalysis.getEfficacy(), "efficacy");
-            csvLogger.addToRow(current->mSolutionAnalysis.getEfficiency(), "efficiency");
-            csvLogger.addToRow(current->mSolutionAnalysis.getSafety(), "safety");
-            csvLogger.addToRow(current->mSolutionAnalysis.getTimeHorizon(), "timehorizon");
-            csvLogger.addToRow(current->mSolutionAnalysis.getTravelledDistance(),"travel-distance");
-            csvLogger.addToRow(current->mSolutionAnalysis.getReconfigurationCost(),"reconfiguration-cost");
+            csvLogger.addToRow(current->mSolutionAnalysis->getAlpha(), "alpha");
+            csvLogger.addToRow(current->mSolutionAnalysis->getBeta(), "beta");
+            csvLogger.addToRow(current->mSolutionAnalysis->getSigma(), "sigma");
+            csvLogger.addToRow(current->mSolutionAnalysis->getEfficacy(), "efficacy");
+            csvLogger.addToRow(current->mSolutionAnalysis->getEfficiency(), "efficiency");
+            csvLogger.addToRow(current->mSolutionAnalysis->getSafety(), "safety");
+            csvLogger.addToRow(current->mSolutionAnalysis->getTimeHorizon(), "timehorizon");
+            csvLogger.addToRow(current->mSolutionAnalysis->getTravelledDistance(),"travel-distance");
+            csvLogger.addToRow(current->mSolutionAnalysis->getReconfigurationCost(),"reconfiguration-cost");
             csvLogger.addToRow(allElapsed.toSeconds(), "overall-runtime");
             csvLogger.addToRow(elapsed.toSeconds(), "solution-runtime");
             csvLogger.addToRow(stats.mean(), "solution-runtime-mean");
             csvLogger.addToRow(stats.stdev(), "solution-runtime-stdev");
-            csvLogger.addToRow(searchEngine.stopped(), "solution-stopped");
-            csvLogger.addToRow(searchEngine.statistics().propagate, "propagate");
-            csvLogger.addToRow(searchEngine.statistics().fail, "fail");
-            csvLogger.addToRow(searchEngine.statistics().node, "node");
-            csvLogger.addToRow(searchEngine.statistics().depth, "depth");
-            csvLogger.addToRow(searchEngine.statistics().restart, "restart");
-            csvLogger.addToRow(searchEngine.statistics().nogood, "nogood");
+            csvLogger.addToRow(searchEngine->stopped(), "solution-stopped");
+            csvLogger.addToRow(searchEngine->statistics().propagate, "propagate");
+            csvLogger.addToRow(searchEngine->statistics().fail, "fail");
+            csvLogger.addToRow(searchEngine->statistics().node, "node");
+            csvLogger.addToRow(searchEngine->statistics().depth, "depth");
+            csvLogger.addToRow(searchEngine->statistics().restart, "restart");
+            csvLogger.addToRow(searchEngine->statistics().nogood, "nogood");
             csvLogger.addToRow(1.0, "solution-found");
-            csvLogger.addToRow(best->mMinCostFlowFlaws.size(), "flaws");
+            csvLogger.addToRow(best->mMinCostFlowFlaws->size(), "flaws");
             csvLogger.addToRow(best->cost().val(), "cost");
+            transshipment::MinCostFlowCache::Statistics cacheStatistics = msMinCostFlowSolutions.getStatistics();
+            csvLogger.addToRow(cacheStatistics.hits, "lp-cache-hit");
+            csvLogger.addToRow(cacheStatistics.misses, "lp-cache-miss");
+            csvLogger.addToRow(cacheStatistics.evictions, "lp-cache-eviction");
+            csvLogger.addToRow(cacheStatistics.size, "lp-cache-size");
+            transshipment::PersistentMinCostFlowCache::Statistics persistentCacheStatistics = { 0, 0, 0, 0, 0 };
+            if(msPersistentMinCostFlowSolutions)
+            {
+                persistentCacheStatistics = msPersistentMinCostFlowSolutions->getStatistics();
+            }
+            csvLogger.addToRow(persistentCacheStatistics.hits, "lp-persistent-cache-hit");
+            csvLogger.addToRow(persistentCacheStatistics.misses, "lp-persistent-cache-miss");
+            csvLogger.addToRow(current->mpContext->getNumberOfLPRuns(), "lp-runs");
+            csvLogger.addToRow(current->mpContext->getLPFlowGraphTime(), "lp-flow-graph-time");
+            csvLogger.addToRow(current->mpContext->getLPProblemAndSolveTime(), "lp-problem-and-solve-time");
+            csvLogger.addToRow(current->mpContext->getLPModelTime(), "lp-model-time");
+            csvLogger.addToRow(current->mpContext->getLPSolveTime(), "lp-solve-time");
+            for(size_t p = 0; p < templ::utils::PhaseTimer::PHASE_END; ++p)
+            {
+                templ::utils::PhaseTimer::Phase phase = static_cast<templ::utils::PhaseTimer::Phase>(p);
+                templ::utils::PhaseTimer::Statistics phaseStatistics = templ::utils::PhaseTimer::getStatistics(phase);
+                csvLogger.addToRow(phaseStatistics.totalInS, "time-" + templ::utils::PhaseTimer::PhaseTxt[phase]);
+                csvLogger.addToRow(phaseStatistics.count, "count-" + templ::utils::PhaseTimer::PhaseTxt[phase]);
+            }
             csvLogger.commitRow();
 
             std::string filename =
@@ -1166,12 +1442,18 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
             std::cout << "Saving stats in: " << filename << std::endl;
             csvLogger.save(filename);
 
-            Solution solution = current->getSolution();
             saveSolution(solution, mission);
             // TODO: use serialization to filesystem for later retrieval
             solutions.push_back(solution);
             ++solutionCount;
 
+            if(!continueSearch)
+            {
+                LOG_INFO_S << "Search stopped by solution callback";
+                stop = true;
+                break;
+            }
+
             if(minNumberOfSolutions >= 0)
             {
                 if(solutionCount >= minNumberOfSolutions)
@@ -1182,13 +1464,26 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
                 }
             }
 
+            criteria.updateSolution(current->mCost.val(), current->mMinCostFlowFlaws->size());
+            if(criteria.isMet())
+            {
+                LOG_INFO_S << "Stopping criteria met: " << criteria.getReason();
+                stop = true;
+                break;
+            }
+
             current->mpMission->getLogger()->incrementSessionId();
             start = base::Time::now();
         }
 
+        for(TransportNetwork* pending : pendingSolutions)
+        {
+            delete pending;
+        }
+
         std::cout << "Solution Search (epoch: " << numberOfEpochs << ")" << std::endl;
         std::cout << "    was stopped (e.g. timeout): ";
-        if(searchEngine.stopped())
+        if(searchEngine->stopped())
         {
             std::cout << " yes" << std::endl;
         } else {
@@ -1197,24 +1492,65 @@ std::vector<TransportNetwork::Solution> TransportNetwork::solve(const templ::Mis
         std::cout << "    found # solutions: " << solutions.size() << std::endl;
         std::cout << "    minimum # requested: " << minNumberOfSolutions << std::endl;
 
-        if((base::Time::now() - allStart).toSeconds() >= abortTimeoutInS)
+        searchStatistics += searchEngine->statistics();
+        if(criteria.isMet())
         {
+            std::cout << "    stopping criteria met: " << criteria.getReason() << std::endl;
             stop = true;
         }
     } // end while all
 
+    if(templ::utils::PhaseTimer::isEnabled())
+    {
+        std::string filename = mission->getLogger()->getBasePath() + "phase-timings.json";
+        try {
+            templ::utils::PhaseTimer::saveJSON(filename);
+            std::cout << "Saved phase timings in: " << filename << std::endl;
+        } catch(const std::runtime_error& e)
+        {
+            LOG_WARN_S << e.what();
+        }
+    }
+
+    if(!traceFilename.empty())
+    {
+        try {
+            traceRecording.stop();
+            std::cout << "Saved trace in: " << traceFilename << std::endl;
+        } catch(const std::runtime_error& e)
+        {
+            LOG_WARN_S << e.what();
+        }
+    }
+
+    // Flow graphs refer to the mission and are only valid for this run
+    distribution->mpContext->clearIncrementalFlowGraphs();
     delete distribution;
     return solutions;
 }
 
-solvers::Session::Ptr TransportNetwork::run(const templ::Mission::Ptr& mission, uint32_t minNumberOfSolutions, const qxcfg::Configuration& configuration)
+void TransportNetwork::run(const solvers::Session::Ptr& session, uint32_t minNumberOfSolutions, const qxcfg::Configuration& configuration)
 {
-    Session::Ptr session = make_shared<Session>(mission);
-    SolutionList solutionList = TransportNetwork::solve(mission, minNumberOfSolutions, configuration);
+    const Mission::Ptr& mission = session->getMission();
 
-    solvers::Solution::List solutions;
-    session->setSolutions(solutions);
-    return session;
+    // Stop the search engine when the stop is requested while searching
+    StoppingCriteria stoppingCriteria;
+    stoppingCriteria.add( make_shared<StopRequested>(session) );
+
+    try {
+        TransportNetwork::solve(mission, minNumberOfSolutions, configuration,
+                stoppingCriteria,
+                [&session, &mission](const Solution& solution)
+                {
+                    return session->addSolution( solvers::Solution(solution.getMinCostFlowSolution(),
+                                mission->getOrganizationModel()) );
+                });
+    } catch(...)
+    {
+        session->setFinished();
+        throw;
+    }
+    session->setFinished();
 }
 
 void TransportNetwork::addConstraint(const Constraint::Ptr& constraint, TransportNetwork& network)
@@ -1227,13 +1563,13 @@ Constraint::PtrList TransportNetwork::getAssignmentsAsConstraints() const
 {
     using namespace moreorg;
     Constraint::PtrList constraints;
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
 
 
     // Min resource model constraints
-    for(size_t f = 0; f < mResourceRequirements.size(); ++f)
+    for(size_t f = 0; f < mResourceRequirements->size(); ++f)
     {
-        const FluentTimeResource& ftr = mResourceRequirements[f];
+        const FluentTimeResource& ftr = (*mResourceRequirements)[f];
 
         ModelPool modelPool = currentMinModelAssignment(ftr);
         for(const ModelPool::value_type& v : modelPool)
@@ -1248,15 +1584,15 @@ Constraint::PtrList TransportNetwork::getAssignmentsAsConstraints() const
         }
     }
 
-    for(size_t r = 0; r < mRoles.size(); ++r)
+    for(size_t r = 0; r < mpContext->roles().size(); ++r)
     {
         FluentTimeResource::List presentAt;
-        for(size_t f = 0; f < mResourceRequirements.size(); ++f)
+        for(size_t f = 0; f < mResourceRequirements->size(); ++f)
         {
             Gecode::IntVar var = roleDistribution(r,f);
             if(var.assigned() && var.val() == 1)
             {
-                presentAt.push_back( mResourceRequirements[f] );
+                presentAt.push_back( (*mResourceRequirements)[f] );
             }
         }
 
@@ -1264,7 +1600,7 @@ Constraint::PtrList TransportNetwork::getAssignmentsAsConstraints() const
         {
             constraints::ModelConstraint::Ptr constraint = make_shared<constraints::ModelConstraint>(
                     constraints::ModelConstraint::MIN_EQUAL,
-                    mRoles[r].getModel(),
+                    mpContext->roles()[r].getModel(),
                     MissionConstraintManager::mapToSpaceTime( presentAt ),
                     1
                     );
@@ -1346,23 +1682,23 @@ size_t TransportNetwork::getResourceModelMaxCardinality(size_t index) const
 
 bool TransportNetwork::isRoleForModel(uint32_t roleIndex, uint32_t modelIndex) const
 {
-    return mRoles.at(roleIndex).getModel() == mpMission->getModels().at(modelIndex);
+    return mpContext->roles().at(roleIndex).getModel() == mpMission->getModels().at(modelIndex);
 }
 
 std::vector<uint32_t> TransportNetwork::computeActiveRoles() const
 {
     std::vector<uint32_t> activeRoles;
     // Identify active roles
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
-    for(size_t r = 0; r < mRoles.size(); ++r)
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
+    for(size_t r = 0; r < mpContext->roles().size(); ++r)
     {
         size_t requirementCount = 0;
-        for(size_t i = 0; i < mResourceRequirements.size(); ++i)
+        for(size_t i = 0; i < mResourceRequirements->size(); ++i)
         {
             Gecode::IntVar var = roleDistribution(r,i);
             if(!var.assigned())
             {
-                throw std::runtime_error("templ::solvers::csp::TransportNetwork::postRoleAssignments: value has not been assigned for role: '" + mRoles[r].toString() + "'");
+                throw std::runtime_error("templ::solvers::csp::TransportNetwork::postRoleAssignments: value has not been assigned for role: '" + mpContext->roles()[r].toString() + "'");
             }
             Gecode::IntVarValues v(var);
             if(v.val() == 1)
@@ -1385,16 +1721,16 @@ std::vector<uint32_t> TransportNetwork::computeActiveRoles() const
 moreorg::ModelPool TransportNetwork::currentMinModelAssignment(const FluentTimeResource& ftr) const
 {
     moreorg::ModelPool modelPool;
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
 
-    size_t ftrIdx = FluentTimeResource::getIndex(mResourceRequirements, ftr);
+    size_t ftrIdx = FluentTimeResource::getIndex(*mResourceRequirements, ftr);
 
-    for(size_t r = 0; r < mRoles.size(); ++r)
+    for(size_t r = 0; r < mpContext->roles().size(); ++r)
     {
         Gecode::IntVar var = roleDistribution(r,ftrIdx);
         if(var.assigned() && var.val() == 1)
         {
-            modelPool[ mRoles[r].getModel() ] += 1;
+            modelPool[ mpContext->roles()[r].getModel() ] += 1;
         }
     }
     return modelPool;
@@ -1407,40 +1743,40 @@ void TransportNetwork::doPostTemporalConstraints(Gecode::Space& home)
 
 void TransportNetwork::postTemporalConstraints()
 {
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::POST_TEMPORAL_CONSTRAINTS);
+
     (void) status();
     // Update temporal constraint network after the solution has been computed
     mpQualitativeTemporalConstraintNetwork = mTemporalConstraintNetwork.translate(mQualitativeTimepoints);
     temporal::point_algebra::TimePointComparator tcp(mpQualitativeTemporalConstraintNetwork);
 
     // Sort the timepoints according
-    TemporalConstraintNetworkBase::sort(*mpQualitativeTemporalConstraintNetwork, mTimepoints);
+    TemporalConstraintNetworkBase::sort(*mpQualitativeTemporalConstraintNetwork, mTimepoints.write());
 
     mResourceRequirements = Mission::getResourceRequirements(mpMission);
-    if(mResourceRequirements.empty())
+    if(mResourceRequirements->empty())
     {
         throw std::invalid_argument("templ::solvers::csp::TransportNetwork: no resource requirements given");
     }
-    breakpointStart()
-        << "Requirements:" << std::endl
-        << FluentTimeResource::toString(mResourceRequirements, 4)
-        << "Timepoints: " << mTimepoints << std::endl
-        << mQualitativeTimepoints << std::endl;
-    breakpointEnd();
+    TEMPL_BREAKPOINT("Requirements:" << std::endl
+            << FluentTimeResource::toString(*mResourceRequirements, 4)
+            << "Timepoints: " << *mTimepoints << std::endl
+            << mQualitativeTimepoints << std::endl);
 
     // update timepoint comparator for intervals
-    FluentTimeResource::updateIndices(mResourceRequirements,
+    FluentTimeResource::updateIndices(mResourceRequirements.write(),
             mpContext->locations());
 
     mModelUsage = Gecode::IntVarArray(*this,
             /*# of models*/ mpMission->getAvailableResources().size()*
-            /*# of fluent time services*/mResourceRequirements.size(), 0,
+            /*# of fluent time services*/mResourceRequirements->size(), 0,
             mpMission->getAvailableResources().getMaxResourceCount());
 
     mRoleUsage = Gecode::IntVarArray(*this,
-            /*width --> col */ mpMission->getRoles().size()* /*height --> row*/ mResourceRequirements.size(),
+            /*width --> col */ mpMission->getRoles().size()* /*height --> row*/ mResourceRequirements->size(),
             0, 1);// Domain 0,1 to represent activation
 
-    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage, /*width --> col*/ mpMission->getAvailableResources().size(), /*height --> row*/ mResourceRequirements->size());
 
     // Limit roles to resource availability
     initializeRoleDistributionConstraints();
@@ -1464,13 +1800,11 @@ void TransportNetwork::postTemporalConstraints()
     Gecode::branch(*this, &TransportNetwork::doPostExtensionalConstraints);
 
     Gecode::IntAFC modelUsageAfc(*this, mModelUsage, 0.99);
-    double modelAfcDecay = mpContext->configuration().getValueAs<double>("TransportNetwork/search/options/model-usage/afc-decay",0.95);
-    modelUsageAfc.decay(*this, modelAfcDecay);
+    modelUsageAfc.decay(*this, mModelUsageAfcDecay);
     branch(*this, mModelUsage, Gecode::INT_VAR_AFC_MIN(modelUsageAfc), Gecode::INT_VAL_SPLIT_MIN());
     //Gecode::Gist::stopBranch(*this);
 
-    Gecode::Rnd modelUsageRnd;
-    modelUsageRnd.hw();
+    Gecode::Rnd modelUsageRnd = createRnd(1);
     branch(*this, mModelUsage, Gecode::INT_VAR_AFC_MIN(modelUsageAfc), Gecode::INT_VAL_RND(modelUsageRnd));
 
     branch(*this, mModelUsage, Gecode::tiebreak(Gecode::INT_VAR_DEGREE_MAX(),
@@ -1490,12 +1824,10 @@ void TransportNetwork::postTemporalConstraints()
     //branch(*this, mRoleUsage, Gecode::INT_VAR_MIN_MIN(), Gecode::INT_VAL_MIN(), symmetries);
 
     Gecode::IntAFC roleUsageAfc(*this, mRoleUsage, 0.99);
-    double roleAfcDecay = mpContext->configuration().getValueAs<double>("TransportNetwork/search/options/role-usage/afc-decay",0.95);
-    roleUsageAfc.decay(*this, roleAfcDecay);
+    roleUsageAfc.decay(*this, mRoleUsageAfcDecay);
     //branch(*this, mRoleUsage, Gecode::INT_VAR_AFC_MIN(roleUsageAfc), Gecode::INT_VAL_SPLIT_MIN());
 
-    Gecode::Rnd rnd;
-    rnd.hw();
+    Gecode::Rnd rnd = createRnd(2);
     branch(*this, mRoleUsage, Gecode::INT_VAR_AFC_MIN(roleUsageAfc), Gecode::INT_VAL_RND(rnd), symmetries);
     branch(*this, mRoleUsage, Gecode::INT_VAR_RND(rnd), Gecode::INT_VAL_RND(rnd), symmetries);
     branch(*this, mRoleUsage, Gecode::tiebreak(Gecode::INT_VAR_DEGREE_MAX(),
@@ -1543,13 +1875,15 @@ void TransportNetwork::doPostRoleAssignments(Gecode::Space& home)
 
 void TransportNetwork::postRoleAssignments()
 {
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::POST_ROLE_ASSIGNMENTS);
+
     (void) status();
 
-    LOG_WARN_S << "Posting Role Assignments: request status" << std::endl
+    TEMPL_DEBUG_LOG("Posting Role Assignments: request status" << std::endl
         << modelUsageToString() << std::endl
-        << roleUsageToString();
+        << roleUsageToString());
 
-    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mRoles.size(), /*height --> row*/ mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> roleDistribution(mRoleUsage, /*width --> col*/ mpContext->roles().size(), /*height --> row*/ mResourceRequirements->size());
 
     //#############################################
     // construct timelines
@@ -1561,16 +1895,16 @@ void TransportNetwork::postRoleAssignments()
     // 4: l0-t2: {..}
     // ...
     size_t numberOfFluents = mpContext->locations().size();
-    size_t numberOfTimepoints = mTimepoints.size();
+    size_t numberOfTimepoints = mTimepoints->size();
     size_t locationTimeSize = numberOfFluents*numberOfTimepoints;
 
     mActiveRoles = computeActiveRoles();
 
-    LOG_INFO_S << std::endl
-        << mTimepoints << std::endl
-        << symbols::constants::Location::toString(mpContext->locations());
+    TEMPL_DEBUG_LOG(std::endl
+        << *mTimepoints << std::endl
+        << symbols::constants::Location::toString(mpContext->locations()));
 
-    if(mActiveRoles.empty())
+    if(mActiveRoles->empty())
     {
         this->fail();
         return;
@@ -1579,11 +1913,11 @@ void TransportNetwork::postRoleAssignments()
     assert(mTimelines.empty());
 
     Role::List activeRoles;
-    std::vector<uint32_t>::const_iterator rit = mActiveRoles.begin();
-    for(; rit != mActiveRoles.end(); ++rit)
+    std::vector<uint32_t>::const_iterator rit = mActiveRoles->begin();
+    for(; rit != mActiveRoles->end(); ++rit)
     {
         uint32_t roleIndex = *rit;
-        const Role& role = mRoles[roleIndex];
+        const Role& role = mpContext->roles()[roleIndex];
         activeRoles.push_back(role);
 
         // A timeline describes the transitions in space time for a given role
@@ -1634,7 +1968,7 @@ void TransportNetwork::postRoleAssignments()
 
         // Link the edge activation to the role requirement, i.e. make sure that
         // for each requirement the interval is 'activated'
-        for(uint32_t requirementIndex = 0; requirementIndex < mResourceRequirements.size(); ++requirementIndex)
+        for(uint32_t requirementIndex = 0; requirementIndex < mResourceRequirements->size(); ++requirementIndex)
         {
             // Check if the current role (identified by roleIndex) is required to fulfil the
             // requirement
@@ -1648,7 +1982,7 @@ void TransportNetwork::postRoleAssignments()
             // then the assigned value is one
             if(var.val() == 1)
             {
-                const FluentTimeResource& fts = mResourceRequirements[requirementIndex];
+                const FluentTimeResource& fts = (*mResourceRequirements)[requirementIndex];
                 // index of the location is: fts.fluent
                 point_algebra::TimePoint::Ptr from = fts.getInterval().getFrom();
                 point_algebra::TimePoint::Ptr to = fts.getInterval().getTo();
@@ -1709,9 +2043,9 @@ void TransportNetwork::postRoleAssignments()
                     size_t col = FluentTimeIndex::toRowOrColumnIndex(fluentIdx, timeIndex + 1, numberOfFluents, numberOfFluents);
 
 
-                    LOG_INFO_S << "EdgeActivation for col: " << col << ", row: " << row << " requirement for: " << role.toString() << " roleRequirement: " << roleRequirement;
-                    LOG_INFO_S << "Translates to: " << from->toString() << " to " << to->toString();
-                    LOG_INFO_S << "Fluent: " << mpContext->locations()[fluentIdx]->toString();
+                    TEMPL_DEBUG_LOG("EdgeActivation for col: " << col << ", row: " << row << " requirement for: " << role.toString() << " roleRequirement: " << roleRequirement << std::endl
+                            << "Translates to: " << from->toString() << " to " << to->toString() << std::endl
+                            << "Fluent: " << mpContext->locations()[fluentIdx]->toString());
 
 
                     // constraint between timeline and roleRequirement
@@ -1755,7 +2089,7 @@ void TransportNetwork::postRoleAssignments()
     } // for loop active roles
 
     mActiveRoleList = activeRoles;
-    if(mActiveRoleList.empty())
+    if(mActiveRoleList->empty())
     {
         throw
             std::runtime_error("templ::solvers::csp::TransportNetwork::getTimelines: "
@@ -1779,9 +2113,9 @@ void TransportNetwork::postRoleAssignments()
     std::vector<int32_t> supplyDemand;
     if( mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/timeline-brancher/supply-demand",false) )
     {
-        for(uint32_t roleIdx = 0; roleIdx < mActiveRoles.size(); ++roleIdx)
+        for(uint32_t roleIdx = 0; roleIdx < mActiveRoles->size(); ++roleIdx)
         {
-            const Role& role = mRoles[ mActiveRoles[roleIdx] ];
+            const Role& role = mpContext->roles()[ (*mActiveRoles)[roleIdx] ];
             using namespace moreorg::facades;
             Robot robot = Robot::getInstance(role.getModel(), mpContext->ask());
             if(robot.isMobile())
@@ -1802,13 +2136,11 @@ void TransportNetwork::postRoleAssignments()
         assert(!supplyDemand.empty());
     }
 
-    Gecode::Rnd rnd;
-    rnd.hw();
-    double timelineAfcDecay = mpContext->configuration().getValueAs<double>("TransportNetwork/search/options/timeline-brancher/afc-decay");
+    Gecode::Rnd rnd = createRnd(3);
     size_t numberOfLocations = mpContext->locations().size();
-    for(size_t i = 0; i < mActiveRoles.size(); ++i)
+    for(size_t i = 0; i < mActiveRoles->size(); ++i)
     {
-        const Role& role = mActiveRoleList[i];
+        const Role& role = (*mActiveRoleList)[i];
 
         propagators::isPath(*this, mTimelines[i], role.toString(),
                 numberOfTimepoints, numberOfLocations);
@@ -1818,8 +2150,8 @@ void TransportNetwork::postRoleAssignments()
         Robot robot = Robot::getInstance(role.getModel(), mpContext->ask());
         if(robot.isMobile())
         {
-            Gecode::SetAFC timelineUsageAfc(*this, mTimelines[i], timelineAfcDecay);
-            branch(*this, mTimelines[i],Gecode::SET_VAR_AFC_MIN(timelineAfcDecay), Gecode::SET_VAL_RND_EXC(rnd));
+            Gecode::SetAFC timelineUsageAfc(*this, mTimelines[i], mTimelineAfcDecay);
+            branch(*this, mTimelines[i],Gecode::SET_VAR_AFC_MIN(mTimelineAfcDecay), Gecode::SET_VAL_RND_EXC(rnd));
             branch(*this, mTimelines[i],Gecode::SET_VAR_RND(rnd),Gecode::SET_VAL_RND_EXC(rnd));
             branch(*this, mTimelines[i], Gecode::tiebreak(
                         Gecode::SET_VAR_DEGREE_MAX(),
@@ -1836,7 +2168,7 @@ void TransportNetwork::postRoleAssignments()
     applyAccessConstraints(mTimelines,
             numberOfTimepoints,
             numberOfLocations,
-            mActiveRoleList);
+            *mActiveRoleList);
     // END LOCATION ACCESS
     // Only the check whether a feasible approach is to use a heuristic
     // to draw system by supply demand
@@ -1853,14 +2185,14 @@ void TransportNetwork::doPostMinCostFlow(Gecode::Space& home)
 
 void TransportNetwork::postMinCostFlow()
 {
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::POST_MIN_COST_FLOW);
+
     save();
 
     try {
-        breakpointStart()
-            << "Remaining flaws computation: " << mMinCostFlowFlaws.size() << std::endl
+        TEMPL_BREAKPOINT("Remaining flaws computation: " << mMinCostFlowFlaws->size() << std::endl
             << "     cost: " << mCost << std::endl
-            << "     flaws: " << mNumberOfFlaws << std::endl;
-        breakpointEnd();
+            << "     flaws: " << mNumberOfFlaws << std::endl);
 
         std::string solver =
             mpContext->configuration().getValueAs<std::string>("TransportNetwork/search/options/lp/solver","CBC_SOLVER");
@@ -1876,106 +2208,255 @@ void TransportNetwork::postMinCostFlow()
                 break;
             }
         }
+        if(solver == transshipment::GLPKMinCostFlow::SOLVER_NAME)
+        {
+            // Solved in memory, graph_analysis is only used to validate the
+            // result
+            solverType = ga::LPSolver::GLPK_SOLVER;
+        }
 
         double feasibilityTimeoutInMs = 1000*mpContext->configuration().getValueAs<double>("TransportNetwork/search/options/coalition-feasibility/timeout_in_s",1);
 
         std::map<Role, RoleTimeline> expandedTimelines = getTimelines();
 
 
-        LOG_INFO_S << "Min required: " <<
-            RoleTimeline::toString(mMinRequiredTimelines,4,false);
-        LOG_INFO_S << "Expanded: " <<
-            RoleTimeline::toString(expandedTimelines,4,false);
+        TEMPL_DEBUG_LOG("Min required: " <<
+            RoleTimeline::toString(*mMinRequiredTimelines,4,false));
+        TEMPL_DEBUG_LOG("Expanded: " <<
+            RoleTimeline::toString(expandedTimelines,4,false));
 
-        std::pair< std::map<Role, csp::RoleTimeline>, std::map<Role, csp::RoleTimeline> >
-            key(expandedTimelines, mMinRequiredTimelines);
+        FlowSolutionLookup lookup;
+        lookup.useCache = mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/lp/cache-solution",
+                        false);
+        lookup.hash = 0;
+        lookup.missionFingerprint = 0;
 
-        transshipment::MinCostFlow minCostFlow(expandedTimelines,
-                mMinRequiredTimelines,
-                mpContext->locations(),
-                mTimepoints,
-                mpContext->ask(),
-                mpMission->getLogger(),
+        transshipment::MinCostFlowCache::ValuePtr cachedSolution;
+        if(lookup.useCache || msPersistentMinCostFlowSolutions)
+        {
+            lookup.hash = transshipment::MinCostFlowCache::hash(expandedTimelines, *mMinRequiredTimelines);
+        }
+        if(msPersistentMinCostFlowSolutions)
+        {
+            // All inputs to the min cost flow apart from the timelines
+            std::stringstream options;
+            options << solver << ";" << feasibilityTimeoutInMs;
+            lookup.missionFingerprint = transshipment::PersistentMinCostFlowCache::fingerprint(*mpMission,
+                    mpContext->locations(), *mTimepoints, options.str());
+            lookup.canonicalKey = transshipment::MinCostFlowCache::canonicalKey(expandedTimelines, *mMinRequiredTimelines);
+        }
+        if(lookup.useCache)
+        {
+            lookup.key = FlowSolutionKey(expandedTimelines, *mMinRequiredTimelines);
+            cachedSolution = msMinCostFlowSolutions.lookup(lookup.hash, lookup.key);
+        }
+        if(!cachedSolution && msPersistentMinCostFlowSolutions)
+        {
+            FlowSolutionValue value;
+            if(msPersistentMinCostFlowSolutions->lookup(lookup.missionFingerprint, lookup.hash,
+                        lookup.canonicalKey, mpContext->locations(), *mTimepoints, value))
+            {
+                cachedSolution = make_shared<const FlowSolutionValue>(value);
+                if(lookup.useCache)
+                {
+                    msMinCostFlowSolutions.insert(lookup.hash, lookup.key, value);
+                }
+            }
+        }
+
+        TEMPL_BREAKPOINT("Min cost flow to start" << std::endl);
+
+        if(cachedSolution)
+        {
+            TEMPL_BREAKPOINT("Found existing solution .. (skipping recomputation and taking from cache)" << std::endl);
+
+            applyMinCostFlowSolution(*cachedSolution, NULL);
+            return;
+        }
+
+        if(mpMinCostFlowPipeline)
+        {
+            // Evaluate asynchronously: this space becomes a candidate
+            // solution, which is completed via completeMinCostFlow
+            mpPendingMinCostFlow = make_shared<PendingMinCostFlow>();
+            mpPendingMinCostFlow->lookup = lookup;
+            mpPendingMinCostFlow->future = mpMinCostFlowPipeline->submit(
+                    std::bind(&TransportNetwork::runMinCostFlow,
+                        mpContext,
+                        mpMission,
+                        expandedTimelines,
+                        *mMinRequiredTimelines,
+                        *mTimepoints,
+                        solverType,
+                        feasibilityTimeoutInMs));
+            return;
+        }
+
+        FlowSolutionValue solution = runMinCostFlow(mpContext,
+                mpMission,
+                expandedTimelines,
+                *mMinRequiredTimelines,
+                *mTimepoints,
                 solverType,
                 feasibilityTimeoutInMs);
 
-        breakpointStart()
-            << "Min cost flow to start" << std::endl;
-        breakpointEnd();
+        TEMPL_BREAKPOINT("Min cost flow to start" << std::endl);
 
-        FlowSolutions::iterator it = msMinCostFlowSolutions.find(key);
-        if(it == msMinCostFlowSolutions.end())
-        {
-            std::vector<transshipment::Flaw> flaws = minCostFlow.run();
+        applyMinCostFlowSolution(solution, &lookup);
 
-            breakpointStart()
-                << "Min cost flow to start" << std::endl;
-            breakpointEnd();
+    } catch(const std::runtime_error& e)
+    {
+        // Min cost flow optimization or negative cycle checking
+        LOG_WARN_S << "templ::solvers::csp::TransportNetwork: could not find"
+            << " solution: " << e.what();
+        this->fail();
+        return;
+    }
+}
 
-            transshipment::FlowNetwork flowNetwork = minCostFlow.getFlowNetwork();
-            mMinCostFlowSolution = flowNetwork.getSpaceTimeNetwork();
+TransportNetwork::FlowSolutionValue TransportNetwork::runMinCostFlow(const Context::Ptr& context,
+        const Mission::Ptr& mission,
+        const std::map<Role, RoleTimeline>& expandedTimelines,
+        const std::map<Role, RoleTimeline>& minRequiredTimelines,
+        const temporal::point_algebra::TimePoint::PtrList& timepoints,
+        graph_analysis::algorithms::LPSolver::Type solverType,
+        double feasibilityTimeoutInMs)
+{
+    templ::utils::Tracer::Scope traceScope("runMinCostFlow", "lp");
 
-            if(flaws.empty())
-            {
-                if(propagateImmobileAgentConstraints(mMinCostFlowSolution) ==
-                        Gecode::ES_FAILED)
-                {
-                    LOG_WARN_S << "Immobile agent constraints not maintained by"
-                        << " local search";
-                    return;
-                }
-            }
+    // Reuse the flow graph of the previous optimization
+    transshipment::IncrementalFlowGraph::Ptr incrementalFlowGraph;
+    if(context->configuration().getValueAs<bool>("TransportNetwork/search/options/lp/incremental", false))
+    {
+        incrementalFlowGraph = context->getIncrementalFlowGraph();
+    }
+
+    transshipment::MinCostFlow minCostFlow(expandedTimelines,
+            minRequiredTimelines,
+            context->locations(),
+            timepoints,
+            context->ask(),
+            mission->getLogger(),
+            solverType,
+            feasibilityTimeoutInMs,
+            incrementalFlowGraph);
+
+    bool saveFlowGraphs = context->configuration().getValueAs<bool>("TransportNetwork/search/options/lp/save-flow-graphs", true);
+    minCostFlow.setSaveFlowGraphs(saveFlowGraphs);
+
+    std::string solver = context->configuration().getValueAs<std::string>("TransportNetwork/search/options/lp/solver","CBC_SOLVER");
+    minCostFlow.setInMemorySolver(solver == transshipment::GLPKMinCostFlow::SOLVER_NAME);
 
-            flowNetwork.save();
+    std::vector<transshipment::Flaw> flaws = minCostFlow.run();
+    context->addLPRun(minCostFlow.getFlowGraphTime().toSeconds(),
+            minCostFlow.getProblemAndSolveTime().toSeconds(),
+            minCostFlow.getModelTime().toSeconds(),
+            minCostFlow.getSolveTime().toSeconds());
 
-            // store all flaws
-            mMinCostFlowFlaws = flaws;
+    transshipment::FlowNetwork flowNetwork = minCostFlow.getFlowNetwork();
+    if(saveFlowGraphs)
+    {
+        flowNetwork.save();
+    }
+    return FlowSolutionValue(flaws, flowNetwork.getSpaceTimeNetwork());
+}
 
-            if(mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/lp/cache-solution",
-                        false))
+void TransportNetwork::applyMinCostFlowSolution(const FlowSolutionValue& solution, const FlowSolutionLookup* lookup)
+{
+    mMinCostFlowSolution = solution.second;
+    if(lookup)
+    {
+        // Newly computed solution
+        if(solution.first.empty())
+        {
+            if(propagateImmobileAgentConstraints(*mMinCostFlowSolution) ==
+                    Gecode::ES_FAILED)
             {
-                msMinCostFlowSolutions[key] = FlowSolutionValue(flaws, mMinCostFlowSolution);
+                LOG_WARN_S << "Immobile agent constraints not maintained by"
+                    << " local search";
+                return;
             }
-        } else {
-            breakpointStart()
-                << "Found existing solution .. (skipping recomputation and taking from cache)" << std::endl;
-            breakpointEnd();
+        }
 
-            mMinCostFlowFlaws = it->second.first;
-            mMinCostFlowSolution = it->second.second;
+        if(lookup->useCache)
+        {
+            msMinCostFlowSolutions.insert(lookup->hash, lookup->key, FlowSolutionValue(solution.first, *mMinCostFlowSolution));
+        }
+        if(msPersistentMinCostFlowSolutions)
+        {
+            msPersistentMinCostFlowSolutions->store(lookup->missionFingerprint, lookup->hash,
+                    lookup->canonicalKey, FlowSolutionValue(solution.first, *mMinCostFlowSolution));
         }
-        // compute all feasible resolution that might allow
-        // to improve the solution
-        mFlawResolution.prepare(mMinCostFlowFlaws);
+    }
 
-        std::cout << "Session " << mpMission->getLogger()->getSessionId() << ": remaining flaws: " << mMinCostFlowFlaws.size() << std::endl;
-        breakpointStart()
-            << "Remaining flaws: " << mMinCostFlowFlaws.size() << std::endl;
-        breakpointEnd();
+    // store all flaws
+    mMinCostFlowFlaws = solution.first;
 
-        // Set flaws as current cost of this solution
-        rel(*this, mCost, Gecode::IRT_EQ, mMinCostFlowFlaws.size());
-        rel(*this, mNumberOfFlaws, Gecode::IRT_EQ, mMinCostFlowFlaws.size());
+    // compute all feasible resolution that might allow
+    // to improve the solution
+    mFlawResolution.prepare(*mMinCostFlowFlaws);
 
-        mSolutionAnalysis = solvers::SolutionAnalysis(mpMission, mMinCostFlowSolution, mpContext->configuration());
-        mSolutionAnalysis.analyse();
+    std::cout << "Session " << mpMission->getLogger()->getSessionId() << ": remaining flaws: " << mMinCostFlowFlaws->size() << std::endl;
+    TEMPL_BREAKPOINT("Remaining flaws: " << mMinCostFlowFlaws->size() << std::endl);
 
-        // Set flaws as well
-        bool allowFlaws = mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/allow-flaws", true);
-        if(!mMinCostFlowFlaws.empty() && !allowFlaws)
+    // Set flaws as current cost of this solution
+    rel(*this, mCost, Gecode::IRT_EQ, mMinCostFlowFlaws->size());
+    rel(*this, mNumberOfFlaws, Gecode::IRT_EQ, mMinCostFlowFlaws->size());
+
+    // In portfolio mode the best cost is shared between the assets, so
+    // that only improving solutions are accepted
+    int assets = mpContext->configuration().getValueAs<int>("TransportNetwork/search/options/portfolio/assets",1);
+    bool portfolioPruning = mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/portfolio/prune",true);
+    if(assets > 1 && portfolioPruning)
+    {
+        if(mMinCostFlowFlaws->size() >= mpContext->getBestCost())
         {
+            LOG_INFO_S << "Portfolio: pruning solution with cost " << mMinCostFlowFlaws->size()
+                << " -- best known cost: " << mpContext->getBestCost();
             this->fail();
             return;
         }
+    }
 
-    } catch(const std::runtime_error& e)
+    mSolutionAnalysis = solvers::SolutionAnalysis(mpMission, *mMinCostFlowSolution, mpContext->configuration());
+    mSolutionAnalysis.write().analyse();
+
+    // Set flaws as well
+    bool allowFlaws = mpContext->configuration().getValueAs<bool>("TransportNetwork/search/options/allow-flaws", true);
+    if(!mMinCostFlowFlaws->empty() && !allowFlaws)
+    {
+        this->fail();
+        return;
+    }
+    mpContext->updateBestCost(mMinCostFlowFlaws->size());
+}
+
+bool TransportNetwork::isMinCostFlowReady() const
+{
+    return !mpPendingMinCostFlow ||
+        transshipment::MinCostFlowPipeline::isReady(mpPendingMinCostFlow->future);
+}
+
+bool TransportNetwork::completeMinCostFlow()
+{
+    if(!mpPendingMinCostFlow)
+    {
+        return !failed();
+    }
+
+    shared_ptr<PendingMinCostFlow> pending = mpPendingMinCostFlow;
+    mpPendingMinCostFlow.reset();
+
+    try {
+        FlowSolutionValue solution = pending->future.get();
+        applyMinCostFlowSolution(solution, &pending->lookup);
+    } catch(const std::exception& e)
     {
-        // Min cost flow optimization or negative cycle checking
         LOG_WARN_S << "templ::solvers::csp::TransportNetwork: could not find"
             << " solution: " << e.what();
         this->fail();
-        return;
     }
+    return status() != Gecode::SS_FAILED;
 }
 
 void TransportNetwork::doPostTimelines(Gecode::Space& home)
@@ -1985,11 +2466,11 @@ void TransportNetwork::doPostTimelines(Gecode::Space& home)
 
 void TransportNetwork::postTimelines()
 {
-    breakpointStart()
-        << "Post timelines" << std::endl;
-    breakpointEnd();
+    templ::utils::PhaseTimer::Scope phaseTimer(templ::utils::PhaseTimer::POST_TIMELINES);
 
-    branchTimelines(*this, mTimelines, mSupplyDemand);
+    TEMPL_BREAKPOINT("Post timelines" << std::endl);
+
+    branchTimelines(*this, mTimelines, *mSupplyDemand);
 }
 
 std::string TransportNetwork::toString() const
@@ -2001,29 +2482,29 @@ std::string TransportNetwork::toString() const
     ss << "TransportNetwork: #" << std::endl;
     ss << "    Timepoints: " << mQualitativeTimepoints << std::endl;
     Gecode::Matrix<Gecode::IntVarArray> resourceDistribution(mModelUsage,
-            modelPoolSize, mResourceRequirements.size());
+            modelPoolSize, mResourceRequirements->size());
     for(size_t m = 0; m < modelPoolSize; ++m)
     {
         const IRI& model = getResourceModelFromIndex(m);
         ss << std::setw(30) << std::left << model.getFragment() << ": ";
-        for(size_t i = 0; i < mResourceRequirements.size(); ++i)
+        for(size_t i = 0; i < mResourceRequirements->size(); ++i)
         {
             ss << std::setw(10) << std::left << resourceDistribution(m,i);
         }
         ss << std::endl;
     }
 
-    Gecode::Matrix<Gecode::IntVarArray> rolesDistribution(mRoleUsage, mRoles.size(), mResourceRequirements.size());
+    Gecode::Matrix<Gecode::IntVarArray> rolesDistribution(mRoleUsage, mpContext->roles().size(), mResourceRequirements->size());
     size_t width = 30;
-    for(size_t m = 0; m < mRoles.size(); ++m)
+    for(size_t m = 0; m < mpContext->roles().size(); ++m)
     {
-        width = std::min(mRoles[m].toString().size() + 5, width);
+        width = std::min(mpContext->roles()[m].toString().size() + 5, width);
     }
 
-    for(size_t m = 0; m < mRoles.size(); ++m)
+    for(size_t m = 0; m < mpContext->roles().size(); ++m)
     {
-        ss << std::setw(width) << mRoles[m].toString() << ": ";
-        for(size_t i = 0; i < mResourceRequirements.size(); ++i)
+        ss << std::setw(width) << mpContext->roles()[m].toString() << ": ";
+        for(size_t i = 0; i < mResourceRequirements->size(); ++i)
         {
             ss << std::setw(10) << std::left << rolesDistribution(m,i);
         }
@@ -2032,8 +2513,8 @@ std::string TransportNetwork::toString() const
     try {
         for(size_t i = 0; i < mTimelines.size(); ++i)
         {
-            ss << mActiveRoleList[i].toString() << std::endl;
-            ss << Formatter::toString(mTimelines[i], mpContext->locations(), mTimepoints) << std::endl;
+            ss << (*mActiveRoleList)[i].toString() << std::endl;
+            ss << Formatter::toString(mTimelines[i], mpContext->locations(), *mTimepoints) << std::endl;
         }
 
     } catch(const std::exception& e)
@@ -2044,7 +2525,7 @@ std::string TransportNetwork::toString() const
 
     //ss << "Capacities: " << std::endl << Formatter::toString(mCapacities,
     //        toPtrList<Symbol,symbols::constants::Location>(mpContext->locations()),
-    //        toPtrList<Variable, temporal::point_algebra::TimePoint>(mTimepoints)
+    //        toPtrList<Variable, temporal::point_algebra::TimePoint>(*mTimepoints)
     //        ) << std::endl;
 
     return ss.str();
@@ -2057,9 +2538,9 @@ std::string TransportNetwork::modelUsageToString() const
     std::stringstream ss;
     ss << "Model usage:" << std::endl;
     ss << std::setw(firstcolumnwidth) << std::right << "    FluentTimeResource: ";
-    for(size_t r = 0; r < mResourceRequirements.size(); ++r)
+    for(size_t r = 0; r < mResourceRequirements->size(); ++r)
     {
-        const FluentTimeResource& fts = mResourceRequirements[r];
+        const FluentTimeResource& fts = (*mResourceRequirements)[r];
         /// construct string for proper alignment
         std::string s = fts.getFluent()->getInstanceName();
         s += "@[" + fts.getInterval().toString(0,true) + "]";
@@ -2076,7 +2557,7 @@ std::string TransportNetwork::modelUsageToString() const
     {
         const IRI& model = cit->first;
         ss << std::setw(firstcolumnwidth) << std::left << model.getFragment() << ": ";
-        for(size_t r = 0; r < mResourceRequirements.size(); ++r)
+        for(size_t r = 0; r < mResourceRequirements->size(); ++r)
         {
             ss << std::setw(columnwidth) << mModelUsage[r*modelPool.size() + modelIndex] << " ";
         }
@@ -2087,7 +2568,7 @@ std::string TransportNetwork::modelUsageToString() const
 
 std::string TransportNetwork::roleUsageToString() const
 {
-    return Formatter::toString(mRoleUsage, mRoles, mResourceRequirements);
+    return Formatter::toString(mRoleUsage, mpContext->roles(), *mResourceRequirements);
 }
 
 std::string TransportNetwork::toString(const std::vector<Gecode::IntVarArray>& timelines) const
@@ -2096,11 +2577,11 @@ std::string TransportNetwork::toString(const std::vector<Gecode::IntVarArray>& t
     std::vector<std::string> labels;
     for(size_t i = 0; i < timelines.size(); ++i)
     {
-        labels.push_back( mRoles[ activeRoles[i] ] .toString());
+        labels.push_back( mpContext->roles()[ activeRoles[i] ] .toString());
     }
     return Formatter::toString(timelines,
             toPtrList<Symbol,symbols::constants::Location>(mpContext->locations()),
-            toPtrList<Variable, temporal::point_algebra::TimePoint>(mTimepoints),
+            toPtrList<Variable, temporal::point_algebra::TimePoint>(*mTimepoints),
             labels);
 }
 
@@ -2109,10 +2590,10 @@ uint32_t TransportNetwork::getTimepointIndex(const temporal::point_algebra::Time
     using namespace templ::solvers::temporal;
 
     std::vector<point_algebra::TimePoint::Ptr>::const_iterator timepointIt =
-        std::find(mTimepoints.begin(), mTimepoints.end(), timePoint);
-    if(timepointIt != mTimepoints.end())
+        std::find(mTimepoints->begin(), mTimepoints->end(), timePoint);
+    if(timepointIt != mTimepoints->end())
     {
-        return timepointIt - mTimepoints.begin();
+        return timepointIt - mTimepoints->begin();
     }
     throw std::invalid_argument("templ::solvers::csp::TransportNetwork::getTimepointIndex: unknown timepoint '" + timePoint->toString() + "' given");
 }
@@ -2160,22 +2641,27 @@ Gecode::ExecStatus TransportNetwork::propagateImmobileAgentConstraints(const Spa
         mLocationIdxMap[ mpContext->locations()[idx] ] = idx;
     }
     std::map<temporal::point_algebra::TimePoint::Ptr, size_t> mTimepointIdxMap;
-    size_t numberOfTimepoints = mTimepoints.size();
+    size_t numberOfTimepoints = mTimepoints->size();
     for(size_t idx = 0; idx < numberOfTimepoints; ++idx)
     {
-        mTimepointIdxMap[ mTimepoints[idx] ] = idx;
+        mTimepointIdxMap[ (*mTimepoints)[idx] ] = idx;
     }
 
-    Role::List activeImmobileRoles;
+    // Registry ids of the immobile roles, so that the assigned roles of a
+    // tuple can be checked without creating the set of roles
+    std::vector<RoleRegistry::Id> activeImmobileRoleIds;
     std::vector<size_t> activeImmobileRolesIdx;
-    for(size_t idx = 0; idx < mActiveRoleList.size(); ++idx)
+    const RoleRegistry& registry = RoleRegistry::getInstance();
+    for(size_t idx = 0; idx < mActiveRoleList->size(); ++idx)
     {
-        const Role& role = mActiveRoleList[idx];
+        const Role& role = (*mActiveRoleList)[idx];
         using namespace moreorg::facades;
         Robot robot = Robot::getInstance(role.getModel(), mpContext->ask());
-        if(!robot.isMobile())
+        RoleRegistry::Id roleId;
+        // a role which is not registered cannot be assigned to any tuple
+        if(!robot.isMobile() && registry.findId(role, roleId))
         {
-            activeImmobileRoles.push_back(role);
+            activeImmobileRoleIds.push_back(roleId);
             activeImmobileRolesIdx.push_back(idx);
         }
     }
@@ -2188,25 +2674,23 @@ Gecode::ExecStatus TransportNetwork::propagateImmobileAgentConstraints(const Spa
         SpaceTime::Network::tuple_t::Ptr tuple =
             dynamic_pointer_cast<SpaceTime::Network::tuple_t>(vertexIt->current());
 
-        Role::Set roles = tuple->getRoles(RoleInfo::ASSIGNED);
-        for(const Role& role : roles)
+        const utils::BitSet& assignedRoleIds = tuple->getRoleIds(RoleInfo::ASSIGNED);
+        for(size_t i = 0; i < activeImmobileRoleIds.size(); ++i)
         {
-            for(size_t idx : activeImmobileRolesIdx)
+            if(assignedRoleIds.test(activeImmobileRoleIds[i]))
             {
-                if(role == activeImmobileRoles[idx])
+                size_t idx = activeImmobileRolesIdx[i];
+                if(updateTimeline(idx,
+                            mLocationIdxMap[tuple->first()],
+                            mTimepointIdxMap[tuple->second()],
+                            numberOfLocations,
+                            numberOfTimepoints) == Gecode::ES_FAILED)
                 {
-                    if(updateTimeline(idx,
-                                mLocationIdxMap[tuple->first()],
-                                mTimepointIdxMap[tuple->second()],
-                                numberOfLocations,
-                                numberOfTimepoints) == Gecode::ES_FAILED)
-                    {
-                        LOG_WARN_S << "Constraint could not be maintained for"
-                            << " role '" << role.toString() << "' at "
-                            << " location " << tuple->first()->getInstanceName()
-                            << " timepoint " << tuple->second()->getLabel();
-                        return Gecode::ES_FAILED;
-                    }
+                    LOG_WARN_S << "Constraint could not be maintained for"
+                        << " role '" << (*mActiveRoleList)[idx].toString() << "' at "
+                        << " location " << tuple->first()->getInstanceName()
+                        << " timepoint " << tuple->second()->getLabel();
+                    return Gecode::ES_FAILED;
                 }
             }
         }
@@ -2282,17 +2766,6 @@ void TransportNetwork::breakpoint(const std::string& msg)
     }
 }
 
-std::ostream& TransportNetwork::breakpointStart()
-{
-    mInteractiveMessageStream.clear();
-    return mInteractiveMessageStream;
-}
-
-void TransportNetwork::breakpointEnd()
-{
-    breakpoint(mInteractiveMessageStream.str());
-}
-
 } // end namespace csp
 } // end namespace solvers
 } // end namespace templ
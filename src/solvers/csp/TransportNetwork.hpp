@@ -13,13 +13,18 @@
 #include "../../Mission.hpp"
 #include "../FluentTimeResource.hpp"
 #include "../Solver.hpp"
+#include "../StoppingCriteria.hpp"
 #include "../transshipment/MinCostFlow.hpp"
+#include "../transshipment/MinCostFlowCache.hpp"
+#include "../transshipment/PersistentMinCostFlowCache.hpp"
+#include "../transshipment/MinCostFlowPipeline.hpp"
 #include "FlawResolution.hpp"
 #include "TemporalConstraintNetwork.hpp"
 #include "Types.hpp"
 #include "utils/FluentTimeIndex.hpp"
 #include "Context.hpp"
 #include "../SolutionAnalysis.hpp"
+#include "../../utils/CopyOnWrite.hpp"
 
 namespace templ {
 namespace solvers {
@@ -77,8 +82,11 @@ public:
     };
 
     typedef std::vector<Solution> SolutionList;
+    /// Callback for each solution, return false to stop the search
+    typedef std::function<bool (const Solution&)> SolutionCallback;
     typedef shared_ptr<TransportNetwork> Ptr;
     typedef shared_ptr< Gecode::BAB<TransportNetwork> > BABSearchEnginePtr;
+    typedef shared_ptr< Gecode::Search::Base<TransportNetwork> > SearchEnginePtr;
 
     const std::vector<solvers::temporal::Interval>& getIntervals() const { return mpContext->intervals(); }
 
@@ -87,13 +95,21 @@ protected:
     Mission::Ptr mpMission;
     Context::Ptr mpContext;
 
+    /// ###############################
+    /// Posted problem data
+    /// ###############################
+    /// The following members are set when the corresponding phase is
+    /// posted and are read-only afterwards, apart from extensions by
+    /// mission constraints. They are held copy-on-write, so that cloning a
+    /// space does not copy them.
+
     /// Timepoints (will be sorted after postTemporalConstraints has been
     /// called)
-    std::vector<solvers::temporal::point_algebra::TimePoint::Ptr> mTimepoints;
+    templ::utils::CopyOnWrite< std::vector<solvers::temporal::point_algebra::TimePoint::Ptr> > mTimepoints;
 
     /// List of FluentTimeResource which represents the functional
     /// requirements that arise from the mission scenario
-    std::vector<FluentTimeResource> mResourceRequirements;
+    templ::utils::CopyOnWrite< std::vector<FluentTimeResource> > mResourceRequirements;
 
     /// map timeslot to fluenttime service
     std::map<uint32_t, std::vector<FluentTimeResource> > mTimeIndexedRequirements;
@@ -141,10 +157,10 @@ protected:
     // per requirement/role: sum of same type roles <= model bound for fts
     //
     // model-based first stage guarantees conflict free solution on type basis
-    Role::List mRoles;
+    // The list of all roles is available via mpContext->roles()
 
-    std::vector<uint32_t> mActiveRoles;
-    Role::List mActiveRoleList;
+    templ::utils::CopyOnWrite< std::vector<uint32_t> > mActiveRoles;
+    templ::utils::CopyOnWrite<Role::List> mActiveRoleList;
 
     // ############################
     // Timelines
@@ -155,9 +171,9 @@ protected:
     //
     // Activation if edge is traversed by this item or not
     ListOfAdjacencyLists mTimelines;
-    std::map<Role, csp::RoleTimeline> mMinRequiredTimelines;
+    templ::utils::CopyOnWrite< std::map<Role, csp::RoleTimeline> > mMinRequiredTimelines;
 
-    std::vector<int32_t> mSupplyDemand;
+    templ::utils::CopyOnWrite< std::vector<int32_t> > mSupplyDemand;
     // Map the transport characteristic: (|Locations|*|Timepoints|)^2
     // Order such that bigger indexes are referring to later events(!)
     //                    | (t-0,loc-var-0) | (t-0, loc-var-1) | (t-0, loc-var-2) | ...
@@ -176,8 +192,9 @@ protected:
 
     // row column access
     //MatrixXi mProviderCapacities;
-    SpaceTime::Network mMinCostFlowSolution;
-    std::vector<transshipment::Flaw> mMinCostFlowFlaws;
+    // Per solution data, which is held copy-on-write as well
+    templ::utils::CopyOnWrite<SpaceTime::Network> mMinCostFlowSolution;
+    templ::utils::CopyOnWrite< std::vector<transshipment::Flaw> > mMinCostFlowFlaws;
     FlawResolution mFlawResolution;
     FlawResolution::ResolutionOptions mRequiredResolutionOptions;
 
@@ -185,22 +202,59 @@ protected:
     static bool msInteractive;
 
     bool mUseMasterSlave;
+
+    /// ###########################
+    /// Branching settings
+    /// ###########################
+    /// The settings are initialized from the configuration, but will be
+    /// overridden per asset when running in portfolio mode
+    double mModelUsageAfcDecay;
+    double mRoleUsageAfcDecay;
+    double mTimelineAfcDecay;
+    /// Seed for random branching, 0 to use hardware seeding
+    unsigned int mSeed;
+
     // The current master space
     TransportNetwork* mpCurrentMaster;
 
-    typedef std::pair< std::vector<transshipment::Flaw>, SpaceTime::Network> FlowSolutionValue;
-    typedef std::pair< std::map<Role, csp::RoleTimeline>, std::map<Role, csp::RoleTimeline> > FlowSolutionKey;
-    typedef std::map< FlowSolutionKey, FlowSolutionValue > FlowSolutions;
+    typedef transshipment::MinCostFlowCache::Value FlowSolutionValue;
+    typedef transshipment::MinCostFlowCache::Key FlowSolutionKey;
+
+    /// Process-wide cache for min cost flow solutions
+    static transshipment::MinCostFlowCache msMinCostFlowSolutions;
+    /// Optional file-based cache for min cost flow solutions, shared between
+    /// planner runs
+    static transshipment::PersistentMinCostFlowCache::Ptr msPersistentMinCostFlowSolutions;
+
+    /// Information required to store a computed min cost flow solution in
+    /// the caches
+    struct FlowSolutionLookup
+    {
+        bool useCache;
+        FlowSolutionKey key;
+        uint64_t hash;
+        uint64_t missionFingerprint;
+        /// Canonical key of the timelines for the persistent cache
+        std::string canonicalKey;
+    };
+
+    /// Min cost flow solution which is evaluated asynchronously
+    struct PendingMinCostFlow
+    {
+        transshipment::MinCostFlowPipeline::Future future;
+        FlowSolutionLookup lookup;
+    };
 
-    static FlowSolutions msMinCostFlowSolutions;
+    /// Pipeline for asynchronous min cost flow evaluation, if enabled
+    transshipment::MinCostFlowPipeline::Ptr mpMinCostFlowPipeline;
+    /// Min cost flow solution that still has to be applied to this space
+    shared_ptr<PendingMinCostFlow> mpPendingMinCostFlow;
 
     /// List of extra constraints
     Constraint::PtrList mConstraints;
-    SolutionAnalysis mSolutionAnalysis;
+    templ::utils::CopyOnWrite<SolutionAnalysis> mSolutionAnalysis;
 
 private:
-    std::stringstream mInteractiveMessageStream;
-
     std::set< std::vector<uint32_t> > toCSP(const moreorg::ModelPool::Set& set) const;
     std::vector<uint32_t> toCSP(const moreorg::ModelPool& combination) const;
 
@@ -256,9 +310,50 @@ private:
     static void doPostMinCostFlow(Gecode::Space& home);
     void postMinCostFlow();
 
+    /**
+     * Run the min cost flow optimization for the given timelines
+     * This function does not depend on a space, so that it can be used by
+     * the workers of the MinCostFlowPipeline
+     * \return flaws and the resulting space time network
+     */
+    static FlowSolutionValue runMinCostFlow(const Context::Ptr& context,
+            const Mission::Ptr& mission,
+            const std::map<Role, RoleTimeline>& expandedTimelines,
+            const std::map<Role, RoleTimeline>& minRequiredTimelines,
+            const temporal::point_algebra::TimePoint::PtrList& timepoints,
+            graph_analysis::algorithms::LPSolver::Type solverType,
+            double feasibilityTimeoutInMs);
+
+    /**
+     * Apply a min cost flow solution to this space, i.e. set cost and
+     * flaws and prepare the flaw resolution
+     * \param lookup Cache information for a newly computed solution, NULL
+     * if the solution has been taken from a cache
+     */
+    void applyMinCostFlowSolution(const FlowSolutionValue& solution, const FlowSolutionLookup* lookup);
+
+    /**
+     * Check if the asynchronously evaluated min cost flow solution of this
+     * space is available (or if there is none pending)
+     */
+    bool isMinCostFlowReady() const;
+
+    /**
+     * Wait for the asynchronously evaluated min cost flow solution and apply it
+     * \return true if this space is a valid solution, false if it failed
+     */
+    bool completeMinCostFlow();
+
     static void doPostTimelines(Gecode::Space& home);
     void postTimelines();
 
+    /**
+     * Create a random number generator for branching, which is seeded from
+     * the asset seed if one is set, or from hardware otherwise
+     * \param offset Offset to the seed to decorrelate multiple generators
+     */
+    Gecode::Rnd createRnd(unsigned int offset = 0) const;
+
 protected:
     // The general idea for implementing a LVNS approach
     //
@@ -316,6 +411,22 @@ protected:
      */
     void initializeTemporalConstraintNetwork();
 
+    /**
+     * Post the branching on the temporal constraint network, which will
+     * trigger the posting of all subsequent branchers
+     */
+    void branchTemporalConstraintNetwork();
+
+    /**
+     * Apply the asset specific branching settings for the portfolio search
+     *
+     * Settings are read from
+     * TransportNetwork/search/options/portfolio/asset-<asset>/, and fall back
+     * to a predefined set of variations for all but the first asset
+     * \param asset index of the asset
+     */
+    void configureAsset(unsigned int asset);
+
     /**
      * Set the cardinality constraints as defined in the
      * mission specification
@@ -399,8 +510,16 @@ public:
      *  a timeout happens, 0, to stop after first iteration and, > 0 to stop
      *  after given number of solutions has been found
      * \param configuration Configuration for this planning instance
+     * \param stoppingCriteria Additional criteria to terminate the search,
+     * which are combined with the criteria from the configuration
+     * (TransportNetwork/search/options/stopping)
+     * \param solutionCallback Callback for each solution, which is called
+     * as soon as the solution has been found; return false to stop the search
      */
-    static SolutionList solve(const templ::Mission::Ptr& mission, uint32_t minNumberOfSolutions = 1, const qxcfg::Configuration& configuration = qxcfg::Configuration());
+    static SolutionList solve(const templ::Mission::Ptr& mission, uint32_t minNumberOfSolutions = 1,
+            const qxcfg::Configuration& configuration = qxcfg::Configuration(),
+            const StoppingCriteria& stoppingCriteria = StoppingCriteria(),
+            const SolutionCallback& solutionCallback = SolutionCallback());
 
     /**
      * Get the solution of this Gecode::Space instance
@@ -412,7 +531,9 @@ public:
      */
     static void saveSolution(const Solution& solution, const Mission::Ptr& mission);
 
-    solvers::Session::Ptr run(const templ::Mission::Ptr& mission, uint32_t minNumberOfSolutions, const qxcfg::Configuration& configuration);
+    using Solver::run;
+
+    void run(const solvers::Session::Ptr& session, uint32_t minNumberOfSolutions, const qxcfg::Configuration& configuration);
 
     /**
      * Add a general constraint
@@ -465,26 +586,20 @@ public:
     /**
      * Get the active roles (as index list)
      */
-    std::vector<uint32_t> getActiveRoles() const { return mActiveRoles; }
+    std::vector<uint32_t> getActiveRoles() const { return *mActiveRoles; }
 
     /**
      * Get the list of active role (as role list)
      */
-    Role::List getActiveRoleList() const { return mActiveRoleList; }
+    Role::List getActiveRoleList() const { return *mActiveRoleList; }
 
     void setCurrentMaster(TransportNetwork* master) { mpCurrentMaster = master; }
 
-    static void breakpoint(const std::string& msg);
-
     /**
-     * Start a breakpoint for the interactive mode
+     * Show a message and wait for the user in interactive mode
+     * \see TEMPL_BREAKPOINT, which formats the message only when needed
      */
-    std::ostream& breakpointStart();
-
-    /**
-     * Close the interactive mode
-     */
-    void breakpointEnd();
+    static void breakpoint(const std::string& msg);
 };
 
 std::ostream& operator<<(std::ostream& os, const TransportNetwork::Solution& solution);
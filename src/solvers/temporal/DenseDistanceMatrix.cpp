@@ -0,0 +1,215 @@
+#include "DenseDistanceMatrix.hpp"
+#include <algorithm>
+#include "../../utils/ParallelFor.hpp"
+
+namespace templ {
+namespace solvers {
+namespace temporal {
+
+const size_t DenseDistanceMatrix::BLOCK_SIZE;
+
+DenseDistanceMatrix::DenseDistanceMatrix(size_t size)
+    : mSize(size)
+    , mStride( ((size + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE )
+    , mDistances(mStride*mStride, infinity())
+{
+    for(size_t i = 0; i < mStride; ++i)
+    {
+        mDistances[i*mStride + i] = 0.0;
+    }
+}
+
+void DenseDistanceMatrix::reset()
+{
+    std::fill(mDistances.begin(), mDistances.end(), infinity());
+    for(size_t i = 0; i < mStride; ++i)
+    {
+        mDistances[i*mStride + i] = 0.0;
+    }
+}
+
+void DenseDistanceMatrix::resize(size_t size)
+{
+    if(size > mStride)
+    {
+        // grow geometrically, since vertices are typically added one by one
+        size_t stride = std::max(2*mStride, ((size + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE);
+        std::vector<double> distances(stride*stride, infinity());
+        for(size_t i = 0; i < stride; ++i)
+        {
+            if(i < mSize)
+            {
+                std::copy(&mDistances[i*mStride], &mDistances[i*mStride] + mSize, &distances[i*stride]);
+            }
+            distances[i*stride + i] = 0.0;
+        }
+        mDistances.swap(distances);
+        mStride = stride;
+    } else {
+        // reset the vertices that are removed, so that the padding remains
+        // unconnected
+        for(size_t i = size; i < mSize; ++i)
+        {
+            for(size_t j = 0; j < mStride; ++j)
+            {
+                mDistances[i*mStride + j] = infinity();
+                mDistances[j*mStride + i] = infinity();
+            }
+            mDistances[i*mStride + i] = 0.0;
+        }
+    }
+    mSize = size;
+}
+
+bool DenseDistanceMatrix::addEdge(size_t u, size_t v, double weight, ChangeList* changes)
+{
+    if(weight >= get(u,v))
+    {
+        return true;
+    }
+    if(weight + get(v,u) < 0)
+    {
+        return false;
+    }
+
+    std::vector<size_t> sources;
+    std::vector<size_t> targets;
+    for(size_t i = 0; i < mSize; ++i)
+    {
+        if(get(i,u) + weight < get(i,v))
+        {
+            sources.push_back(i);
+        }
+        if(weight + get(v,i) < get(u,i))
+        {
+            targets.push_back(i);
+        }
+    }
+
+    // Row v is not modified, since d(v,u) + w >= 0 -- so it can be read
+    // while updating
+    const double* row_v = &mDistances[v*mStride];
+    for(size_t i : sources)
+    {
+        double d_iv = get(i,u) + weight;
+        double* row_i = &mDistances[i*mStride];
+        for(size_t j : targets)
+        {
+            double distance = d_iv + row_v[j];
+            if(distance < row_i[j])
+            {
+                if(changes)
+                {
+                    changes->push_back( Change(i, j, row_i[j]) );
+                }
+                row_i[j] = distance;
+            }
+        }
+    }
+    return true;
+}
+
+void DenseDistanceMatrix::undo(const ChangeList& changes)
+{
+    for(ChangeList::const_reverse_iterator rit = changes.rbegin(); rit != changes.rend(); ++rit)
+    {
+        set(rit->i, rit->j, rit->distance);
+    }
+}
+
+bool DenseDistanceMatrix::allShortestPaths(size_t numberOfThreads)
+{
+    // Threads are started for each diagonal block, so that below this size
+    // the thread overhead outweighs the gain
+    static const size_t MIN_PARALLEL_SIZE = 4*BLOCK_SIZE;
+    if(mSize < MIN_PARALLEL_SIZE)
+    {
+        numberOfThreads = 1;
+    }
+
+    size_t numberOfBlocks = mStride / BLOCK_SIZE;
+    // Number of blocks in a row or column apart from the diagonal block
+    size_t numberOfOtherBlocks = numberOfBlocks - 1;
+    for(size_t kb = 0; kb < numberOfBlocks; ++kb)
+    {
+        // Phase 1: the diagonal block depends only on itself
+        updateBlock(kb, kb, kb);
+
+        // Phase 2: the blocks in row kb and column kb depend on the diagonal
+        // block only
+        utils::parallelFor(2*numberOfOtherBlocks, numberOfThreads, [this, kb, numberOfOtherBlocks](size_t index)
+            {
+                size_t b = index % numberOfOtherBlocks;
+                b += (b >= kb);
+                if(index < numberOfOtherBlocks)
+                {
+                    updateBlock(kb, b, kb);
+                } else {
+                    updateBlock(b, kb, kb);
+                }
+            });
+
+        // Phase 3: all remaining blocks depend on the blocks of row kb and
+        // column kb only
+        utils::parallelFor(numberOfOtherBlocks*numberOfOtherBlocks, numberOfThreads, [this, kb, numberOfOtherBlocks](size_t index)
+            {
+                size_t ib = index / numberOfOtherBlocks;
+                size_t jb = index % numberOfOtherBlocks;
+                ib += (ib >= kb);
+                jb += (jb >= kb);
+                updateBlock(ib, jb, kb);
+            });
+
+        // A negative cycle through a vertex of this block is final, so stop
+        // early
+        for(size_t k = kb*BLOCK_SIZE; k < (kb+1)*BLOCK_SIZE; ++k)
+        {
+            if(mDistances[k*mStride + k] < 0)
+            {
+                return false;
+            }
+        }
+    }
+    return !hasNegativeCycle();
+}
+
+void DenseDistanceMatrix::updateBlock(size_t ib, size_t jb, size_t kb)
+{
+    size_t iBegin = ib*BLOCK_SIZE;
+    size_t jBegin = jb*BLOCK_SIZE;
+    size_t kBegin = kb*BLOCK_SIZE;
+    for(size_t k = kBegin; k < kBegin + BLOCK_SIZE; ++k)
+    {
+        const double* row_k = &mDistances[k*mStride + jBegin];
+        for(size_t i = iBegin; i < iBegin + BLOCK_SIZE; ++i)
+        {
+            double d_ik = mDistances[i*mStride + k];
+            if(d_ik == infinity())
+            {
+                continue;
+            }
+
+            double* row_i = &mDistances[i*mStride + jBegin];
+            for(size_t j = 0; j < BLOCK_SIZE; ++j)
+            {
+                row_i[j] = std::min(row_i[j], d_ik + row_k[j]);
+            }
+        }
+    }
+}
+
+bool DenseDistanceMatrix::hasNegativeCycle() const
+{
+    for(size_t i = 0; i < mSize; ++i)
+    {
+        if(get(i,i) < 0)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+} // end namespace temporal
+} // end namespace solvers
+} // end namespace templ
@@ -0,0 +1,133 @@
+#ifndef TEMPL_SOLVERS_TEMPORAL_DENSE_DISTANCE_MATRIX_HPP
+#define TEMPL_SOLVERS_TEMPORAL_DENSE_DISTANCE_MATRIX_HPP
+
+#include <vector>
+#include <cstddef>
+#include <limits>
+
+namespace templ {
+namespace solvers {
+namespace temporal {
+
+/**
+ * \class DenseDistanceMatrix
+ * \brief Contiguous matrix of distances between n vertices of a distance
+ * graph to compute all shortest paths
+ *
+ * Missing edges have an infinite distance. The matrix is padded to a multiple
+ * of the block size, so that the blocked Floyd-Warshall algorithm operates on
+ * full blocks only
+ */
+class DenseDistanceMatrix
+{
+public:
+    /**
+     * Previous distance of an entry, which allows to undo an update
+     */
+    struct Change
+    {
+        size_t i;
+        size_t j;
+        double distance;
+
+        Change(size_t i, size_t j, double distance)
+            : i(i), j(j), distance(distance)
+        {}
+    };
+    typedef std::vector<Change> ChangeList;
+
+    /**
+     * Create a matrix for the given number of vertices with zero distance on
+     * the diagonal and infinite distance otherwise
+     */
+    DenseDistanceMatrix(size_t size = 0);
+
+    size_t size() const { return mSize; }
+
+    /**
+     * Reset all distances, i.e. remove all edges
+     */
+    void reset();
+
+    /**
+     * Change the number of vertices, existing distances are kept and new
+     * vertices are unconnected
+     */
+    void resize(size_t size);
+
+    double get(size_t i, size_t j) const { return mDistances[i*mStride + j]; }
+
+    void set(size_t i, size_t j, double distance) { mDistances[i*mStride + j] = distance; }
+
+    /**
+     * Set distance (i,j) if it is shorter than the current one, i.e. for
+     * parallel edges the shortest one is kept
+     */
+    void relax(size_t i, size_t j, double distance)
+    {
+        double& d = mDistances[i*mStride + j];
+        if(distance < d)
+        {
+            d = distance;
+        }
+    }
+
+    /**
+     * Compute all shortest paths in place using a cache-blocked
+     * Floyd-Warshall algorithm
+     *
+     * For each block on the diagonal, first the diagonal block, then the
+     * blocks in the same row and column and finally all remaining blocks are
+     * updated, where the blocks of the last two phases are distributed across
+     * the threads. Matrices with fewer than four blocks per row are
+     * processed by the calling thread only
+     * \param numberOfThreads Number of threads to use
+     * \return false if the graph contains a negative cycle, true otherwise
+     */
+    bool allShortestPaths(size_t numberOfThreads = 1);
+
+    /**
+     * Add an edge to a matrix of shortest paths (see allShortestPaths) and
+     * update only the affected distances
+     *
+     * Only the distances (i,j) with d(i,u) + w < d(i,v) and w + d(v,j) < d(u,j)
+     * can be shortened by the new edge, so that the update is proportional to
+     * the size of the affected region plus a linear scan
+     * \param changes If given, the previous distances of all updated entries
+     * are appended, see undo
+     * \return false if the edge closes a negative cycle -- the matrix remains
+     * unchanged then, true otherwise
+     */
+    bool addEdge(size_t u, size_t v, double weight, ChangeList* changes = NULL);
+
+    /**
+     * Restore the distances recorded by addEdge
+     */
+    void undo(const ChangeList& changes);
+
+    /**
+     * Check for a negative cycle, i.e. a negative distance on the diagonal
+     * \return true if there is a negative cycle, false otherwise
+     */
+    bool hasNegativeCycle() const;
+
+    static double infinity() { return std::numeric_limits<double>::infinity(); }
+
+private:
+    static const size_t BLOCK_SIZE = 32;
+
+    /**
+     * Update block (ib,jb) with paths via the vertices of block kb
+     */
+    void updateBlock(size_t ib, size_t jb, size_t kb);
+
+    size_t mSize;
+    /// Size of a row, i.e. size padded to a multiple of the block size
+    size_t mStride;
+    std::vector<double> mDistances;
+};
+
+} // end namespace temporal
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_TEMPORAL_DENSE_DISTANCE_MATRIX_HPP
@@ -86,6 +86,11 @@ public:
      */
     const std::vector<Bounds>& getIntervals() const { return mIntervals; }
 
+    /**
+     * Replace the intervals
+     */
+    void setIntervals(const std::vector<Bounds>& intervals) { mIntervals = intervals; }
+
     /**
      * Get the lowest bound
      */
@@ -3,7 +3,12 @@
 #include <graph_analysis/GraphIO.hpp>
 #include "../../SharedPtr.hpp"
 #include <limits>
+#include <numeric>
+#include <atomic>
+#include <algorithm>
+#include <unordered_map>
 #include <numeric/Combinatorics.hpp>
+#include "../../utils/ParallelFor.hpp"
 
 namespace templ {
 namespace solvers {
@@ -456,6 +461,360 @@ TemporalConstraintNetwork LoosePathConsistency::loosePathConsistency(const Tempo
     return n;
 }
 
+void LoosePathConsistency::composition(BoundsIterator aBegin, BoundsIterator aEnd,
+        BoundsIterator bBegin, BoundsIterator bEnd,
+        Bounds::List& result)
+{
+    result.clear();
+    for(BoundsIterator a = aBegin; a != aEnd; ++a)
+    {
+        for(BoundsIterator b = bBegin; b != bEnd; ++b)
+        {
+            Bounds x(a->getLowerBound() + b->getLowerBound(), a->getUpperBound() + b->getUpperBound());
+            if(x.isValid())
+            {
+                result.push_back(x);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase( std::unique(result.begin(), result.end()), result.end() );
+
+    // merge overlapping intervals as computeDisjointIntervals does
+    for(size_t i = 0; i < result.size(); ++i)
+    {
+        Bounds& a = result[i];
+        size_t d = i + 1;
+        while(d < result.size())
+        {
+            const Bounds& b = result[d];
+            if(a.overlaps(b))
+            {
+                a.setLowerBound( std::min(a.getLowerBound(), b.getLowerBound()) );
+                a.setUpperBound( std::max(a.getUpperBound(), b.getUpperBound()) );
+                result.erase(result.begin() + d);
+                // the merged interval can overlap intervals which have been
+                // checked already
+                d = i + 1;
+            } else {
+                ++d;
+            }
+        }
+    }
+}
+
+void LoosePathConsistency::intersection(BoundsIterator aBegin, BoundsIterator aEnd,
+        BoundsIterator bBegin, BoundsIterator bEnd,
+        Bounds::List& result)
+{
+    result.clear();
+    for(BoundsIterator a = aBegin; a != aEnd; ++a)
+    {
+        for(BoundsIterator b = bBegin; b != bEnd; ++b)
+        {
+            Bounds x(std::max(a->getLowerBound(), b->getLowerBound()), std::min(a->getUpperBound(), b->getUpperBound()));
+            if(x.isValid())
+            {
+                result.push_back(x);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    result.erase( std::unique(result.begin(), result.end()), result.end() );
+}
+
+void LoosePathConsistency::looseIntersection(BoundsIterator aBegin, BoundsIterator aEnd,
+        BoundsIterator bBegin, BoundsIterator bEnd,
+        Bounds::List& result)
+{
+    result.clear();
+    for(BoundsIterator a = aBegin; a != aEnd; ++a)
+    {
+        // bounds of the intersection between a and the set b
+        bool overlapping = false;
+        double min = std::numeric_limits<double>::max();
+        double max = std::numeric_limits<double>::lowest();
+        for(BoundsIterator b = bBegin; b != bEnd; ++b)
+        {
+            double lowerBound = std::max(a->getLowerBound(), b->getLowerBound());
+            double upperBound = std::min(a->getUpperBound(), b->getUpperBound());
+            if(lowerBound <= upperBound)
+            {
+                overlapping = true;
+                min = std::min(lowerBound, min);
+                max = std::max(upperBound, max);
+            }
+        }
+
+        Bounds intersection(min, max);
+        if(overlapping && std::find(result.begin(), result.end(), intersection) == result.end())
+        {
+            result.push_back(intersection);
+        }
+    }
+}
+
+bool LoosePathConsistency::sameIntervals(BoundsIterator aBegin, BoundsIterator aEnd,
+        BoundsIterator bBegin, BoundsIterator bEnd,
+        Scratch& scratch)
+{
+    scratch.sortedA.assign(aBegin, aEnd);
+    std::sort(scratch.sortedA.begin(), scratch.sortedA.end());
+    scratch.sortedA.erase( std::unique(scratch.sortedA.begin(), scratch.sortedA.end()), scratch.sortedA.end() );
+
+    scratch.sortedB.assign(bBegin, bEnd);
+    std::sort(scratch.sortedB.begin(), scratch.sortedB.end());
+    scratch.sortedB.erase( std::unique(scratch.sortedB.begin(), scratch.sortedB.end()), scratch.sortedB.end() );
+
+    return scratch.sortedA == scratch.sortedB;
+}
+
+bool LoosePathConsistency::revise(const IntervalSets& sets, size_t i, size_t j, Scratch& scratch)
+{
+    // T1(i,j): intersection after k of composition(C(i,k), C(k,j)), where
+    // an empty set is the universal constraint
+    bool constrained = false;
+    Bounds::List& t1 = scratch.intersection;
+    t1.clear();
+    for(size_t k = 0; k < sets.size; ++k)
+    {
+        if(k == i || k == j || sets.empty(i,k) || sets.empty(k,j))
+        {
+            continue;
+        }
+
+        composition(sets.begin(i,k), sets.end(i,k), sets.begin(k,j), sets.end(k,j), scratch.composition);
+        if(scratch.composition.empty())
+        {
+            continue;
+        }
+
+        if(!constrained)
+        {
+            t1.swap(scratch.composition);
+            constrained = true;
+        } else {
+            intersection(t1.begin(), t1.end(), scratch.composition.begin(), scratch.composition.end(), scratch.swap);
+            t1.swap(scratch.swap);
+            if(t1.empty())
+            {
+                return false;
+            }
+        }
+    }
+
+    // T2(i,j): loose intersection between C(i,j) and T1(i,j)
+    if(!constrained)
+    {
+        scratch.result.assign(sets.begin(i,j), sets.end(i,j));
+    } else if(sets.empty(i,j))
+    {
+        scratch.result.assign(t1.begin(), t1.end());
+    } else {
+        looseIntersection(sets.begin(i,j), sets.end(i,j), t1.begin(), t1.end(), scratch.result);
+        if(scratch.result.empty())
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool LoosePathConsistency::enforce(TemporalConstraintNetwork& network)
+{
+    using namespace graph_analysis;
+
+    BaseGraph::Ptr graph = network.getDistanceGraph();
+    Vertex::PtrList vertices = graph->getAllVertices();
+    size_t n = vertices.size();
+    std::unordered_map<Vertex::Ptr, size_t> indices;
+    for(size_t i = 0; i < n; ++i)
+    {
+        indices[ vertices[i] ] = i;
+    }
+
+    // Fill the arena with the intervals of all edges, where each edge
+    // contributes to the set (i,j) and, reversed, to the set (j,i)
+    std::vector<IntervalConstraint::Ptr> constraints;
+    EdgeIterator::Ptr edgeIt = graph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        IntervalConstraint::Ptr constraint = dynamic_pointer_cast<IntervalConstraint>(edgeIt->current());
+        if(constraint && constraint->getSourceVertex() != constraint->getTargetVertex())
+        {
+            constraints.push_back(constraint);
+        }
+    }
+
+    IntervalSets sets;
+    sets.size = n;
+    sets.offsets.assign(n*n + 1, 0);
+    for(const IntervalConstraint::Ptr& constraint : constraints)
+    {
+        size_t s = indices[ constraint->getSourceVertex() ];
+        size_t t = indices[ constraint->getTargetVertex() ];
+        sets.offsets[s*n + t + 1] += constraint->getIntervals().size();
+        sets.offsets[t*n + s + 1] += constraint->getIntervals().size();
+    }
+    std::partial_sum(sets.offsets.begin(), sets.offsets.end(), sets.offsets.begin());
+    sets.intervals.resize(sets.offsets.back());
+
+    std::vector<size_t> cursor(sets.offsets.begin(), sets.offsets.end() - 1);
+    for(const IntervalConstraint::Ptr& constraint : constraints)
+    {
+        size_t s = indices[ constraint->getSourceVertex() ];
+        size_t t = indices[ constraint->getTargetVertex() ];
+        for(const Bounds& b : constraint->getIntervals())
+        {
+            sets.intervals[ cursor[s*n + t]++ ] = b;
+            sets.intervals[ cursor[t*n + s]++ ] = Bounds(-b.getUpperBound(), -b.getLowerBound());
+        }
+    }
+    const IntervalSets initialSets = sets;
+
+    std::vector< std::pair<size_t, size_t> > pairs;
+    for(size_t i = 0; i < n; ++i)
+    {
+        for(size_t j = i + 1; j < n; ++j)
+        {
+            pairs.push_back( std::make_pair(i,j) );
+        }
+    }
+
+    // The pairs are partitioned across the workers, each of which writes its
+    // results into its own buffer, so that the next arena can be assembled
+    // in pair order
+    size_t numberOfWorkers = std::max<size_t>(1, std::min(network.getNumberOfThreads(), pairs.size()));
+    std::vector<Scratch> scratch(numberOfWorkers);
+    std::vector<Bounds::List> outputs(numberOfWorkers);
+    std::vector<size_t> resultWorker(pairs.size());
+    std::vector<size_t> resultOffset(pairs.size());
+    std::vector<size_t> resultCount(pairs.size());
+    IntervalSets nextSets;
+    nextSets.size = n;
+    nextSets.offsets.resize(n*n + 1);
+
+    bool changed = true;
+    while(changed)
+    {
+        std::atomic<bool> inconsistent(false);
+        std::atomic<bool> anyChange(false);
+        utils::parallelFor(numberOfWorkers, numberOfWorkers, [&](size_t w)
+            {
+                Bounds::List& output = outputs[w];
+                output.clear();
+                for(size_t p = w; p < pairs.size() && !inconsistent; p += numberOfWorkers)
+                {
+                    size_t i = pairs[p].first;
+                    size_t j = pairs[p].second;
+                    if(!revise(sets, i, j, scratch[w]))
+                    {
+                        inconsistent = true;
+                        return;
+                    }
+
+                    const Bounds::List& result = scratch[w].result;
+                    if(!sameIntervals(sets.begin(i,j), sets.end(i,j), result.begin(), result.end(), scratch[w]))
+                    {
+                        anyChange = true;
+                    }
+                    resultWorker[p] = w;
+                    resultOffset[p] = output.size();
+                    resultCount[p] = result.size();
+                    output.insert(output.end(), result.begin(), result.end());
+                }
+            });
+
+        if(inconsistent)
+        {
+            return false;
+        }
+        changed = anyChange;
+        if(!changed)
+        {
+            break;
+        }
+
+        // Assemble the arena of the next round
+        std::fill(nextSets.offsets.begin(), nextSets.offsets.end(), 0);
+        for(size_t p = 0; p < pairs.size(); ++p)
+        {
+            size_t i = pairs[p].first;
+            size_t j = pairs[p].second;
+            nextSets.offsets[i*n + j + 1] = resultCount[p];
+            nextSets.offsets[j*n + i + 1] = resultCount[p];
+        }
+        std::partial_sum(nextSets.offsets.begin(), nextSets.offsets.end(), nextSets.offsets.begin());
+        nextSets.intervals.resize(nextSets.offsets.back());
+        for(size_t p = 0; p < pairs.size(); ++p)
+        {
+            size_t i = pairs[p].first;
+            size_t j = pairs[p].second;
+            Bounds::List::const_iterator result = outputs[ resultWorker[p] ].begin() + resultOffset[p];
+            size_t forward = nextSets.offsets[i*n + j];
+            size_t backward = nextSets.offsets[j*n + i];
+            for(size_t r = 0; r < resultCount[p]; ++r, ++result)
+            {
+                nextSets.intervals[forward + r] = *result;
+                nextSets.intervals[backward + r] = Bounds(-result->getUpperBound(), -result->getLowerBound());
+            }
+        }
+        std::swap(sets, nextSets);
+    }
+
+    // Write back the pairs which have been tightened
+    for(const std::pair<size_t, size_t>& pair : pairs)
+    {
+        size_t i = pair.first;
+        size_t j = pair.second;
+        if(sameIntervals(initialSets.begin(i,j), initialSets.end(i,j), sets.begin(i,j), sets.end(i,j), scratch[0]))
+        {
+            continue;
+        }
+
+        Bounds::List forward(sets.begin(i,j), sets.end(i,j));
+        Bounds::List backward(sets.begin(j,i), sets.end(j,i));
+        bool updated = false;
+        for(const Edge::Ptr& edge : graph->getEdges(vertices[i], vertices[j]))
+        {
+            IntervalConstraint::Ptr constraint = dynamic_pointer_cast<IntervalConstraint>(edge);
+            if(constraint)
+            {
+                constraint->setIntervals(forward);
+                updated = true;
+            }
+        }
+        for(const Edge::Ptr& edge : graph->getEdges(vertices[j], vertices[i]))
+        {
+            IntervalConstraint::Ptr constraint = dynamic_pointer_cast<IntervalConstraint>(edge);
+            if(constraint)
+            {
+                constraint->setIntervals(backward);
+                updated = true;
+            }
+        }
+
+        if(!updated)
+        {
+            // pair became constrained, so add an edge using the direction
+            // with non-negative bounds
+            point_algebra::TimePoint::Ptr ti = dynamic_pointer_cast<point_algebra::TimePoint>(vertices[i]);
+            point_algebra::TimePoint::Ptr tj = dynamic_pointer_cast<point_algebra::TimePoint>(vertices[j]);
+            IntervalConstraint::Ptr constraint;
+            if(Bounds::includesNegative(forward))
+            {
+                constraint = make_shared<IntervalConstraint>(tj, ti);
+                constraint->setIntervals(backward);
+            } else {
+                constraint = make_shared<IntervalConstraint>(ti, tj);
+                constraint->setIntervals(forward);
+            }
+            network.addIntervalConstraint(constraint);
+        }
+    }
+    return true;
+}
+
 } // end namespace temporal
 } // end namespace solvers
 } // end namespace templ
@@ -80,6 +80,87 @@ public:
      */
     static TemporalConstraintNetwork loosePathConsistency(const TemporalConstraintNetwork& t);
 
+    /**
+     * \brief Enforce loose path consistency on a network in place
+     * \details Computes the same rounds as loosePathConsistency, but keeps the
+     * interval sets of all pairs of timepoints in a contiguous arena, reuses
+     * scratch buffers for the set operations and distributes the pairs (i,j)
+     * of each round across TemporalConstraintNetwork::getNumberOfThreads()
+     * threads.
+     * A pair without a constraint on any triangle remains unconstrained,
+     * and an empty interval set stops the computation immediately.
+     * Only the edges whose intervals changed are updated, and edges are
+     * added for pairs that became constrained
+     * \return true if the network is consistent, false if it is inconsistent
+     * -- the network remains unchanged then
+     */
+    static bool enforce(TemporalConstraintNetwork& network);
+
+private:
+    typedef Bounds::List::const_iterator BoundsIterator;
+
+    /**
+     * Interval sets of all ordered pairs (i,j) of n timepoints stored in a
+     * single arena, where the set (j,i) is the reverse of (i,j)
+     */
+    struct IntervalSets
+    {
+        size_t size;
+        /// set (i,j) is [offsets[i*size + j], offsets[i*size + j + 1])
+        std::vector<size_t> offsets;
+        Bounds::List intervals;
+
+        BoundsIterator begin(size_t i, size_t j) const { return intervals.begin() + offsets[i*size + j]; }
+        BoundsIterator end(size_t i, size_t j) const { return intervals.begin() + offsets[i*size + j + 1]; }
+        bool empty(size_t i, size_t j) const { return offsets[i*size + j] == offsets[i*size + j + 1]; }
+    };
+
+    /**
+     * Buffers which are reused across all set operations of one thread
+     */
+    struct Scratch
+    {
+        Bounds::List composition;
+        Bounds::List intersection;
+        Bounds::List swap;
+        Bounds::List result;
+        Bounds::List sortedA;
+        Bounds::List sortedB;
+    };
+
+    /**
+     * Same as composition, but writing into the given result buffer
+     */
+    static void composition(BoundsIterator aBegin, BoundsIterator aEnd,
+            BoundsIterator bBegin, BoundsIterator bEnd,
+            Bounds::List& result);
+
+    /**
+     * Same as intersection, but writing into the given result buffer
+     */
+    static void intersection(BoundsIterator aBegin, BoundsIterator aEnd,
+            BoundsIterator bBegin, BoundsIterator bEnd,
+            Bounds::List& result);
+
+    /**
+     * Same as looseIntersection, but writing into the given result buffer
+     */
+    static void looseIntersection(BoundsIterator aBegin, BoundsIterator aEnd,
+            BoundsIterator bBegin, BoundsIterator bEnd,
+            Bounds::List& result);
+
+    /**
+     * Check whether two interval lists contain the same intervals
+     */
+    static bool sameIntervals(BoundsIterator aBegin, BoundsIterator aEnd,
+            BoundsIterator bBegin, BoundsIterator bEnd,
+            Scratch& scratch);
+
+    /**
+     * Compute the new interval set of the pair (i,j) into scratch.result
+     * \return false if the network is inconsistent
+     */
+    static bool revise(const IntervalSets& sets, size_t i, size_t j, Scratch& scratch);
 };
 
 } // end namespace temporal
@@ -17,6 +17,10 @@ namespace temporal {
 
 QualitativeTemporalConstraintNetwork::QualitativeTemporalConstraintNetwork()
     : TemporalConstraintNetwork()
+    , mRelationMatrixGraph(NULL)
+    , mRelationMatrixRevision(0)
+    , mRelationMatrixNumberOfEdges(0)
+    , mRelationMatrixConsistent(true)
 {
 }
 
@@ -69,6 +73,10 @@ bool QualitativeTemporalConstraintNetwork::isConsistent(ValidationAlgorithm algo
                 return incrementalPathConsistency();
             case TCN_BEEK_MANAK:
                 return pathConsistency_BeekManak();
+            case TCN_MATRIX:
+                return pathConsistency_Matrix();
+            case TCN_MATRIX_PARALLEL:
+                return pathConsistency_Matrix(mNumberOfThreads);
             default:
                 throw std::invalid_argument("templ::solvers::temporal::QualitativeTemporalConstraintNetwork::isConsistent: given algorithm not supported");
         }
@@ -150,6 +158,111 @@ bool QualitativeTemporalConstraintNetwork::pathConsistency_BeekManak()
     return true;
 }
 
+bool QualitativeTemporalConstraintNetwork::pathConsistency_Matrix(size_t numberOfThreads)
+{
+    if(!updateRelationMatrix())
+    {
+        return false;
+    }
+    mRelationMatrixConsistent = mRelationMatrix.pathConsistency(numberOfThreads);
+    return mRelationMatrixConsistent;
+}
+
+const RelationMatrix& QualitativeTemporalConstraintNetwork::getRelationMatrix()
+{
+    updateRelationMatrix();
+    return mRelationMatrix;
+}
+
+const std::vector<Vertex::Ptr>& QualitativeTemporalConstraintNetwork::getRelationMatrixVertices()
+{
+    updateRelationMatrix();
+    return mRelationMatrixVertices;
+}
+
+bool QualitativeTemporalConstraintNetwork::updateRelationMatrix()
+{
+    BaseGraph::Ptr graph = getGraph();
+    if(mRelationMatrixGraph == graph.get()
+            && mRelationMatrixRevision == getRevision()
+            && mRelationMatrixVertices.size() == graph->order()
+            && mRelationMatrixNumberOfEdges == graph->size())
+    {
+        return mRelationMatrixConsistent;
+    }
+
+    mRelationMatrixVertices = graph->getAllVertices();
+    std::unordered_map<Vertex::Ptr, size_t> indices;
+    for(size_t i = 0; i < mRelationMatrixVertices.size(); ++i)
+    {
+        indices[ mRelationMatrixVertices[i] ] = i;
+    }
+
+    mRelationMatrix = RelationMatrix(mRelationMatrixVertices.size());
+    mRelationMatrixConsistent = true;
+
+    EdgeIterator::Ptr edgeIt = graph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        QualitativeTimePointConstraint::Ptr constraint = dynamic_pointer_cast<QualitativeTimePointConstraint>(edgeIt->current());
+        if(!constraint)
+        {
+            continue;
+        }
+
+        size_t i = indices[ constraint->getSourceVertex() ];
+        size_t j = indices[ constraint->getTargetVertex() ];
+        if(i != j && !mRelationMatrix.constrain(i, j, RelationMatrix::fromType(constraint->getType())))
+        {
+            mRelationMatrixConsistent = false;
+        }
+    }
+
+    mRelationMatrixGraph = graph.get();
+    mRelationMatrixRevision = getRevision();
+    mRelationMatrixNumberOfEdges = graph->size();
+    return mRelationMatrixConsistent;
+}
+
+void QualitativeTemporalConstraintNetwork::synchronizeGraph()
+{
+    if(!updateRelationMatrix())
+    {
+        throw std::runtime_error("templ::solvers::temporal::QualitativeTemporalConstraintNetwork::synchronizeGraph: relation matrix is inconsistent");
+    }
+
+    size_t numberOfVertices = mRelationMatrixVertices.size();
+    for(size_t i = 0; i < numberOfVertices; ++i)
+    {
+        const Vertex::Ptr& vi = mRelationMatrixVertices[i];
+        for(size_t j = i + 1; j < numberOfVertices; ++j)
+        {
+            RelationMatrix::Relation relation = mRelationMatrix.get(i,j);
+            if(relation == RelationMatrix::UNIVERSAL)
+            {
+                continue;
+            }
+
+            const Vertex::Ptr& vj = mRelationMatrixVertices[j];
+            QualitativeTimePointConstraint::Type type = RelationMatrix::toType(relation);
+            std::vector<Edge::Ptr> edges = getGraph()->getEdges(vi, vj);
+            if(!edges.empty())
+            {
+                QualitativeTimePointConstraint::Ptr constraint = dynamic_pointer_cast<QualitativeTimePointConstraint>(edges[0]);
+                if(constraint && constraint->getType() == type)
+                {
+                    continue;
+                }
+            }
+            setConstraintType(vi, vj, type);
+        }
+    }
+
+    // the graph now corresponds to the relation matrix
+    mRelationMatrixRevision = getRevision();
+    mRelationMatrixNumberOfEdges = getGraph()->size();
+}
+
 bool QualitativeTemporalConstraintNetwork::incrementalPathConsistency()
 {
     std::vector<Vertex::Ptr> vertices = getGraph()->getAllVertices();
@@ -429,6 +542,7 @@ void QualitativeTemporalConstraintNetwork::setConstraintType(const Vertex::Ptr&
     } else {
         QualitativeTimePointConstraint::Ptr constraint = dynamic_pointer_cast<QualitativeTimePointConstraint>(edges[0]);
         constraint->setType(type);
+        markModified();
     }
 }
 
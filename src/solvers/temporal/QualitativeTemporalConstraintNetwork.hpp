@@ -2,8 +2,10 @@
 #define TEMPL_SOLVERS_TEMPORAL_QUALITATIVE_TEMPORAL_CONSTRAINT_NETWORK
 
 #include <set>
+#include <unordered_map>
 #include "TemporalConstraintNetwork.hpp"
 #include "point_algebra/QualitativeTimePointConstraint.hpp"
+#include "point_algebra/RelationMatrix.hpp"
 
 namespace templ {
 namespace solvers {
@@ -23,7 +25,7 @@ public:
     typedef shared_ptr<QualitativeTemporalConstraintNetwork> Ptr;
     typedef std::pair<graph_analysis::Vertex::Ptr, graph_analysis::Vertex::Ptr> VertexPair;
 
-    enum ValidationAlgorithm { TCN_GECODE, TCN_INCREMENTAL, TCN_BEEK_MANAK };
+    enum ValidationAlgorithm { TCN_GECODE, TCN_INCREMENTAL, TCN_BEEK_MANAK, TCN_MATRIX, TCN_MATRIX_PARALLEL };
 
     /**
      * Constraint validation for a triangle relation
@@ -112,6 +114,38 @@ public:
     bool incrementalPathConsistency();
     bool pathConsistency_BeekManak();
 
+    /**
+     * Enforce path consistency on the relation matrix of this network (see
+     * getRelationMatrix), without modifying the graph
+     * \param numberOfThreads Number of threads to revise the matrix with, see
+     * point_algebra::RelationMatrix::pathConsistency; TCN_MATRIX_PARALLEL uses
+     * getNumberOfThreads()
+     * \return true if the network is consistent, false otherwise
+     */
+    bool pathConsistency_Matrix(size_t numberOfThreads = 1);
+
+    /**
+     * Get the dense relation matrix of this network, which is created from
+     * the graph if the network has been modified since the last call
+     *
+     * Rows and columns correspond to the vertices as returned by
+     * getRelationMatrixVertices
+     */
+    const point_algebra::RelationMatrix& getRelationMatrix();
+
+    /**
+     * Get the vertices in the order of the rows of the relation matrix
+     */
+    const std::vector<graph_analysis::Vertex::Ptr>& getRelationMatrixVertices();
+
+    /**
+     * Write the relations of the relation matrix, e.g., after
+     * pathConsistency_Matrix, back to the graph
+     *
+     * Only relations which are not universal are added to the graph
+     */
+    void synchronizeGraph();
+
     point_algebra::QualitativeTimePointConstraint::Type composition(const graph_analysis::Vertex::Ptr& i, const graph_analysis::Vertex::Ptr& j, const graph_analysis::Vertex::Ptr& k);
 
     VertexPair revise(const graph_analysis::Vertex::Ptr& i, const graph_analysis::Vertex::Ptr& j, point_algebra::QualitativeTimePointConstraint::Type pathConstraintType);
@@ -148,7 +182,23 @@ private:
      */
     bool isConsistent(const std::vector<graph_analysis::Edge::Ptr>& edges);
 
+    /**
+     * Create the relation matrix from the graph, if the network has been
+     * modified
+     * \return false if the constraints between two vertices are already
+     * inconsistent
+     */
+    bool updateRelationMatrix();
+
     std::set<VertexPair> mUpdatedConstraints;
+
+    point_algebra::RelationMatrix mRelationMatrix;
+    std::vector<graph_analysis::Vertex::Ptr> mRelationMatrixVertices;
+    /// State of the network for which the relation matrix has been created
+    const graph_analysis::BaseGraph* mRelationMatrixGraph;
+    uint64_t mRelationMatrixRevision;
+    size_t mRelationMatrixNumberOfEdges;
+    bool mRelationMatrixConsistent;
 };
 
 } // end namespace temporal
@@ -2,7 +2,6 @@
 #include <numeric/Combinatorics.hpp>
 #include <base-logging/Logging.hpp>
 #include <graph_analysis/WeightedEdge.hpp>
-#include <graph_analysis/algorithms/FloydWarshall.hpp>
 
 using namespace templ::solvers::temporal::point_algebra;
 using namespace graph_analysis;
@@ -11,12 +10,14 @@ namespace templ {
 namespace solvers {
 namespace temporal {
 
-SimpleTemporalNetwork::SimpleTemporalNetwork()
+SimpleTemporalNetwork::SimpleTemporalNetwork(bool incremental)
     : TemporalConstraintNetwork()
+    , mIncremental(incremental)
+    , mConsistent(true)
 {
 }
 
-void SimpleTemporalNetwork::addInterval(TimePoint::Ptr source, TimePoint::Ptr target, const Bounds& bounds)
+bool SimpleTemporalNetwork::addInterval(TimePoint::Ptr source, TimePoint::Ptr target, const Bounds& bounds)
 {
     // Upper and lower bound are added as edges in forward and backward
     // direction between two edges
@@ -24,19 +25,72 @@ void SimpleTemporalNetwork::addInterval(TimePoint::Ptr source, TimePoint::Ptr ta
     // B --- weight: - lower bound --> A
     // the lower bound will be added as negative cost
     using namespace graph_analysis;
+    WeightedEdge::Ptr forwardEdge(new WeightedEdge(bounds.getUpperBound()));
+    forwardEdge->setSourceVertex(source);
+    forwardEdge->setTargetVertex(target);
+    mpDistanceGraph->addEdge(forwardEdge);
+
+    WeightedEdge::Ptr backwardEdge(new WeightedEdge(- bounds.getLowerBound()));
+    backwardEdge->setSourceVertex(target);
+    backwardEdge->setTargetVertex(source);
+    mpDistanceGraph->addEdge(backwardEdge);
+
+    if(!mIncremental)
     {
-        WeightedEdge::Ptr edge(new WeightedEdge(bounds.getUpperBound()));
-        edge->setSourceVertex(source);
-        edge->setTargetVertex(target);
-        mpDistanceGraph->addEdge(edge);
+        return true;
     }
 
+    Addition addition;
+    addition.edges.push_back(forwardEdge);
+    addition.edges.push_back(backwardEdge);
+    addition.consistent = mConsistent;
+
+    // Once inconsistent the shortest paths are no longer maintained, until
+    // the interval causing the inconsistency has been retracted
+    if(mConsistent)
     {
-        WeightedEdge::Ptr edge(new WeightedEdge(- bounds.getLowerBound()));
-        edge->setSourceVertex(target);
-        edge->setTargetVertex(source);
-        mpDistanceGraph->addEdge(edge);
+        size_t s = getIndex(source);
+        size_t t = getIndex(target);
+        mConsistent = mDistances.addEdge(s, t, forwardEdge->getWeight(), &addition.changes)
+            && mDistances.addEdge(t, s, backwardEdge->getWeight(), &addition.changes);
     }
+    mAdditions.push_back(addition);
+    return mConsistent;
+}
+
+void SimpleTemporalNetwork::retractLastInterval()
+{
+    if(!mIncremental)
+    {
+        throw std::runtime_error("templ::solvers::temporal::SimpleTemporalNetwork::retractLastInterval: network is not in incremental mode");
+    }
+    if(mAdditions.empty())
+    {
+        throw std::runtime_error("templ::solvers::temporal::SimpleTemporalNetwork::retractLastInterval: no interval to retract");
+    }
+
+    const Addition& addition = mAdditions.back();
+    for(const Edge::Ptr& edge : addition.edges)
+    {
+        mpDistanceGraph->removeEdge(edge);
+    }
+    mDistances.undo(addition.changes);
+    mConsistent = addition.consistent;
+    mAdditions.pop_back();
+}
+
+size_t SimpleTemporalNetwork::getIndex(const TimePoint::Ptr& timepoint)
+{
+    std::unordered_map<Vertex::Ptr, size_t>::const_iterator cit = mIndices.find(timepoint);
+    if(cit != mIndices.end())
+    {
+        return cit->second;
+    }
+
+    size_t index = mDistances.size();
+    mDistances.resize(index + 1);
+    mIndices[timepoint] = index;
+    return index;
 }
 
 bool SimpleTemporalNetwork::isConsistent()
@@ -46,21 +100,16 @@ bool SimpleTemporalNetwork::isConsistent()
 
 bool SimpleTemporalNetwork::hasNegativeCycle()
 {
-    try {
-        // Throw when the shortest path computation identifies a negative cycle,
-        // i.e. an inconsistent network whose constraints can never be fulfilled
-        bool throwOnNegativeCycle = true;
-        algorithms::DistanceMatrix distanceMatrix = algorithms::FloydWarshall::allShortestPaths(mpDistanceGraph, [](Edge::Ptr e) -> double
-                {
-                    return dynamic_pointer_cast<WeightedEdge>(e)->getWeight();
-                }, throwOnNegativeCycle);
-
-        return false;
-    } catch(...)
+    if(mIncremental)
     {
-        return true;
+        return !mConsistent;
     }
 
+    // A negative cycle identifies an inconsistent network whose constraints
+    // can never be fulfilled
+    std::unordered_map<Vertex::Ptr, size_t> indices;
+    DenseDistanceMatrix distances = toDistanceMatrix(mpDistanceGraph, indices);
+    return !distances.allShortestPaths(mNumberOfThreads);
 }
 
 graph_analysis::BaseGraph::Ptr SimpleTemporalNetwork::propagate()
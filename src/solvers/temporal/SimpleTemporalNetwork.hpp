@@ -16,13 +16,35 @@ namespace temporal {
 class SimpleTemporalNetwork : public TemporalConstraintNetwork
 {
 public:
-    SimpleTemporalNetwork();
+    /**
+     * \param incremental If true, all shortest paths are maintained while
+     * intervals are added, so that each addInterval checks the consistency
+     * of the network and the last addition can be retracted. This requires
+     * intervals to be added only via addInterval.
+     */
+    SimpleTemporalNetwork(bool incremental = false);
 
     virtual ~SimpleTemporalNetwork() {}
 
     bool isConsistent();
 
-    void addInterval(point_algebra::TimePoint::Ptr source, point_algebra::TimePoint::Ptr target, const Bounds& bound);
+    /**
+     * Add an interval between two timepoints
+     * \return In incremental mode, false if the network is inconsistent after
+     * adding the interval, true otherwise. Without incremental mode
+     * consistency is not checked and true is returned.
+     */
+    bool addInterval(point_algebra::TimePoint::Ptr source, point_algebra::TimePoint::Ptr target, const Bounds& bound);
+
+    /**
+     * Retract the interval which has been added last (incremental mode
+     * only), restoring the consistency state from before its addition
+     * \throw std::runtime_error if not in incremental mode or if there is
+     * no interval to retract
+     */
+    void retractLastInterval();
+
+    bool isIncremental() const { return mIncremental; }
 
     /** Propagate and check for consistency using FloydWarshall algorithm
      * \return the resulting distance graph
@@ -36,6 +58,28 @@ protected:
      */
     bool hasNegativeCycle();
 
+private:
+    /**
+     * Record of an added interval to allow its retraction
+     */
+    struct Addition
+    {
+        std::vector<graph_analysis::Edge::Ptr> edges;
+        DenseDistanceMatrix::ChangeList changes;
+        bool consistent;
+    };
+
+    /**
+     * Get the index of a timepoint in the distance matrix, the timepoint is
+     * added if it is not known yet
+     */
+    size_t getIndex(const point_algebra::TimePoint::Ptr& timepoint);
+
+    bool mIncremental;
+    bool mConsistent;
+    DenseDistanceMatrix mDistances;
+    std::unordered_map<graph_analysis::Vertex::Ptr, size_t> mIndices;
+    std::vector<Addition> mAdditions;
 };
 
 } // end namespace temporal
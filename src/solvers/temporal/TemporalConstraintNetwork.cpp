@@ -1,8 +1,9 @@
 #include "TemporalConstraintNetwork.hpp"
 #include <graph_analysis/WeightedEdge.hpp>
-#include <graph_analysis/algorithms/FloydWarshall.hpp>
 #include <graph_analysis/GraphIO.hpp>
+#include <algorithm>
 #include <limits>
+#include <thread>
 #include <boost/lexical_cast.hpp>
 #include <numeric/Combinatorics.hpp>
 
@@ -20,6 +21,7 @@ namespace temporal {
 
 TemporalConstraintNetwork::TemporalConstraintNetwork()
     : mpDistanceGraph( BaseGraph::getInstance() )
+    , mNumberOfThreads( std::max(1u, std::thread::hardware_concurrency()) )
 {}
 
 TemporalConstraintNetwork::~TemporalConstraintNetwork()
@@ -28,6 +30,7 @@ TemporalConstraintNetwork::~TemporalConstraintNetwork()
 TemporalConstraintNetwork::TemporalConstraintNetwork(const TemporalConstraintNetwork& other)
     : ConstraintNetwork(other)
     , mpDistanceGraph(other.mpDistanceGraph->cloneEdges())
+    , mNumberOfThreads(other.mNumberOfThreads)
 {}
 
 
@@ -258,38 +261,66 @@ graph_analysis::BaseGraph::Ptr TemporalConstraintNetwork::toWeightedGraph()
     return graph;
 }
 
-//compute the minimal network of a simple temporal network using Floyd-Warshall
-void TemporalConstraintNetwork::minNetwork()
+DenseDistanceMatrix TemporalConstraintNetwork::toDistanceMatrix(const BaseGraph::Ptr& weightedGraph,
+        std::unordered_map<Vertex::Ptr, size_t>& indices)
 {
-    // Input: a simple temporal constraint network
-    TemporalConstraintNetwork tcn;
-    // Change its graph into a weighted graph and then apply Floyd-Warshall
-    BaseGraph::Ptr graph = (toWeightedGraph())->copy();
+    indices.clear();
+    VertexIterator::Ptr vertexIt = weightedGraph->getVertexIterator();
+    while(vertexIt->next())
+    {
+        indices.insert( std::make_pair(vertexIt->current(), indices.size()) );
+    }
 
-    BaseGraph::Ptr oldGraph = mpDistanceGraph->copy();
-    algorithms::DistanceMatrix distanceMatrix = algorithms::FloydWarshall::allShortestPaths(graph, [](Edge::Ptr e) -> double
-                {
-                    return dynamic_pointer_cast<WeightedEdge>(e)->getWeight();
-                });
-    EdgeIterator::Ptr edgeIt = oldGraph->getEdgeIterator();
+    DenseDistanceMatrix distances(indices.size());
+    EdgeIterator::Ptr edgeIt = weightedGraph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        WeightedEdge::Ptr edge = dynamic_pointer_cast<WeightedEdge>(edgeIt->current());
+        distances.relax(indices[ edge->getSourceVertex() ],
+                indices[ edge->getTargetVertex() ],
+                edge->getWeight());
+    }
+    return distances;
+}
+
+//compute the minimal network of a simple temporal network using Floyd-Warshall
+bool TemporalConstraintNetwork::minNetwork()
+{
+    // Change the graph into a weighted graph and then apply Floyd-Warshall
+    std::unordered_map<Vertex::Ptr, size_t> indices;
+    DenseDistanceMatrix distances = toDistanceMatrix(toWeightedGraph(), indices);
+    if(!distances.allShortestPaths(mNumberOfThreads))
+    {
+        LOG_DEBUG_S << "Network contains a negative cycle, i.e., is inconsistent";
+        return false;
+    }
 
     // Change again the computed graph into a graph using Interval Constraint representation
-    TimePoint::Ptr v1,v2;
+    TemporalConstraintNetwork tcn;
+    EdgeIterator::Ptr edgeIt = mpDistanceGraph->getEdgeIterator();
     while (edgeIt->next())
     {
         IntervalConstraint::Ptr edge = dynamic_pointer_cast<IntervalConstraint>(edgeIt->current());
-        v1 = edge->getSourceTimePoint();
-        v2 = edge->getTargetTimePoint();
-
-        double distance12 = distanceMatrix[std::pair<TimePoint::Ptr, TimePoint::Ptr>(v1,v2)];
-        double distance21 = distanceMatrix[std::pair<TimePoint::Ptr, TimePoint::Ptr>(v2,v1)];
-        distance21 = (-1)*distance21;
+        TimePoint::Ptr v1 = edge->getSourceTimePoint();
+        TimePoint::Ptr v2 = edge->getTargetTimePoint();
+        // timepoints of an edge without intervals are not part of the
+        // weighted graph and thus remain unconstrained
+        double distance12 = DenseDistanceMatrix::infinity();
+        double distance21 = -DenseDistanceMatrix::infinity();
+        std::unordered_map<Vertex::Ptr, size_t>::const_iterator it1 = indices.find(v1);
+        std::unordered_map<Vertex::Ptr, size_t>::const_iterator it2 = indices.find(v2);
+        if(it1 != indices.end() && it2 != indices.end())
+        {
+            distance12 = distances.get(it1->second, it2->second);
+            distance21 = -distances.get(it2->second, it1->second);
+        }
         IntervalConstraint::Ptr i(new IntervalConstraint(v1, v2));
         i->addInterval(Bounds(distance21,distance12));
         tcn.addIntervalConstraint(i);
     }
     // update mpDistanceGraph with the one that we just created (a simple temporal constraint network with the shortest paths computed)
-    mpDistanceGraph = tcn.mpDistanceGraph->copy();
+    mpDistanceGraph = tcn.mpDistanceGraph;
+    return true;
 }
 
 bool TemporalConstraintNetwork::equals(const graph_analysis::BaseGraph::Ptr& other)
@@ -361,30 +392,132 @@ bool TemporalConstraintNetwork::equals(const graph_analysis::BaseGraph::Ptr& oth
 // Upper-Lower-Tightening Algorithm
 void TemporalConstraintNetwork::upperLowerTightening()
 {
-    BaseGraph::Ptr oldGraph;
-    do
+    // The intervals of all edges are stored in a single flat list, where
+    // each edge refers to its range of intervals. Intersection can only
+    // remove or shrink intervals, so that the tightening operates in place
+    // and the graph is only updated once the fixpoint is reached
+    struct EdgeIntervals
+    {
+        IntervalConstraint::Ptr constraint;
+        size_t source;
+        size_t target;
+        size_t begin;
+        size_t count;
+        // upper-lower bounds of the intervals, i.e. the stp(N) relaxation
+        double lowerBound;
+        double upperBound;
+        // intervals changed since the last computation of the bounds
+        bool dirty;
+        // intervals changed since the start
+        bool modified;
+    };
+
+    std::vector<EdgeIntervals> edges;
+    Bounds::List intervals;
+    std::unordered_map<Vertex::Ptr, size_t> indices;
+    EdgeIterator::Ptr edgeIt = mpDistanceGraph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        IntervalConstraint::Ptr constraint = dynamic_pointer_cast<IntervalConstraint>(edgeIt->current());
+        if(!constraint)
+        {
+            continue;
+        }
+
+        EdgeIntervals edge;
+        edge.constraint = constraint;
+        edge.source = indices.insert( std::make_pair(constraint->getSourceVertex(), indices.size()) ).first->second;
+        edge.target = indices.insert( std::make_pair(constraint->getTargetVertex(), indices.size()) ).first->second;
+        edge.begin = intervals.size();
+        edge.count = constraint->getIntervals().size();
+        edge.lowerBound = 0;
+        edge.upperBound = 0;
+        edge.dirty = true;
+        edge.modified = false;
+        intervals.insert(intervals.end(), constraint->getIntervals().begin(), constraint->getIntervals().end());
+        edges.push_back(edge);
+    }
+
+    DenseDistanceMatrix distances(indices.size());
+    bool changed = true;
+    while(changed)
     {
-        // oldGraph = newGraph
-        oldGraph = mpDistanceGraph->copy();
-        stp();
-        minNetwork();
+        changed = false;
+
+        // N1 <- STP(N), N2 <- minimal network of N1
+        distances.reset();
+        for(EdgeIntervals& edge : edges)
+        {
+            if(edge.dirty)
+            {
+                if(edge.count == 0)
+                {
+                    throw std::runtime_error("templ::solvers::temporal::TemporalConstraintNetwork::upperLowerTightening: network is inconsistent -- no interval left for edge from '"
+                            + edge.constraint->getSourceVertex()->toString() + "' to '" + edge.constraint->getTargetVertex()->toString() + "'");
+                }
 
-        // copy oldGraph into a temporal constraint network
-        TemporalConstraintNetwork tcn;
+                edge.lowerBound = std::numeric_limits<double>::max();
+                edge.upperBound = std::numeric_limits<double>::min();
+                for(size_t i = edge.begin; i < edge.begin + edge.count; ++i)
+                {
+                    edge.lowerBound = std::min(intervals[i].getLowerBound(), edge.lowerBound);
+                    edge.upperBound = std::max(intervals[i].getUpperBound(), edge.upperBound);
+                }
+                edge.upperBound = std::max(edge.upperBound, edge.lowerBound + 1E-06);
+                edge.dirty = false;
+            }
+            distances.relax(edge.source, edge.target, edge.upperBound);
+            distances.relax(edge.target, edge.source, -edge.lowerBound);
+        }
 
-        // newGraph becomes the minimal network
-        EdgeIterator::Ptr edgeIt = oldGraph->getEdgeIterator();
-        while (edgeIt->next())
+        if(!distances.allShortestPaths(mNumberOfThreads))
         {
-            IntervalConstraint::Ptr intervalConstraint = dynamic_pointer_cast<IntervalConstraint>(edgeIt->current());
-            tcn.addIntervalConstraint(intervalConstraint);
+            throw std::runtime_error("templ::solvers::temporal::TemporalConstraintNetwork::upperLowerTightening: network is inconsistent -- negative cycle found");
         }
 
-        // apply intersection for oldGraph and newGraph(minimal network)
-        tcn.intersection(mpDistanceGraph);
-        // newGraph becomes the resulted graph obtained from the intersection between the oldGraph and the minimal network
-        mpDistanceGraph = tcn.mpDistanceGraph->copy();
-    } while (!this->equals(oldGraph)); // until newGraph = oldGraph
+        // N3 <- intersection between N2 and N
+        for(EdgeIntervals& edge : edges)
+        {
+            double lowerBound = -distances.get(edge.target, edge.source);
+            double upperBound = distances.get(edge.source, edge.target);
+
+            size_t count = 0;
+            for(size_t i = edge.begin; i < edge.begin + edge.count; ++i)
+            {
+                Bounds interval( std::max(intervals[i].getLowerBound(), lowerBound),
+                        std::min(intervals[i].getUpperBound(), upperBound) );
+                if(!interval.isValid())
+                {
+                    continue;
+                }
+                if(!(interval == intervals[i]))
+                {
+                    edge.dirty = true;
+                }
+                intervals[edge.begin + count++] = interval;
+            }
+            if(count != edge.count)
+            {
+                edge.count = count;
+                edge.dirty = true;
+            }
+
+            if(edge.dirty)
+            {
+                edge.modified = true;
+                changed = true;
+            }
+        }
+    } // until N3 = N
+
+    for(const EdgeIntervals& edge : edges)
+    {
+        if(edge.modified)
+        {
+            edge.constraint->setIntervals( Bounds::List(intervals.begin() + edge.begin,
+                        intervals.begin() + edge.begin + edge.count) );
+        }
+    }
 }
 
 int TemporalConstraintNetwork::getEdgeNumber()
@@ -578,6 +711,162 @@ TemporalConstraintNetwork::Assignment TemporalConstraintNetwork::getAssignment()
     return lowerBounds;
 }
 
+bool TemporalConstraintNetwork::getEarliestAssignment(Assignment& assignment, bool ignoreUpperBounds) const
+{
+    // constraint time(to) >= time(from) + weight
+    struct Arc
+    {
+        size_t from;
+        size_t to;
+        double weight;
+    };
+
+    TimePoint::PtrList timepoints;
+    std::unordered_map<Vertex::Ptr, size_t> indices;
+    VertexIterator::Ptr vertexIt = mpDistanceGraph->getVertexIterator();
+    while(vertexIt->next())
+    {
+        indices.insert( std::make_pair(vertexIt->current(), timepoints.size()) );
+        timepoints.push_back( dynamic_pointer_cast<TimePoint>(vertexIt->current()) );
+    }
+    if(timepoints.empty())
+    {
+        return false;
+    }
+
+    // lower bounds along the edges and upper bounds against them
+    std::vector<size_t> inDegree(timepoints.size(), 0);
+    std::vector< std::vector<size_t> > successors(timepoints.size());
+    std::vector<Arc> lowerArcs;
+    std::vector<Arc> upperArcs;
+    EdgeIterator::Ptr edgeIt = mpDistanceGraph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        IntervalConstraint::Ptr edge = dynamic_pointer_cast<IntervalConstraint>(edgeIt->current());
+        size_t from = indices[ edge->getSourceVertex() ];
+        size_t to = indices[ edge->getTargetVertex() ];
+        successors[from].push_back(to);
+        ++inDegree[to];
+
+        const std::vector<Bounds>& intervals = edge->getIntervals();
+        if(intervals.empty())
+        {
+            continue;
+        }
+
+        double lowerBound = -std::numeric_limits<double>::max();
+        double upperBound = std::numeric_limits<double>::max();
+        for(const Bounds& bounds : intervals)
+        {
+            lowerBound = std::max(bounds.getLowerBound(), lowerBound);
+            upperBound = std::min(bounds.getUpperBound(), upperBound);
+        }
+        if(lowerBound < 0 || (!ignoreUpperBounds && lowerBound > upperBound))
+        {
+            return false;
+        }
+
+        Arc lowerArc = { from, to, lowerBound };
+        lowerArcs.push_back(lowerArc);
+        if(!ignoreUpperBounds && upperBound < std::numeric_limits<double>::max())
+        {
+            Arc upperArc = { to, from, -upperBound };
+            upperArcs.push_back(upperArc);
+        }
+    }
+
+    // topological order (Kahn) starting from the single start point
+    std::vector<size_t> order;
+    order.reserve(timepoints.size());
+    for(size_t i = 0; i < timepoints.size(); ++i)
+    {
+        if(inDegree[i] == 0)
+        {
+            order.push_back(i);
+        }
+    }
+    if(order.size() != 1)
+    {
+        return false;
+    }
+    for(size_t o = 0; o < order.size(); ++o)
+    {
+        for(size_t successor : successors[ order[o] ])
+        {
+            if(--inDegree[successor] == 0)
+            {
+                order.push_back(successor);
+            }
+        }
+    }
+    if(order.size() != timepoints.size())
+    {
+        return false;
+    }
+
+    // Arcs sorted by the topological position of their source, so that a
+    // single pass over the lower bounds computes the longest paths
+    std::vector<size_t> position(timepoints.size());
+    for(size_t o = 0; o < order.size(); ++o)
+    {
+        position[ order[o] ] = o;
+    }
+    std::sort(lowerArcs.begin(), lowerArcs.end(), [&position](const Arc& a, const Arc& b)
+            {
+                return position[a.from] < position[b.from];
+            });
+
+    // Without negative lower bounds no timepoint can precede the start point
+    std::vector<double> earliest(timepoints.size(), 0.0);
+    for(size_t pass = 0; pass <= timepoints.size(); ++pass)
+    {
+        bool changed = false;
+        for(const Arc& arc : lowerArcs)
+        {
+            double time = earliest[arc.from] + arc.weight;
+            if(time > earliest[arc.to])
+            {
+                earliest[arc.to] = time;
+                changed = true;
+            }
+        }
+        if(upperArcs.empty())
+        {
+            break;
+        }
+        for(const Arc& arc : upperArcs)
+        {
+            double time = earliest[arc.from] + arc.weight;
+            if(time > earliest[arc.to])
+            {
+                earliest[arc.to] = time;
+                changed = true;
+            }
+        }
+        if(!changed)
+        {
+            break;
+        } else if(pass == timepoints.size())
+        {
+            // still changing, so upper and lower bounds form a positive
+            // cycle, i.e. the network is inconsistent
+            return false;
+        }
+    }
+    // the assignment is relative to the start point at time zero
+    if(earliest[ order.front() ] > 0)
+    {
+        return false;
+    }
+
+    assignment.clear();
+    for(size_t i = 0; i < timepoints.size(); ++i)
+    {
+        assignment[ timepoints[i] ] = earliest[i];
+    }
+    return true;
+}
+
 double TemporalConstraintNetwork::getTimeHorizon(const Assignment& assignments)
 {
     double horizon = 0;
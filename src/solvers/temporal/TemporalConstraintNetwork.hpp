@@ -1,8 +1,10 @@
 #ifndef TEMPL_SOLVERS_TEMPORAL_TEMPORAL_CONSTRAINT_NETWORK
 #define TEMPL_SOLVERS_TEMPORAL_TEMPORAL_CONSTRAINT_NETWORK
 
+#include <unordered_map>
 #include "../../ConstraintNetwork.hpp"
 #include "Bounds.hpp"
+#include "DenseDistanceMatrix.hpp"
 #include "point_algebra/TimePoint.hpp"
 #include "IntervalConstraint.hpp"
 #include "point_algebra/QualitativeTimePointConstraint.hpp"
@@ -22,6 +24,17 @@ protected:
     // graph to compute distance between vertices
     graph_analysis::BaseGraph::Ptr mpDistanceGraph;
 
+    // number of threads for the shortest path computation
+    size_t mNumberOfThreads;
+
+    /**
+     * Export a weighted graph into a dense distance matrix
+     * \param weightedGraph Graph of graph_analysis::WeightedEdge
+     * \param indices Will be filled with the row/column index of each vertex
+     */
+    static DenseDistanceMatrix toDistanceMatrix(const graph_analysis::BaseGraph::Ptr& weightedGraph,
+            std::unordered_map<graph_analysis::Vertex::Ptr, size_t>& indices);
+
 public:
     typedef shared_ptr<TemporalConstraintNetwork> Ptr;
     typedef std::map<point_algebra::TimePoint::Ptr, double> Assignment;
@@ -98,8 +111,19 @@ public:
 
     /**
      * \brief Compute the minimal network of a simple temporal network using the shortest-path algorithm (Floyd-Warshall)
+     * \details The distance graph is exported into a DenseDistanceMatrix, and
+     * the resulting bounds are written back once all shortest paths are known
+     * \return false if the network contains a negative cycle, i.e. is
+     * inconsistent -- the network remains unchanged then, true otherwise
      */
-    virtual void minNetwork();
+    virtual bool minNetwork();
+
+    /**
+     * Set the number of threads used for the shortest path computation,
+     * default is the number of hardware threads
+     */
+    void setNumberOfThreads(size_t numberOfThreads) { mNumberOfThreads = numberOfThreads; }
+    size_t getNumberOfThreads() const { return mNumberOfThreads; }
 
     /**
      * \brief Check if temporal constraint network has an equal DistanceGraph
@@ -117,7 +141,10 @@ public:
      *      N2 <- compute the minimal network of N1 (minNetwork)
      *      N3 <- intersection between N2 and N
      * until (N3 = N) or inconsistent
-     * \throw If we get an inconsistent network; the algorithm will throw (from Floyd-Warshall)
+     *
+     * The tightening is performed in place on the intervals of the existing
+     * edges, i.e. no intermediate networks are created
+     * \throw std::runtime_error If we get an inconsistent network
      * \see http://www.ics.uci.edu/~csp/R40.pdf
      */
     void upperLowerTightening();
@@ -171,6 +198,23 @@ public:
      */
     Assignment getAssignment() const;
 
+    /**
+     * Get the earliest time of each timepoint relative to the single start
+     * point (the timepoint without incoming edges)
+     *
+     * Multiple intervals of an edge are treated as conjunction (see
+     * stpWithConjunctiveIntervals). The lower bounds are propagated in a
+     * single longest path pass along the topological order of the network;
+     * finite upper bounds require additional Bellman-Ford passes.
+     * \param assignment Will be filled with the earliest time of each timepoint
+     * \param ignoreUpperBounds If true, only the lower bounds are considered,
+     * e.g., to quantify an assignment that violates the upper bounds
+     * \return false if the network is not a directed acyclic graph with a
+     * single start point, has negative lower bounds or inconsistent bounds;
+     * the assignment is undefined in this case
+     */
+    bool getEarliestAssignment(Assignment& assignment, bool ignoreUpperBounds = false) const;
+
     /**
      * Get the maximum assignment as time horizon
      */
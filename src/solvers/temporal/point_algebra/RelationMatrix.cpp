@@ -0,0 +1,249 @@
+#include "RelationMatrix.hpp"
+#include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include "../../../utils/ParallelFor.hpp"
+
+namespace templ {
+namespace solvers {
+namespace temporal {
+namespace point_algebra {
+
+const RelationMatrix::Relation RelationMatrix::EMPTY;
+const RelationMatrix::Relation RelationMatrix::LESS;
+const RelationMatrix::Relation RelationMatrix::EQUAL;
+const RelationMatrix::Relation RelationMatrix::GREATER;
+const RelationMatrix::Relation RelationMatrix::UNIVERSAL;
+constexpr RelationMatrix::Relation RelationMatrix::msComposition[8][8];
+
+RelationMatrix::RelationMatrix(size_t size)
+    : mSize(size)
+    , mRelations(size*size, UNIVERSAL)
+{
+    for(size_t i = 0; i < mSize; ++i)
+    {
+        mRelations[i*mSize + i] = EQUAL;
+    }
+}
+
+bool RelationMatrix::pathConsistency()
+{
+    // Queue of the pairs (i,j), i < j whose relation has been changed --
+    // universal relations cannot tighten any other relation, so that only
+    // the constrained pairs have to be considered initially
+    std::vector< std::pair<size_t, size_t> > queue;
+    std::vector<bool> queued(mSize*mSize, false);
+    for(size_t i = 0; i < mSize; ++i)
+    {
+        for(size_t j = i + 1; j < mSize; ++j)
+        {
+            Relation r = get(i,j);
+            if(r == EMPTY)
+            {
+                return false;
+            } else if(r != UNIVERSAL)
+            {
+                queue.push_back( std::make_pair(i,j) );
+                queued[i*mSize + j] = true;
+            }
+        }
+    }
+
+    while(!queue.empty())
+    {
+        size_t i = queue.back().first;
+        size_t j = queue.back().second;
+        queue.pop_back();
+        queued[i*mSize + j] = false;
+
+        Relation r_ij = get(i,j);
+        const Relation* row_i = &mRelations[i*mSize];
+        const Relation* row_j = &mRelations[j*mSize];
+        for(size_t k = 0; k < mSize; ++k)
+        {
+            if(k == i || k == j)
+            {
+                continue;
+            }
+
+            // r_ik = r_ik \cap (r_ij o r_jk)
+            Relation r_jk = row_j[k];
+            if(r_jk != UNIVERSAL)
+            {
+                Relation r_ik = row_i[k];
+                Relation revised = r_ik & composition(r_ij, r_jk);
+                if(revised != r_ik)
+                {
+                    if(revised == EMPTY)
+                    {
+                        return false;
+                    }
+                    set(i,k, revised);
+                    size_t a = std::min(i,k);
+                    size_t b = std::max(i,k);
+                    if(!queued[a*mSize + b])
+                    {
+                        queued[a*mSize + b] = true;
+                        queue.push_back( std::make_pair(a,b) );
+                    }
+                }
+            }
+
+            // r_kj = r_kj \cap (r_ki o r_ij)
+            Relation r_ki = converse(row_i[k]);
+            if(r_ki != UNIVERSAL)
+            {
+                Relation r_kj = converse(row_j[k]);
+                Relation revised = r_kj & composition(r_ki, r_ij);
+                if(revised != r_kj)
+                {
+                    if(revised == EMPTY)
+                    {
+                        return false;
+                    }
+                    set(k,j, revised);
+                    size_t a = std::min(k,j);
+                    size_t b = std::max(k,j);
+                    if(!queued[a*mSize + b])
+                    {
+                        queued[a*mSize + b] = true;
+                        queue.push_back( std::make_pair(a,b) );
+                    }
+                }
+            }
+        }
+    }
+    return true;
+}
+
+bool RelationMatrix::pathConsistency(size_t numberOfThreads)
+{
+    // Below this size the thread overhead outweighs the gain
+    static const size_t MIN_PARALLEL_SIZE = 64;
+    size_t numberOfWorkers = std::min(numberOfThreads, mSize);
+    if(numberOfWorkers <= 1 || mSize < MIN_PARALLEL_SIZE)
+    {
+        return pathConsistency();
+    }
+
+    if(std::find(mRelations.begin(), mRelations.end(), EMPTY) != mRelations.end())
+    {
+        return false;
+    }
+
+    std::vector<Relation> next(mRelations);
+    bool changed = true;
+    while(changed)
+    {
+        std::atomic<bool> anyChange(false);
+        std::atomic<bool> failed(false);
+
+        utils::parallelFor(mSize, numberOfWorkers, [this, &next, &anyChange, &failed](size_t i)
+            {
+                if(failed)
+                {
+                    return;
+                }
+                bool empty = false;
+                if(reviseRow(i, mRelations, next, empty))
+                {
+                    anyChange = true;
+                }
+                if(empty)
+                {
+                    failed = true;
+                }
+            });
+
+        if(failed)
+        {
+            return false;
+        }
+        changed = anyChange;
+        mRelations.swap(next);
+    }
+    return true;
+}
+
+bool RelationMatrix::reviseRow(size_t i, const std::vector<Relation>& source, std::vector<Relation>& target, bool& empty) const
+{
+    const Relation* row_i = &source[i*mSize];
+    Relation* revised = &target[i*mSize];
+    std::copy(row_i, row_i + mSize, revised);
+
+    for(size_t k = 0; k < mSize; ++k)
+    {
+        // a universal relation r_ik cannot tighten any relation r_ij
+        Relation r_ik = row_i[k];
+        if(r_ik == UNIVERSAL || k == i)
+        {
+            continue;
+        }
+
+        const Relation* row_k = &source[k*mSize];
+        const Relation* composed = msComposition[r_ik];
+        for(size_t j = 0; j < mSize; ++j)
+        {
+            revised[j] &= composed[ row_k[j] ];
+        }
+    }
+
+    bool changed = false;
+    for(size_t j = 0; j < mSize; ++j)
+    {
+        if(revised[j] != row_i[j])
+        {
+            changed = true;
+            if(revised[j] == EMPTY)
+            {
+                empty = true;
+            }
+        }
+    }
+    return changed;
+}
+
+RelationMatrix::Relation RelationMatrix::fromType(QualitativeTimePointConstraint::Type type)
+{
+    switch(type)
+    {
+        case QualitativeTimePointConstraint::Empty:
+            return EMPTY;
+        case QualitativeTimePointConstraint::Greater:
+            return GREATER;
+        case QualitativeTimePointConstraint::Less:
+            return LESS;
+        case QualitativeTimePointConstraint::Equal:
+            return EQUAL;
+        case QualitativeTimePointConstraint::Distinct:
+            return LESS | GREATER;
+        case QualitativeTimePointConstraint::GreaterOrEqual:
+            return GREATER | EQUAL;
+        case QualitativeTimePointConstraint::LessOrEqual:
+            return LESS | EQUAL;
+        case QualitativeTimePointConstraint::Universal:
+            return UNIVERSAL;
+        default:
+            throw std::invalid_argument("templ::solvers::temporal::point_algebra::RelationMatrix::fromType: invalid constraint type");
+    }
+}
+
+QualitativeTimePointConstraint::Type RelationMatrix::toType(Relation r)
+{
+    static const QualitativeTimePointConstraint::Type types[8] = {
+        QualitativeTimePointConstraint::Empty,
+        QualitativeTimePointConstraint::Less,
+        QualitativeTimePointConstraint::Equal,
+        QualitativeTimePointConstraint::LessOrEqual,
+        QualitativeTimePointConstraint::Greater,
+        QualitativeTimePointConstraint::Distinct,
+        QualitativeTimePointConstraint::GreaterOrEqual,
+        QualitativeTimePointConstraint::Universal
+    };
+    return types[r & UNIVERSAL];
+}
+
+} // end namespace point_algebra
+} // end namespace temporal
+} // end namespace solvers
+} // end namespace templ
@@ -0,0 +1,127 @@
+#ifndef TEMPL_SOLVERS_TEMPORAL_POINT_ALGEBRA_RELATION_MATRIX_HPP
+#define TEMPL_SOLVERS_TEMPORAL_POINT_ALGEBRA_RELATION_MATRIX_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "QualitativeTimePointConstraint.hpp"
+
+namespace templ {
+namespace solvers {
+namespace temporal {
+namespace point_algebra {
+
+/**
+ * \class RelationMatrix
+ * \brief Dense matrix of point algebra relations between n timepoints
+ *
+ * A relation is stored as bitmask of the primitive relations {<,=,>}, so that
+ * intersection is a bitwise and and composition a table lookup.
+ * The matrix is kept symmetric, i.e. setting the relation (i,j) also sets the
+ * converse relation (j,i).
+ */
+class RelationMatrix
+{
+public:
+    typedef uint8_t Relation;
+
+    static const Relation EMPTY = 0;
+    static const Relation LESS = 1;
+    static const Relation EQUAL = 2;
+    static const Relation GREATER = 4;
+    static const Relation UNIVERSAL = LESS | EQUAL | GREATER;
+
+    /**
+     * Create a matrix for the given number of timepoints, where all
+     * relations are universal
+     */
+    RelationMatrix(size_t size = 0);
+
+    size_t size() const { return mSize; }
+
+    Relation get(size_t i, size_t j) const { return mRelations[i*mSize + j]; }
+
+    /**
+     * Set relation (i,j) and the converse relation (j,i)
+     */
+    void set(size_t i, size_t j, Relation r)
+    {
+        mRelations[i*mSize + j] = r;
+        mRelations[j*mSize + i] = converse(r);
+    }
+
+    /**
+     * Intersect relation (i,j) with the given relation
+     * \return false if the resulting relation is empty
+     */
+    bool constrain(size_t i, size_t j, Relation r)
+    {
+        Relation intersection = get(i,j) & r;
+        set(i,j, intersection);
+        return intersection != EMPTY;
+    }
+
+    /**
+     * Enforce path consistency, i.e. r_ij = r_ij \cap (r_ik o r_kj) for all
+     * triangles (i,k,j)
+     *
+     * For point algebra networks path consistency decides consistency
+     * \return true if the network is consistent, false otherwise
+     */
+    bool pathConsistency();
+
+    /**
+     * Enforce path consistency using the given number of threads
+     *
+     * The relations are revised in rounds: each round computes
+     * r_ij = r_ij \cap (r_ik o r_kj) for all k from the matrix of the previous
+     * round, where the rows are distributed across the threads. Hence, the
+     * result does not depend on the number of threads and is identical to
+     * the result of pathConsistency()
+     * \param numberOfThreads Falls back to pathConsistency() if 1 or less,
+     * or if the matrix is too small to benefit from threading
+     * \return true if the network is consistent, false otherwise
+     */
+    bool pathConsistency(size_t numberOfThreads);
+
+    /**
+     * Composition of two relations
+     */
+    static constexpr Relation composition(Relation a, Relation b) { return msComposition[a][b]; }
+
+    /**
+     * Converse of a relation, i.e. swap < and >
+     */
+    static constexpr Relation converse(Relation r) { return (r & EQUAL) | ((r & LESS) << 2) | ((r & GREATER) >> 2); }
+
+    static Relation fromType(QualitativeTimePointConstraint::Type type);
+
+    static QualitativeTimePointConstraint::Type toType(Relation r);
+
+private:
+    /**
+     * Revise row i of the matrix from the given source matrix
+     * \return true if a relation of the row changed
+     */
+    bool reviseRow(size_t i, const std::vector<Relation>& source, std::vector<Relation>& target, bool& empty) const;
+
+    static constexpr Relation msComposition[8][8] = {
+        { 0, 0, 0, 0, 0, 0, 0, 0 },
+        { 0, 1, 1, 1, 7, 7, 7, 7 },
+        { 0, 1, 2, 3, 4, 5, 6, 7 },
+        { 0, 1, 3, 3, 7, 7, 7, 7 },
+        { 0, 7, 4, 7, 4, 7, 4, 7 },
+        { 0, 7, 5, 7, 7, 7, 7, 7 },
+        { 0, 7, 6, 7, 4, 7, 6, 7 },
+        { 0, 7, 7, 7, 7, 7, 7, 7 }
+    };
+
+    size_t mSize;
+    std::vector<Relation> mRelations;
+};
+
+} // end namespace point_algebra
+} // end namespace temporal
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_TEMPORAL_POINT_ALGEBRA_RELATION_MATRIX_HPP
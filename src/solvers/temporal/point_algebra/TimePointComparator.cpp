@@ -1,13 +1,149 @@
 #include "TimePointComparator.hpp"
 #include <base-logging/Logging.hpp>
 #include <algorithm>
+#include <mutex>
+#include <unordered_map>
 #include "../Interval.hpp"
+#include "../../../utils/BitSet.hpp"
 
 namespace templ {
 namespace solvers {
 namespace temporal {
 namespace point_algebra {
 
+/**
+ * Order of the qualitative timepoints as entailed by a consistent network
+ *
+ * A consistent point algebra network entails t_i <= t_j if and only if there
+ * is a path from t_i to t_j over the constraints <, <= and =, so that the
+ * order is given by the transitive closure of these constraints
+ */
+struct TimePointComparator::Order
+{
+    Order()
+        : graph(NULL)
+        , revision(0)
+        , numberOfVertices(0)
+        , numberOfEdges(0)
+        , valid(false)
+    {}
+
+    /**
+     * Recompute the order if the network has been modified
+     */
+    void update(const TemporalConstraintNetwork& tcn);
+
+    /**
+     * Get the index of a timepoint
+     * \return false if the timepoint is not part of the network
+     */
+    bool getIndex(const TimePoint::Ptr& t, size_t& index) const;
+
+    std::mutex mutex;
+
+    const graph_analysis::BaseGraph* graph;
+    uint64_t revision;
+    size_t numberOfVertices;
+    size_t numberOfEdges;
+    bool valid;
+
+    std::unordered_map<graph_analysis::Vertex::Ptr, size_t> indices;
+    /// Index of timepoints t_i for which t_i <= t_j is entailed (including j)
+    std::vector<utils::BitSet> lessOrEqual;
+};
+
+void TimePointComparator::Order::update(const TemporalConstraintNetwork& tcn)
+{
+    graph_analysis::BaseGraph::Ptr tcnGraph = tcn.getGraph();
+    if(valid && graph == tcnGraph.get()
+            && revision == tcn.getRevision()
+            && numberOfVertices == tcnGraph->order()
+            && numberOfEdges == tcnGraph->size())
+    {
+        return;
+    }
+
+    graph = tcnGraph.get();
+    revision = tcn.getRevision();
+    numberOfVertices = tcnGraph->order();
+    numberOfEdges = tcnGraph->size();
+
+    indices.clear();
+    graph_analysis::Vertex::PtrList vertices = tcnGraph->getAllVertices();
+    for(size_t i = 0; i < vertices.size(); ++i)
+    {
+        indices[ vertices[i] ] = i;
+    }
+
+    // successors[i] contains j, if t_i <= t_j is given by a constraint
+    std::vector< std::vector<size_t> > successors(vertices.size());
+    graph_analysis::EdgeIterator::Ptr edgeIt = tcnGraph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        QualitativeTimePointConstraint::Ptr constraint = dynamic_pointer_cast<QualitativeTimePointConstraint>(edgeIt->current());
+        if(!constraint)
+        {
+            continue;
+        }
+
+        size_t source = indices[ constraint->getSourceVertex() ];
+        size_t target = indices[ constraint->getTargetVertex() ];
+        switch(constraint->getType())
+        {
+            case QualitativeTimePointConstraint::Less:
+            case QualitativeTimePointConstraint::LessOrEqual:
+                successors[source].push_back(target);
+                break;
+            case QualitativeTimePointConstraint::Greater:
+            case QualitativeTimePointConstraint::GreaterOrEqual:
+                successors[target].push_back(source);
+                break;
+            case QualitativeTimePointConstraint::Equal:
+                successors[source].push_back(target);
+                successors[target].push_back(source);
+                break;
+            default:
+                break;
+        }
+    }
+
+    lessOrEqual.assign(vertices.size(), utils::BitSet());
+    std::vector<size_t> queue;
+    std::vector<bool> visited;
+    for(size_t i = 0; i < vertices.size(); ++i)
+    {
+        visited.assign(vertices.size(), false);
+        visited[i] = true;
+        queue.assign(1, i);
+        while(!queue.empty())
+        {
+            size_t current = queue.back();
+            queue.pop_back();
+            lessOrEqual[current].set(i);
+            for(size_t next : successors[current])
+            {
+                if(!visited[next])
+                {
+                    visited[next] = true;
+                    queue.push_back(next);
+                }
+            }
+        }
+    }
+    valid = true;
+}
+
+bool TimePointComparator::Order::getIndex(const TimePoint::Ptr& t, size_t& index) const
+{
+    std::unordered_map<graph_analysis::Vertex::Ptr, size_t>::const_iterator cit = indices.find(t);
+    if(cit != indices.end())
+    {
+        index = cit->second;
+        return true;
+    }
+    return false;
+}
+
 TimePointComparator::TimePointComparator(const TemporalConstraintNetwork::Ptr& tcn)
     : mpTemporalConstraintNetwork(tcn)
 {
@@ -15,10 +151,38 @@ TimePointComparator::TimePointComparator(const TemporalConstraintNetwork::Ptr& t
     {
         throw std::invalid_argument("templ::solvers::temporal::point_algebra::TimePointComparator: given constraint network is not consistent -- cannot construct comparator");
     }
+    if(mpTemporalConstraintNetwork)
+    {
+        mpOrder = make_shared<Order>();
+    }
 }
 
 void TimePointComparator::sort(std::vector<point_algebra::TimePoint::Ptr>& timepoints) const
 {
+    bool qualitative = mpOrder && std::all_of(timepoints.begin(), timepoints.end(), [](const point_algebra::TimePoint::Ptr& t)
+            {
+                return t && t->getType() == TimePoint::QUALITATIVE;
+            });
+
+    if(qualitative)
+    {
+        std::vector< std::pair<size_t, point_algebra::TimePoint::Ptr> > rankedTimepoints;
+        for(const point_algebra::TimePoint::Ptr& t : timepoints)
+        {
+            rankedTimepoints.push_back( std::make_pair(getRank(t), t) );
+        }
+        std::stable_sort(rankedTimepoints.begin(), rankedTimepoints.end(), [](const std::pair<size_t, point_algebra::TimePoint::Ptr>& a, const std::pair<size_t, point_algebra::TimePoint::Ptr>& b)
+                {
+                    return a.first < b.first;
+                }
+        );
+        for(size_t i = 0; i < timepoints.size(); ++i)
+        {
+            timepoints[i] = rankedTimepoints[i].second;
+        }
+        return;
+    }
+
     std::sort(timepoints.begin(), timepoints.end(), [this](const point_algebra::TimePoint::Ptr& a, const point_algebra::TimePoint::Ptr& b)
             {
                 if(a == b)
@@ -30,6 +194,47 @@ void TimePointComparator::sort(std::vector<point_algebra::TimePoint::Ptr>& timep
     );
 }
 
+bool TimePointComparator::isEntailedLessOrEqual(const TimePoint::Ptr& t0, const TimePoint::Ptr& t1) const
+{
+    std::lock_guard<std::mutex> lock(mpOrder->mutex);
+    mpOrder->update(*mpTemporalConstraintNetwork);
+
+    size_t i0;
+    size_t i1;
+    if(mpOrder->getIndex(t0, i0) && mpOrder->getIndex(t1, i1))
+    {
+        return mpOrder->lessOrEqual[i1].test(i0);
+    }
+    return false;
+}
+
+size_t TimePointComparator::getRank(const TimePoint::Ptr& t) const
+{
+    if(!mpOrder)
+    {
+        throw std::runtime_error("templ::solvers::temporal::point_algebra::TimePointComparator::getRank: no constraint network given to comparator");
+    }
+
+    std::lock_guard<std::mutex> lock(mpOrder->mutex);
+    mpOrder->update(*mpTemporalConstraintNetwork);
+
+    size_t index;
+    if(mpOrder->getIndex(t, index))
+    {
+        return mpOrder->lessOrEqual[index].count();
+    }
+    return 0;
+}
+
+void TimePointComparator::invalidate() const
+{
+    if(mpOrder)
+    {
+        std::lock_guard<std::mutex> lock(mpOrder->mutex);
+        mpOrder->valid = false;
+    }
+}
+
 bool TimePointComparator::equals(const TimePoint::Ptr& t0, const TimePoint::Ptr& t1) const
 {
     return t0->equals(t1);
@@ -66,23 +271,8 @@ bool TimePointComparator::greaterThan(const TimePoint::Ptr& t0, const TimePoint:
             throw std::runtime_error("templ::solvers::temporal::point_algebra::TimePointComparator::greaterThan: comparing qualitive timepoints, but not QualitativeTimePointConstraintNetwork given to comparator");
         }
 
-        graph_analysis::Edge::PtrList existingEdges = mpTemporalConstraintNetwork->getGraph()->getEdges(t0,t1);
-        QualitativeTimePointConstraint::Ptr constraint = mpTemporalConstraintNetwork->addQualitativeConstraint(t0, t1, point_algebra::QualitativeTimePointConstraint::Greater);
-        bool consistent = mpTemporalConstraintNetwork->isConsistent();
-
-        // Remove temporary addition
-        graph_analysis::Edge::PtrList tempEdges = mpTemporalConstraintNetwork->getGraph()->getEdges(t0,t1);
-        for(const graph_analysis::Edge::Ptr& e : tempEdges)
-        {
-            mpTemporalConstraintNetwork->getGraph()->removeEdge(e);
-        }
-
-        // Restore previous status
-        for(const graph_analysis::Edge::Ptr& e : existingEdges)
-        {
-            mpTemporalConstraintNetwork->getGraph()->addEdge(e);
-        }
-        return consistent;
+        // t0 > t1 is consistent with the network, unless t0 <= t1 is entailed
+        return !isEntailedLessOrEqual(t0, t1);
     } else {
         throw std::invalid_argument("templ::solvers::temporal::point_algebra::TimePointComparator::greaterThan: cannot compare this type of TimePoints");
     }
@@ -17,11 +17,25 @@ namespace point_algebra {
  * \class TimePointComparator
  * \brief This class allows to implement a custom TimePointComparator, e.g.,
  * to account for an existing set of qualitative / quantitative constraints
+ *
+ * For qualitative timepoints the order entailed by the constraint network is
+ * computed once and cached, so that comparisons are lookups. The cache is
+ * shared between copies of the comparator and recomputed when the revision,
+ * the graph or the number of vertices or edges of the network changes.
  */
 class TimePointComparator
 {
     TemporalConstraintNetwork::Ptr mpTemporalConstraintNetwork;
 
+    struct Order;
+    shared_ptr<Order> mpOrder;
+
+    /**
+     * Check whether t0 <= t1 is entailed by the constraint network, using
+     * the cached order
+     */
+    bool isEntailedLessOrEqual(const TimePoint::Ptr& t0, const TimePoint::Ptr& t1) const;
+
 public:
     /**
      * Default constructor
@@ -40,7 +54,11 @@ public:
 
     /**
      * Sort a list of timepoints based on this timepoint comparator (using the
-     * lessThan function
+     * lessThan function)
+     *
+     * Qualitative timepoints are sorted by their rank in the entailed order,
+     * timepoints which are not ordered by the network keep their relative
+     * position
      */
     void sort(std::vector<point_algebra::TimePoint::Ptr>& timepoints) const;
 
@@ -65,6 +83,21 @@ public:
     Interval getIntervalOverlap(const TimePoint::Ptr& a_start, const TimePoint::Ptr& a_end, const TimePoint::Ptr& b_start, const TimePoint::Ptr& b_end) const;
 
     bool inInterval(const TimePoint::Ptr& t0, const TimePoint::Ptr& i_start, const TimePoint::Ptr& i_end) const;
+
+    /**
+     * Get the rank of a qualitative timepoint, i.e. the number of timepoints
+     * (including itself) which are known to be lower or equal
+     *
+     * If t0 < t1 is entailed by the network, then rank(t0) < rank(t1)
+     * \return rank or 0 if the timepoint is not part of the network
+     */
+    size_t getRank(const TimePoint::Ptr& t) const;
+
+    /**
+     * Discard the cached order, e.g., after the type of a constraint has
+     * been changed directly
+     */
+    void invalidate() const;
 };
 
 } // end namespace point_algebra
@@ -37,6 +37,7 @@ public:
     void setViolation(const graph_analysis::algorithms::ConstraintViolation& violation) { mViolation = violation; }
 
     const Role& affectedRole() const;
+    const Role::List& getAffectedRoles() const { return mAffectedRoles; }
     void setAffectedRoles(const Role::List& roles) { mAffectedRoles = roles; }
 
     const csp::RoleTimeline& getRoleTimeline() const { return mRoleTimeline; }
@@ -115,7 +115,7 @@ void FlowNetwork::initialize(const std::map<Role, csp::RoleTimeline>& timelines,
                     RoleInfoWeightedEdge::Ptr weightedEdge =
                         make_shared<RoleInfoWeightedEdge>(edgeSourceTuple, edgeTargetTuple, capacity);
                     weightedEdge->addRole(role, RoleInfo::ASSIGNED);
-                    mSpaceTimeNetwork.getGraph()->addEdge(weightedEdge);
+                    mSpaceTimeNetwork.getMutableGraph()->addEdge(weightedEdge);
                 } else if(edges.size() > 1)
                 {
                     throw
@@ -169,7 +169,6 @@ transshipment::Flaw::List FlowNetwork::getInvalidTransitions(double feasibilityC
         {
             if(roleInfo->getWeight() < std::numeric_limits<uint32_t>::max())
             {
-                Role::Set roles = roleInfo->getRoles({ RoleInfo::ASSIGNED });
                 moreorg::ModelPool pool = roleInfo->getModelPool( { RoleInfo::ASSIGNED } );
 
                 LOG_INFO_S << "Checking for infeasible coalition on transition:"
@@ -187,6 +186,7 @@ transshipment::Flaw::List FlowNetwork::getInvalidTransitions(double feasibilityC
                     ConstraintViolation v(MultiCommodityEdge::Ptr(),
                             std::set<uint32_t>(), 0, 0,0, ConstraintViolation::TotalTransFlow);
 
+                    Role::Set roles = roleInfo->getRoles(RoleInfo::ASSIGNED);
                     SpaceTime::Network::tuple_t::Ptr from = dynamic_pointer_cast<SpaceTime::Network::tuple_t>(roleInfo->getSourceVertex());
                     SpaceTime::Network::tuple_t::Ptr to = dynamic_pointer_cast<SpaceTime::Network::tuple_t>(roleInfo->getTargetVertex());
 
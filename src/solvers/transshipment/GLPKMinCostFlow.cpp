@@ -0,0 +1,262 @@
+#include "GLPKMinCostFlow.hpp"
+#include <map>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <memory>
+#include <vector>
+#include <stdexcept>
+#include <base-logging/Logging.hpp>
+#include <graph_analysis/algorithms/MultiCommodityMinCostFlow.hpp>
+#include "../../SharedPtr.hpp"
+
+#ifdef WITH_GLPK
+#include <glpk.h>
+#endif
+
+using namespace graph_analysis;
+using namespace graph_analysis::algorithms;
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+const std::string GLPKMinCostFlow::SOLVER_NAME = "GLPK_IN_MEMORY";
+
+GLPKMinCostFlow::GLPKMinCostFlow(const BaseGraph::Ptr& flowGraph,
+        uint32_t commodities)
+    : mpFlowGraph(flowGraph)
+    , mCommodities(commodities)
+{}
+
+bool GLPKMinCostFlow::isAvailable()
+{
+#ifdef WITH_GLPK
+    return true;
+#else
+    return false;
+#endif
+}
+
+#ifdef WITH_GLPK
+namespace {
+
+/**
+ * Set the bounds of a column: [0, upperBound], where the maximum value
+ * represents an unbounded edge
+ */
+void setColumnBounds(glp_prob* problem, int column, uint32_t upperBound)
+{
+    if(upperBound == std::numeric_limits<uint32_t>::max())
+    {
+        glp_set_col_bnds(problem, column, GLP_LO, 0.0, 0.0);
+    } else if(upperBound == 0)
+    {
+        glp_set_col_bnds(problem, column, GLP_FX, 0.0, 0.0);
+    } else {
+        glp_set_col_bnds(problem, column, GLP_DB, 0.0, upperBound);
+    }
+}
+
+} // end anonymous namespace
+#endif
+
+LPSolver::Status GLPKMinCostFlow::solve()
+{
+#ifndef WITH_GLPK
+    throw std::runtime_error("templ::solvers::transshipment::GLPKMinCostFlow::solve: "
+            "templ has been built without GLPK -- select another lp/solver");
+#else
+    typedef MultiCommodityMinCostFlow::vertex_t MultiCommodityVertex;
+    typedef MultiCommodityMinCostFlow::edge_t MultiCommodityEdge;
+
+    base::Time modelStart = base::Time::now();
+
+    std::vector<MultiCommodityVertex::Ptr> vertices;
+    std::map<Vertex::Ptr, size_t> vertexIndex;
+    VertexIterator::Ptr vertexIt = mpFlowGraph->getVertexIterator();
+    while(vertexIt->next())
+    {
+        vertexIndex[vertexIt->current()] = vertices.size();
+        vertices.push_back(dynamic_pointer_cast<MultiCommodityVertex>(vertexIt->current()));
+    }
+
+    std::vector<MultiCommodityEdge::Ptr> edges;
+    EdgeIterator::Ptr edgeIt = mpFlowGraph->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        edges.push_back(dynamic_pointer_cast<MultiCommodityEdge>(edgeIt->current()));
+    }
+
+    const size_t numberOfColumns = edges.size()*mCommodities;
+    if(numberOfColumns == 0)
+    {
+        mModelTime = base::Time::now() - modelStart;
+        mSolveTime = base::Time();
+        return LPSolver::STATUS_OPTIMAL;
+    }
+
+    std::unique_ptr<glp_prob, void(*)(glp_prob*)> problem(glp_create_prob(), glp_delete_prob);
+    glp_prob* lp = problem.get();
+    glp_set_obj_dir(lp, GLP_MIN);
+
+    // Rows: flow balance per vertex and commodity, followed by the
+    // minimum trans flows and the joint edge capacities
+    std::vector<int> minTransFlowRows(vertices.size()*mCommodities, 0);
+    int numberOfRows = vertices.size()*mCommodities;
+    for(size_t v = 0; v < vertices.size(); ++v)
+    {
+        for(size_t k = 0; k < mCommodities; ++k)
+        {
+            if(vertices[v]->getCommodityMinTransFlow(k) > 0)
+            {
+                minTransFlowRows[v*mCommodities + k] = ++numberOfRows;
+            }
+        }
+    }
+    std::vector<int> capacityRows(edges.size(), 0);
+    if(mCommodities > 1)
+    {
+        for(size_t e = 0; e < edges.size(); ++e)
+        {
+            if(edges[e]->getCapacityUpperBound() != std::numeric_limits<uint32_t>::max())
+            {
+                capacityRows[e] = ++numberOfRows;
+            }
+        }
+    }
+
+    glp_add_rows(lp, numberOfRows);
+    for(size_t v = 0; v < vertices.size(); ++v)
+    {
+        for(size_t k = 0; k < mCommodities; ++k)
+        {
+            double supply = vertices[v]->getCommoditySupply(k);
+            glp_set_row_bnds(lp, v*mCommodities + k + 1, GLP_FX, supply, supply);
+
+            int row = minTransFlowRows[v*mCommodities + k];
+            if(row)
+            {
+                glp_set_row_bnds(lp, row, GLP_LO, vertices[v]->getCommodityMinTransFlow(k), 0.0);
+            }
+        }
+    }
+    for(size_t e = 0; e < edges.size(); ++e)
+    {
+        if(capacityRows[e])
+        {
+            glp_set_row_bnds(lp, capacityRows[e], GLP_UP, 0.0, edges[e]->getCapacityUpperBound());
+        }
+    }
+
+    // Columns: flow per edge and commodity
+    // GLPK arrays are 1-based, so that index 0 remains unused
+    std::vector<int> rowIndices(1, 0);
+    std::vector<int> columnIndices(1, 0);
+    std::vector<double> coefficients(1, 0.0);
+
+    glp_add_cols(lp, numberOfColumns);
+    for(size_t e = 0; e < edges.size(); ++e)
+    {
+        const MultiCommodityEdge::Ptr& edge = edges[e];
+        size_t source = vertexIndex[edge->getSourceVertex()];
+        size_t target = vertexIndex[edge->getTargetVertex()];
+        uint32_t capacity = edge->getCapacityUpperBound();
+
+        for(size_t k = 0; k < mCommodities; ++k)
+        {
+            int column = e*mCommodities + k + 1;
+            glp_set_col_kind(lp, column, GLP_IV);
+            glp_set_obj_coef(lp, column, edge->getCommodityCost(k));
+            setColumnBounds(lp, column, std::min<uint32_t>(capacity, edge->getCommodityCapacityUpperBound(k)));
+
+            // outflow of source and inflow of target (a loop does not
+            // change the balance, and GLPK rejects duplicate entries)
+            if(source != target)
+            {
+                rowIndices.push_back(source*mCommodities + k + 1);
+                columnIndices.push_back(column);
+                coefficients.push_back(1.0);
+                rowIndices.push_back(target*mCommodities + k + 1);
+                columnIndices.push_back(column);
+                coefficients.push_back(-1.0);
+            }
+
+            int minTransFlowRow = minTransFlowRows[target*mCommodities + k];
+            if(minTransFlowRow)
+            {
+                rowIndices.push_back(minTransFlowRow);
+                columnIndices.push_back(column);
+                coefficients.push_back(1.0);
+            }
+            if(capacityRows[e])
+            {
+                rowIndices.push_back(capacityRows[e]);
+                columnIndices.push_back(column);
+                coefficients.push_back(1.0);
+            }
+        }
+    }
+    glp_load_matrix(lp, coefficients.size() - 1, rowIndices.data(), columnIndices.data(), coefficients.data());
+    mModelTime = base::Time::now() - modelStart;
+
+    base::Time solveStart = base::Time::now();
+    glp_iocp parameters;
+    glp_init_iocp(&parameters);
+    parameters.presolve = GLP_ON;
+    parameters.msg_lev = GLP_MSG_OFF;
+    int result = glp_intopt(lp, &parameters);
+    mSolveTime = base::Time::now() - solveStart;
+
+    LPSolver::Status status = LPSolver::NO_SOLUTION_FOUND;
+    if(result == 0)
+    {
+        switch(glp_mip_status(lp))
+        {
+            case GLP_OPT:
+                status = LPSolver::STATUS_OPTIMAL;
+                break;
+            case GLP_FEAS:
+                status = LPSolver::SOLUTION_FOUND;
+                break;
+            case GLP_NOFEAS:
+                status = LPSolver::STATUS_INFEASIBLE;
+                break;
+            default:
+                status = LPSolver::STATUS_UNKNOWN;
+                break;
+        }
+    } else if(result == GLP_ENOPFS)
+    {
+        status = LPSolver::STATUS_INFEASIBLE;
+    } else if(result == GLP_ENODFS)
+    {
+        status = LPSolver::STATUS_UNBOUNDED;
+    }
+
+    bool hasSolution = (status == LPSolver::STATUS_OPTIMAL || status == LPSolver::SOLUTION_FOUND);
+    for(size_t e = 0; e < edges.size(); ++e)
+    {
+        for(size_t k = 0; k < mCommodities; ++k)
+        {
+            uint32_t flow = 0;
+            if(hasSolution)
+            {
+                flow = static_cast<uint32_t>(std::lround(glp_mip_col_val(lp, e*mCommodities + k + 1)));
+            }
+            edges[e]->setCommodityFlow(k, flow);
+        }
+    }
+
+    LOG_DEBUG_S << "GLPK min cost flow: " << numberOfRows << " rows, "
+        << numberOfColumns << " columns, status: " << status
+        << ", model time: " << mModelTime.toSeconds() << " s"
+        << ", solve time: " << mSolveTime.toSeconds() << " s";
+
+    return status;
+#endif
+}
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
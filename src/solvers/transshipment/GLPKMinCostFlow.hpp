@@ -0,0 +1,82 @@
+#ifndef TEMPL_SOLVERS_TRANSSHIPMENT_GLPK_MIN_COST_FLOW_HPP
+#define TEMPL_SOLVERS_TRANSSHIPMENT_GLPK_MIN_COST_FLOW_HPP
+
+#include <string>
+#include <base/Time.hpp>
+#include <graph_analysis/BaseGraph.hpp>
+#include <graph_analysis/algorithms/LPSolver.hpp>
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+/**
+ * In-memory solver for the multi-commodity min cost flow problem of a flow
+ * graph, using the C API of GLPK
+ *
+ * graph_analysis' MultiCommodityMinCostFlow writes the LP problem to a file,
+ * which is then loaded by the selected solver. This class builds the same
+ * problem directly in GLPK:
+ *  - one integer variable per edge and commodity, bounded by the commodity
+ *    capacity of the edge and weighted with the commodity cost
+ *  - the joint capacity of an edge limits the sum over all commodities
+ *  - outflow - inflow equals the supply (demand if negative) of a vertex
+ *  - the inflow of a vertex is at least its minimum trans flow
+ *
+ * After solving the commodity flows of all edges are updated, so that the
+ * result can be analysed via MultiCommodityMinCostFlow::validateInflow.
+ * Without a solution all flows are set to zero.
+ *
+ * GLPK has to be built with thread local storage (default), when solvers are
+ * used from multiple threads
+ */
+class GLPKMinCostFlow
+{
+public:
+    /// Value of TransportNetwork/search/options/lp/solver to select this
+    /// solver
+    static const std::string SOLVER_NAME;
+
+    /**
+     * \param flowGraph Flow graph with vertices and edges of type
+     * MultiCommodityMinCostFlow::vertex_t and MultiCommodityMinCostFlow::edge_t
+     * \param commodities Number of commodities
+     */
+    GLPKMinCostFlow(const graph_analysis::BaseGraph::Ptr& flowGraph,
+            uint32_t commodities);
+
+    /**
+     * Build the LP problem, solve it and update the commodity flows of the
+     * flow graph
+     * \return status of the solver
+     * \throw std::runtime_error if templ has been built without GLPK
+     */
+    graph_analysis::algorithms::LPSolver::Status solve();
+
+    /**
+     * Check whether templ has been built with GLPK
+     */
+    static bool isAvailable();
+
+    /**
+     * Get the time to build the LP problem in the last call to solve
+     */
+    const base::Time& getModelTime() const { return mModelTime; }
+
+    /**
+     * Get the time spent in the GLPK solver in the last call to solve
+     */
+    const base::Time& getSolveTime() const { return mSolveTime; }
+
+private:
+    graph_analysis::BaseGraph::Ptr mpFlowGraph;
+    uint32_t mCommodities;
+
+    base::Time mModelTime;
+    base::Time mSolveTime;
+};
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_TRANSSHIPMENT_GLPK_MIN_COST_FLOW_HPP
@@ -1,4 +1,5 @@
 #include "MinCostFlow.hpp"
+#include <algorithm>
 #include <base-logging/Logging.hpp>
 #include <graph_analysis/BipartiteGraph.hpp>
 #include <graph_analysis/WeightedEdge.hpp>
@@ -7,6 +8,7 @@
 #include <graph_analysis/algorithms/ConstraintViolation.hpp>
 
 #include "../FluentTimeResource.hpp"
+#include "GLPKMinCostFlow.hpp"
 #include "../../utils/Logger.hpp"
 
 using namespace graph_analysis;
@@ -17,6 +19,33 @@ namespace templ {
 namespace solvers {
 namespace transshipment {
 
+const size_t IncrementalFlowGraph::MIN_DISABLED_EDGES_FOR_REBUILD;
+
+IncrementalFlowGraph::IncrementalFlowGraph()
+    : mCommodities(0)
+    , mDisabledEdges(0)
+    , mCreatedEdges(0)
+    , mUpdatedEdges(0)
+    , mReusedEdges(0)
+    , mRebuilds(0)
+{}
+
+void IncrementalFlowGraph::clear()
+{
+    mpFlowGraph.reset();
+    mCommodities = 0;
+    mVertices.clear();
+    mEdges.clear();
+    mModifiedVertices.clear();
+    mDisabledEdges = 0;
+}
+
+bool IncrementalFlowGraph::requiresRebuild() const
+{
+    return mDisabledEdges >= MIN_DISABLED_EDGES_FOR_REBUILD
+        && mDisabledEdges > mEdges.size() - mDisabledEdges;
+}
+
 MinCostFlow::MinCostFlow(
         const std::map<Role, csp::RoleTimeline>& expandedTimelines,
         const std::map<Role, csp::RoleTimeline>& minRequiredTimelines,
@@ -25,7 +54,8 @@ MinCostFlow::MinCostFlow(
         const moreorg::OrganizationModelAsk& ask,
         const utils::Logger::Ptr& logger,
         graph_analysis::algorithms::LPSolver::Type solverType,
-        double feasibilityTimeoutInMs)
+        double feasibilityTimeoutInMs,
+        const IncrementalFlowGraph::Ptr& incrementalFlowGraph)
     : mExpandedTimelines(expandedTimelines)
     , mMinRequiredTimelines(minRequiredTimelines)
     , mSortedTimepoints(sortedTimepoints)
@@ -40,6 +70,9 @@ MinCostFlow::MinCostFlow(
     , mSpaceTimeNetwork(mFlowNetwork.getSpaceTimeNetwork())
     , mSolverType(solverType)
     , mFeasibilityTimeoutInMs(feasibilityTimeoutInMs)
+    , mpIncrementalFlowGraph(incrementalFlowGraph)
+    , mSaveFlowGraphs(true)
+    , mInMemorySolver(false)
 {
     // Create virtual start and end depot vertices and connect them with the
     // current start and end vertices
@@ -77,6 +110,11 @@ MinCostFlow::MinCostFlow(
 
 BaseGraph::Ptr MinCostFlow::createFlowGraph(uint32_t commodities)
 {
+    if(mpIncrementalFlowGraph)
+    {
+        return updateFlowGraph(commodities);
+    }
+
     BaseGraph::Ptr flowGraph = BaseGraph::getInstance();
 
     // Create the vertices of the flow, that can be mapped back to the space time
@@ -141,6 +179,144 @@ BaseGraph::Ptr MinCostFlow::createFlowGraph(uint32_t commodities)
     return flowGraph;
 }
 
+BaseGraph::Ptr MinCostFlow::updateFlowGraph(uint32_t commodities)
+{
+    IncrementalFlowGraph& cache = *mpIncrementalFlowGraph;
+    if(!cache.mpFlowGraph || cache.mCommodities != commodities || cache.requiresRebuild())
+    {
+        if(cache.mpFlowGraph && cache.mCommodities == commodities)
+        {
+            LOG_DEBUG_S << "Incremental flow graph: rebuilding, since " << cache.mDisabledEdges
+                << " of " << cache.mEdges.size() << " edges are disabled";
+            ++cache.mRebuilds;
+        }
+        cache.clear();
+        cache.mpFlowGraph = BaseGraph::getInstance();
+        cache.mCommodities = commodities;
+    } else {
+        // Reset supply and demand of the previous optimization
+        for(const MultiCommodityMinCostFlow::vertex_t::Ptr& vertex : cache.mModifiedVertices)
+        {
+            for(size_t i = 0; i < commodities; ++i)
+            {
+                vertex->setCommoditySupply(i, 0);
+                vertex->setCommodityMinTransFlow(i, 0);
+            }
+        }
+        cache.mModifiedVertices.clear();
+    }
+
+    VertexIterator::Ptr vertexIt = mSpaceTimeNetwork.getGraph()->getVertexIterator();
+    while(vertexIt->next())
+    {
+        SpaceTime::Network::tuple_t::Ptr tuple =
+            dynamic_pointer_cast<SpaceTime::Network::tuple_t>(vertexIt->current());
+
+        MultiCommodityMinCostFlow::vertex_t::Ptr& multicommodityVertex = cache.mVertices[tuple->getPair()];
+        if(!multicommodityVertex)
+        {
+            multicommodityVertex = make_shared<MultiCommodityMinCostFlow::vertex_t>(commodities);
+        }
+        mBipartiteGraph.linkVertices(multicommodityVertex, tuple);
+        multicommodityVertex->setLabel(tuple->toString());
+    }
+
+    // Edges which are not part of the current network will be disabled
+    std::set<IncrementalFlowGraph::EdgeKey> inactiveEdges;
+    for(const std::pair<const IncrementalFlowGraph::EdgeKey, IncrementalFlowGraph::EdgeEntry>& p : cache.mEdges)
+    {
+        if(p.second.bound != 0)
+        {
+            inactiveEdges.insert(p.first);
+        }
+    }
+
+    size_t activeEdges = 0;
+    EdgeIterator::Ptr edgeIt = mSpaceTimeNetwork.getGraph()->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        WeightedEdge::Ptr edge = dynamic_pointer_cast<WeightedEdge>(edgeIt->current());
+        ++activeEdges;
+
+        SpaceTime::Network::tuple_t::Ptr source = dynamic_pointer_cast<SpaceTime::Network::tuple_t>(edge->getSourceVertex());
+        SpaceTime::Network::tuple_t::Ptr target = dynamic_pointer_cast<SpaceTime::Network::tuple_t>(edge->getTargetVertex());
+
+        double weight = edge->getWeight();
+        uint32_t bound = 0;
+        if(weight == std::numeric_limits<double>::max())
+        {
+            bound = std::numeric_limits<uint32_t>::max();
+        } else {
+            bound = static_cast<uint32_t>(weight);
+        }
+
+        IncrementalFlowGraph::EdgeKey key(source->getPair(), target->getPair());
+        inactiveEdges.erase(key);
+
+        IncrementalFlowGraph::EdgeEntry& entry = cache.mEdges[key];
+        if(!entry.edge)
+        {
+            bool isHorizonStart = (source == SpaceTime::getHorizonStartTuple());
+            bool isHorizonEnd = (target == SpaceTime::getHorizonEndTuple());
+
+            entry.edge = make_shared<MultiCommodityMinCostFlow::edge_t>(commodities);
+            entry.edge->setSourceVertex( mBipartiteGraph.getUniquePartner(source) );
+            entry.edge->setTargetVertex( mBipartiteGraph.getUniquePartner(target) );
+            for(size_t i = 0; i < commodities; ++i)
+            {
+                if(isHorizonStart)
+                {
+                    entry.edge->setCommodityCost(i, std::numeric_limits<uint32_t>::max());
+                }
+                if(isHorizonEnd)
+                {
+                    entry.edge->setCommodityCost(i, 0);
+                }
+            }
+            cache.mpFlowGraph->addEdge(entry.edge);
+            ++cache.mCreatedEdges;
+        } else if(entry.bound == bound)
+        {
+            ++cache.mReusedEdges;
+            continue;
+        } else {
+            ++cache.mUpdatedEdges;
+        }
+
+        entry.bound = bound;
+        // Upper bound is the maximum edge capacity for a commodity
+        entry.edge->setCapacityUpperBound(bound);
+        for(size_t i = 0; i < commodities; ++i)
+        {
+            entry.edge->setCommodityCapacityUpperBound(i, bound);
+        }
+    }
+
+    // Edges which are not part of the current network (disabled now or
+    // before)
+    cache.mDisabledEdges = cache.mEdges.size() - std::min(cache.mEdges.size(), activeEdges);
+
+    for(const IncrementalFlowGraph::EdgeKey& key : inactiveEdges)
+    {
+        IncrementalFlowGraph::EdgeEntry& entry = cache.mEdges[key];
+        entry.bound = 0;
+        entry.edge->setCapacityUpperBound(0);
+        for(size_t i = 0; i < commodities; ++i)
+        {
+            entry.edge->setCommodityCapacityUpperBound(i, 0);
+        }
+        ++cache.mUpdatedEdges;
+    }
+
+    LOG_DEBUG_S << "Incremental flow graph: " << cache.mEdges.size() << " edges, "
+        << cache.mDisabledEdges << " disabled"
+        << " (overall created: " << cache.mCreatedEdges
+        << ", updated: " << cache.mUpdatedEdges
+        << ", reused: " << cache.mReusedEdges << ")";
+
+    return cache.mpFlowGraph;
+}
+
 void MinCostFlow::setCommoditySupplyAndDemand()
 {
     for(const std::pair<Role, csp::RoleTimeline>& p : mMinRequiredTimelines)
@@ -224,20 +400,49 @@ std::vector<Flaw> MinCostFlow::run(bool doThrow)
     using namespace graph_analysis;
     using namespace graph_analysis::algorithms;
 
+    base::Time flowGraphStart = base::Time::now();
     uint32_t numberOfCommodities = mCommoditiesRoles.size();
     BaseGraph::Ptr flowGraph = createFlowGraph(numberOfCommodities);
     setCommoditySupplyAndDemand();
     setDepotRestrictions(flowGraph, numberOfCommodities);
 
     MultiCommodityMinCostFlow minCostFlow(flowGraph, numberOfCommodities, mSolverType);
+    mFlowGraphTime = base::Time::now() - flowGraphStart;
+
     // LOGGING
+    if(mSaveFlowGraphs)
     {
         std::string filename  = mpLogger->filename("multicommodity-min-cost-flow-init.gexf");
         graph_analysis::io::GraphIO::write(filename, flowGraph);
     }
 
-    std::string prefixPath = mpLogger->filename("multicommodity-min-cost-flow");
-    algorithms::LPSolver::Status status = minCostFlow.solve(prefixPath);
+    algorithms::LPSolver::Status status;
+    if(mInMemorySolver)
+    {
+        // The commodity flows are written back to the flow graph, so that
+        // minCostFlow can be used to validate the result
+        GLPKMinCostFlow glpkMinCostFlow(flowGraph, numberOfCommodities);
+        status = glpkMinCostFlow.solve();
+        mModelTime = glpkMinCostFlow.getModelTime();
+        mSolveTime = glpkMinCostFlow.getSolveTime();
+        mProblemAndSolveTime = mModelTime + mSolveTime;
+    } else {
+        // solve() creates and writes the LP problem, loads it into the solver
+        // and runs the solver
+        base::Time solveStart = base::Time::now();
+        std::string prefixPath = mpLogger->filename("multicommodity-min-cost-flow");
+        status = minCostFlow.solve(prefixPath);
+        mProblemAndSolveTime = base::Time::now() - solveStart;
+        mModelTime = base::Time();
+        mSolveTime = base::Time();
+    }
+
+    LOG_INFO_S << "Min cost flow:"
+        << " flow graph time: " << mFlowGraphTime.toSeconds() << " s,"
+        << " problem and solve time: " << mProblemAndSolveTime.toSeconds() << " s"
+        << " (model time: " << mModelTime.toSeconds() << " s,"
+        << " solve time: " << mSolveTime.toSeconds() << " s)";
+
     switch(status)
     {
         case algorithms::LPSolver::SOLUTION_FOUND:
@@ -256,6 +461,7 @@ std::vector<Flaw> MinCostFlow::run(bool doThrow)
     }
 
     // LOGGING
+    if(mSaveFlowGraphs)
     {
         std::string filename  = mpLogger->filename("multicommodity-min-cost-flow-final-flow.gexf");
         graph_analysis::io::GraphIO::write(filename, flowGraph);
@@ -418,6 +624,10 @@ void MinCostFlow::setMinTransFlow(const SpaceTime::Network::tuple_t::Ptr& tuple,
     // set minimum flow that needs to go through this node
     // for this commodity (i.e. can be either 0 or 1)
     multicommodityVertex->setCommodityMinTransFlow(commodityId, value);
+    if(mpIncrementalFlowGraph)
+    {
+        mpIncrementalFlowGraph->mModifiedVertices.insert(multicommodityVertex);
+    }
     tuple->addRole(role, RoleInfo::REQUIRED);
 }
 
@@ -431,6 +641,10 @@ void MinCostFlow::setSupplyDemand(const SpaceTime::Network::tuple_t::Ptr& tuple,
     // set minimum flow that needs to go through this node
     // for this commodity (i.e. can be either 0 or 1)
     multicommodityVertex->setCommoditySupply(commodityId, value);
+    if(mpIncrementalFlowGraph)
+    {
+        mpIncrementalFlowGraph->mModifiedVertices.insert(multicommodityVertex);
+    }
     if(value >= 0)
     {
         tuple->addRole(role, RoleInfo::AVAILABLE);
@@ -1,7 +1,10 @@
 #ifndef TEMPL_SOLVER_TRANSSHIPMENT_MINCOSTFLOW_HPP
 #define TEMPL_SOLVER_TRANSSHIPMENT_MINCOSTFLOW_HPP
 
+#include <set>
+#include <map>
 #include <vector>
+#include <base/Time.hpp>
 #include <graph_analysis/BipartiteGraph.hpp>
 #include <graph_analysis/algorithms/MultiCommodityMinCostFlow.hpp>
 #include "../../Mission.hpp"
@@ -20,6 +23,88 @@ struct MinCostFlowStatus
     uint32_t commodities;
 };
 
+class MinCostFlow;
+
+/**
+ * Flow graph that is kept alive between consecutive min cost flow
+ * optimizations
+ *
+ * Consecutive solutions of the same mission typically differ in only a few
+ * transitions. Instead of creating the flow graph from scratch for each
+ * optimization, vertices and edges are reused (identified by their space time
+ * points) and only changed capacities, supplies and demands are applied.
+ * Edges which are not part of the current space time network remain in the
+ * graph, but are disabled by a zero capacity. Once the disabled edges
+ * outnumber the enabled ones (see MIN_DISABLED_EDGES_FOR_REBUILD), the graph
+ * is rebuilt from scratch, so that it does not grow over a long search.
+ *
+ * An instance must not be used by multiple MinCostFlow objects concurrently
+ */
+class IncrementalFlowGraph
+{
+    friend class MinCostFlow;
+public:
+    typedef shared_ptr<IncrementalFlowGraph> Ptr;
+
+    IncrementalFlowGraph();
+
+    /**
+     * Remove all vertices and edges, so that the next optimization starts
+     * from scratch
+     */
+    void clear();
+
+    /**
+     * Number of edges which have been created, updated or reused (without
+     * any change) over all optimizations
+     */
+    uint64_t getNumberOfCreatedEdges() const { return mCreatedEdges; }
+    uint64_t getNumberOfUpdatedEdges() const { return mUpdatedEdges; }
+    uint64_t getNumberOfReusedEdges() const { return mReusedEdges; }
+
+    /**
+     * Number of times the graph has been rebuilt to drop disabled edges
+     */
+    uint64_t getNumberOfRebuilds() const { return mRebuilds; }
+
+    /**
+     * Number of edges which are not part of the last optimization
+     */
+    size_t getNumberOfDisabledEdges() const { return mDisabledEdges; }
+
+private:
+    /// Minimum number of disabled edges before the graph is rebuilt
+    static const size_t MIN_DISABLED_EDGES_FOR_REBUILD = 256;
+
+    /**
+     * Check whether the disabled edges outweigh the enabled ones
+     */
+    bool requiresRebuild() const;
+
+    typedef std::pair<SpaceTime::Point, SpaceTime::Point> EdgeKey;
+
+    struct EdgeEntry
+    {
+        graph_analysis::algorithms::MultiCommodityMinCostFlow::edge_t::Ptr edge;
+        /// Currently applied capacity upper bound, 0 for disabled edges
+        uint32_t bound;
+    };
+
+    graph_analysis::BaseGraph::Ptr mpFlowGraph;
+    uint32_t mCommodities;
+
+    std::map<SpaceTime::Point, graph_analysis::algorithms::MultiCommodityMinCostFlow::vertex_t::Ptr> mVertices;
+    std::map<EdgeKey, EdgeEntry> mEdges;
+    /// Vertices with supply, demand or min trans flow of the last optimization
+    std::set<graph_analysis::algorithms::MultiCommodityMinCostFlow::vertex_t::Ptr> mModifiedVertices;
+    size_t mDisabledEdges;
+
+    uint64_t mCreatedEdges;
+    uint64_t mUpdatedEdges;
+    uint64_t mReusedEdges;
+    uint64_t mRebuilds;
+};
+
 class MinCostFlow
 {
 public:
@@ -30,6 +115,8 @@ public:
      * requirements
      * \param expandedTimeline optional timelines which serve as a guide for mobile system flow
      * result of the multi-commodity min-cost flow optimization
+     * \param incrementalFlowGraph optional flow graph of a previous
+     * optimization that should be updated instead of creating a new one
      */
     MinCostFlow(
             const std::map<Role, csp::RoleTimeline>& expandedTimelines,
@@ -39,7 +126,8 @@ public:
             const moreorg::OrganizationModelAsk& ask,
             const utils::Logger::Ptr& logger,
             graph_analysis::algorithms::LPSolver::Type solverType = graph_analysis::algorithms::LPSolver::GLPK_SOLVER,
-            double feasibilityTimeoutInMs = 1000
+            double feasibilityTimeoutInMs = 1000,
+            const IncrementalFlowGraph::Ptr& incrementalFlowGraph = IncrementalFlowGraph::Ptr()
             );
 
     /**
@@ -52,6 +140,45 @@ public:
     std::vector<Flaw> run(bool doThrow = false);
 
     FlowNetwork& getFlowNetwork() { return mFlowNetwork; }
+
+    /**
+     * Enable/Disable saving the flow graphs of each optimization to the log
+     * directory (enabled by default)
+     */
+    void setSaveFlowGraphs(bool enable) { mSaveFlowGraphs = enable; }
+
+    /**
+     * Enable/Disable solving the LP problem in memory via GLPKMinCostFlow
+     * instead of the LPSolver of graph_analysis (disabled by default)
+     */
+    void setInMemorySolver(bool enable) { mInMemorySolver = enable; }
+
+    /**
+     * Get the time required to set up the multi-commodity flow graph
+     * (including supplies, demands and depot restrictions) in the last run
+     */
+    const base::Time& getFlowGraphTime() const { return mFlowGraphTime; }
+
+    /**
+     * Get the time to create and solve the LP problem in the last run
+     *
+     * For graph_analysis' LPSolver this is the time spent in
+     * MultiCommodityMinCostFlow::solve, which also writes the problem file
+     * and loads it into the solver
+     */
+    const base::Time& getProblemAndSolveTime() const { return mProblemAndSolveTime; }
+
+    /**
+     * Get the time to build the LP problem in the last run -- only measured
+     * by the in-memory solver, zero otherwise
+     */
+    const base::Time& getModelTime() const { return mModelTime; }
+
+    /**
+     * Get the time spent in the LP solver in the last run -- only measured
+     * by the in-memory solver, zero otherwise
+     */
+    const base::Time& getSolveTime() const { return mSolveTime; }
 protected:
     /**
      *  Translating the space time network into the mincommodity representation,
@@ -69,6 +196,13 @@ protected:
      */
     graph_analysis::BaseGraph::Ptr createFlowGraph(uint32_t commodities);
 
+    /**
+     * Update the incremental flow graph to represent the current space time
+     * network, and fill the BipartiteGraph accordingly
+     * \see createFlowGraph
+     */
+    graph_analysis::BaseGraph::Ptr updateFlowGraph(uint32_t commodities);
+
     /**
      *  Set the commodity supply and demand
      *  Since the general transport network is constructed from mobile systems,
@@ -155,6 +289,15 @@ private:
     graph_analysis::algorithms::LPSolver::Type mSolverType;
 
     double mFeasibilityTimeoutInMs;
+
+    IncrementalFlowGraph::Ptr mpIncrementalFlowGraph;
+
+    bool mSaveFlowGraphs;
+    bool mInMemorySolver;
+    base::Time mFlowGraphTime;
+    base::Time mProblemAndSolveTime;
+    base::Time mModelTime;
+    base::Time mSolveTime;
 };
 
 } // end namespace transshipment
@@ -0,0 +1,286 @@
+#include "MinCostFlowCache.hpp"
+#include <algorithm>
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+namespace {
+// FNV-1a 64-bit
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+void hashBytes(uint64_t& h, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < size; ++i)
+    {
+        h ^= bytes[i];
+        h *= FNV_PRIME;
+    }
+}
+
+void hashString(uint64_t& h, const std::string& s)
+{
+    hashBytes(h, s.data(), s.size());
+    // separator to avoid ambiguity of concatenated strings
+    uint64_t size = s.size();
+    hashBytes(h, &size, sizeof(size));
+}
+
+void hashTimelines(uint64_t& h, const MinCostFlowCache::Timelines& timelines)
+{
+    uint64_t size = timelines.size();
+    hashBytes(h, &size, sizeof(size));
+    for(const MinCostFlowCache::Timelines::value_type& v : timelines)
+    {
+        hashString(h, v.first.toString());
+        const SpaceTime::Timeline& timeline = v.second.getTimeline();
+        uint64_t timelineSize = timeline.size();
+        hashBytes(h, &timelineSize, sizeof(timelineSize));
+        for(const SpaceTime::Point& point : timeline)
+        {
+            hashString(h, point.first ? point.first->getInstanceName() : std::string());
+            hashString(h, point.second ? point.second->getLabel() : std::string());
+        }
+    }
+}
+
+void appendString(std::string& key, const std::string& s)
+{
+    uint64_t size = s.size();
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    key.append(s);
+}
+
+void appendTimelines(std::string& key, const MinCostFlowCache::Timelines& timelines)
+{
+    uint64_t size = timelines.size();
+    key.append(reinterpret_cast<const char*>(&size), sizeof(size));
+    for(const MinCostFlowCache::Timelines::value_type& v : timelines)
+    {
+        appendString(key, v.first.toString());
+        const SpaceTime::Timeline& timeline = v.second.getTimeline();
+        uint64_t timelineSize = timeline.size();
+        key.append(reinterpret_cast<const char*>(&timelineSize), sizeof(timelineSize));
+        for(const SpaceTime::Point& point : timeline)
+        {
+            appendString(key, point.first ? point.first->getInstanceName() : std::string());
+            appendString(key, point.second ? point.second->getLabel() : std::string());
+        }
+    }
+}
+
+} // end anonymous namespace
+
+MinCostFlowCache::MinCostFlowCache(size_t maxSize, size_t numberOfShards)
+    : mMaxSize(maxSize)
+    , mActiveShards(1)
+    , mHits(0)
+    , mMisses(0)
+    , mEvictions(0)
+    , mCollisions(0)
+{
+    numberOfShards = std::max<size_t>(1, numberOfShards);
+    for(size_t i = 0; i < numberOfShards; ++i)
+    {
+        mShards.push_back(make_shared<Shard>());
+    }
+    distribute(maxSize);
+}
+
+uint64_t MinCostFlowCache::hash(const Timelines& expandedTimelines,
+        const Timelines& minRequiredTimelines)
+{
+    uint64_t h = FNV_OFFSET_BASIS;
+    hashTimelines(h, expandedTimelines);
+    hashTimelines(h, minRequiredTimelines);
+    return h;
+}
+
+std::string MinCostFlowCache::canonicalKey(const Timelines& expandedTimelines,
+        const Timelines& minRequiredTimelines)
+{
+    std::string key;
+    appendTimelines(key, expandedTimelines);
+    appendTimelines(key, minRequiredTimelines);
+    return key;
+}
+
+bool MinCostFlowCache::equals(const Key& a, const Key& b)
+{
+    return !(a < b) && !(b < a);
+}
+
+std::unique_lock<std::mutex> MinCostFlowCache::lockShard(uint64_t hash, Shard*& shard)
+{
+    while(true)
+    {
+        // use the upper bits, since the lower bits are used by the index
+        size_t activeShards = mActiveShards.load();
+        shard = mShards[(hash >> 32) % activeShards].get();
+        std::unique_lock<std::mutex> lock(shard->mutex);
+        // the number of used shards might have changed while waiting for the
+        // lock
+        if(activeShards == mActiveShards.load())
+        {
+            return lock;
+        }
+    }
+}
+
+void MinCostFlowCache::distribute(size_t maxSize)
+{
+    size_t activeShards = std::max<size_t>(1, std::min(mShards.size(), maxSize));
+    for(size_t i = 0; i < mShards.size(); ++i)
+    {
+        Shard& shard = *mShards[i];
+        shard.capacity = 0;
+        if(i < activeShards)
+        {
+            shard.capacity = maxSize / activeShards + (i < maxSize % activeShards ? 1 : 0);
+        }
+    }
+
+    if(activeShards != mActiveShards.load())
+    {
+        // move all entries to their new shard, keeping the order of use
+        // per shard
+        EntryList entries;
+        for(const shared_ptr<Shard>& shard : mShards)
+        {
+            entries.splice(entries.end(), shard->entries);
+            shard->index.clear();
+        }
+        mActiveShards = activeShards;
+        for(EntryList::reverse_iterator it = entries.rbegin(); it != entries.rend(); ++it)
+        {
+            Shard& shard = *mShards[(it->hash >> 32) % activeShards];
+            shard.entries.push_front(*it);
+            shard.index.insert(std::make_pair(it->hash, shard.entries.begin()));
+        }
+    }
+
+    for(const shared_ptr<Shard>& shard : mShards)
+    {
+        evict(*shard);
+    }
+}
+
+MinCostFlowCache::ValuePtr MinCostFlowCache::lookup(uint64_t hash, const Key& key)
+{
+    Shard* shardPtr = NULL;
+    std::unique_lock<std::mutex> lock = lockShard(hash, shardPtr);
+    Shard& shard = *shardPtr;
+
+    typedef std::unordered_multimap<uint64_t, EntryList::iterator>::iterator IndexIterator;
+    std::pair<IndexIterator, IndexIterator> range = shard.index.equal_range(hash);
+    for(IndexIterator it = range.first; it != range.second; ++it)
+    {
+        EntryList::iterator entryIt = it->second;
+        if(equals(entryIt->key, key))
+        {
+            // mark as most recently used
+            shard.entries.splice(shard.entries.begin(), shard.entries, entryIt);
+            ++mHits;
+            return entryIt->value;
+        }
+        ++mCollisions;
+    }
+    ++mMisses;
+    return ValuePtr();
+}
+
+void MinCostFlowCache::insert(uint64_t hash, const Key& key, const Value& value)
+{
+    ValuePtr valuePtr = make_shared<const Value>(value);
+
+    Shard* shardPtr = NULL;
+    std::unique_lock<std::mutex> lock = lockShard(hash, shardPtr);
+    Shard& shard = *shardPtr;
+
+    typedef std::unordered_multimap<uint64_t, EntryList::iterator>::iterator IndexIterator;
+    std::pair<IndexIterator, IndexIterator> range = shard.index.equal_range(hash);
+    for(IndexIterator it = range.first; it != range.second; ++it)
+    {
+        EntryList::iterator entryIt = it->second;
+        if(equals(entryIt->key, key))
+        {
+            entryIt->value = valuePtr;
+            shard.entries.splice(shard.entries.begin(), shard.entries, entryIt);
+            return;
+        }
+    }
+
+    Entry entry;
+    entry.hash = hash;
+    entry.key = key;
+    entry.value = valuePtr;
+    shard.entries.push_front(entry);
+    shard.index.insert(std::make_pair(hash, shard.entries.begin()));
+
+    evict(shard);
+}
+
+void MinCostFlowCache::evict(Shard& shard)
+{
+    while(shard.entries.size() > shard.capacity)
+    {
+        EntryList::iterator last = --shard.entries.end();
+
+        typedef std::unordered_multimap<uint64_t, EntryList::iterator>::iterator IndexIterator;
+        std::pair<IndexIterator, IndexIterator> range = shard.index.equal_range(last->hash);
+        for(IndexIterator it = range.first; it != range.second; ++it)
+        {
+            if(it->second == last)
+            {
+                shard.index.erase(it);
+                break;
+            }
+        }
+        shard.entries.erase(last);
+        ++mEvictions;
+    }
+}
+
+void MinCostFlowCache::setMaxSize(size_t maxSize)
+{
+    // lock all shards in order, since entries might move between shards
+    std::vector< std::unique_lock<std::mutex> > locks;
+    for(const shared_ptr<Shard>& shard : mShards)
+    {
+        locks.push_back( std::unique_lock<std::mutex>(shard->mutex) );
+    }
+    mMaxSize = maxSize;
+    distribute(maxSize);
+}
+
+MinCostFlowCache::Statistics MinCostFlowCache::getStatistics() const
+{
+    Statistics statistics;
+    statistics.hits = mHits.load();
+    statistics.misses = mMisses.load();
+    statistics.evictions = mEvictions.load();
+    statistics.collisions = mCollisions.load();
+    statistics.size = 0;
+    for(const shared_ptr<Shard>& shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        statistics.size += shard->entries.size();
+    }
+    return statistics;
+}
+
+void MinCostFlowCache::clear()
+{
+    for(const shared_ptr<Shard>& shard : mShards)
+    {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->entries.clear();
+        shard->index.clear();
+    }
+}
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
@@ -0,0 +1,163 @@
+#ifndef TEMPL_SOLVERS_TRANSSHIPMENT_MIN_COST_FLOW_CACHE_HPP
+#define TEMPL_SOLVERS_TRANSSHIPMENT_MIN_COST_FLOW_CACHE_HPP
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include "../../SharedPtr.hpp"
+#include "../../SpaceTime.hpp"
+#include "../csp/RoleTimeline.hpp"
+#include "Flaw.hpp"
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+/**
+ * Thread-safe and size bounded cache for the results of the min cost flow
+ * optimization
+ *
+ * Entries are indexed by a canonical 64-bit hash of the expanded and
+ * the minimum required timelines. Since different keys can map to the same
+ * hash, the full key is verified on a hash hit.
+ * The cache is split into shards, each protected by a separate mutex and
+ * with its own least-recently-used eviction order. The maximum size is
+ * distributed exactly over the shards, so that fewer shards are used when
+ * the maximum size is smaller than the number of shards
+ */
+class MinCostFlowCache
+{
+public:
+    typedef std::map<Role, csp::RoleTimeline> Timelines;
+    /// Key: expanded timelines and minimum required timelines
+    typedef std::pair<Timelines, Timelines> Key;
+    /// Value: flaws and the resulting space time network
+    typedef std::pair< std::vector<Flaw>, SpaceTime::Network> Value;
+    typedef shared_ptr<const Value> ValuePtr;
+
+    struct Statistics
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t evictions;
+        /// Number of hash hits which failed the full key verification
+        uint64_t collisions;
+        size_t size;
+    };
+
+    /**
+     * Construct cache
+     * \param maxSize Maximum number of entries in the cache
+     * \param numberOfShards Number of independently locked partitions
+     */
+    MinCostFlowCache(size_t maxSize = 1000, size_t numberOfShards = 16);
+
+    /**
+     * Compute the canonical hash for the given timelines
+     *
+     * The hash depends only on roles, location names and timepoint labels and
+     * is thus stable across processes
+     */
+    static uint64_t hash(const Timelines& expandedTimelines,
+            const Timelines& minRequiredTimelines);
+
+    /**
+     * Compute the canonical representation of the given timelines, i.e., the
+     * data which is hashed by hash()
+     *
+     * In contrast to the key itself, it can be stored and compared across
+     * processes
+     */
+    static std::string canonicalKey(const Timelines& expandedTimelines,
+            const Timelines& minRequiredTimelines);
+
+    /**
+     * Lookup an entry
+     * \param hash Hash of the key as computed by hash()
+     * \param key Key to verify the entry against
+     * \return the cached value if found, an empty pointer otherwise
+     */
+    ValuePtr lookup(uint64_t hash, const Key& key);
+
+    /**
+     * Insert an entry -- an existing entry with the same key will be replaced
+     * and least recently used entries are evicted if the size bound is
+     * exceeded
+     */
+    void insert(uint64_t hash, const Key& key, const Value& value);
+
+    /**
+     * Set the maximum number of cache entries
+     *
+     * Entries are redistributed if the number of used shards changes
+     */
+    void setMaxSize(size_t maxSize);
+
+    size_t getMaxSize() const { return mMaxSize.load(); }
+
+    /**
+     * Get the current cache statistics
+     */
+    Statistics getStatistics() const;
+
+    /**
+     * Remove all entries
+     */
+    void clear();
+
+private:
+    struct Entry
+    {
+        uint64_t hash;
+        Key key;
+        ValuePtr value;
+    };
+    typedef std::list<Entry> EntryList;
+
+    struct Shard
+    {
+        Shard()
+            : capacity(0)
+        {}
+
+        std::mutex mutex;
+        /// Maximum number of entries of this shard
+        size_t capacity;
+        /// Entries in order of their use, most recently used first
+        EntryList entries;
+        std::unordered_multimap<uint64_t, EntryList::iterator> index;
+    };
+
+    static bool equals(const Key& a, const Key& b);
+
+    /**
+     * Lock the shard of the given hash
+     * \return lock of the shard which holds the entries for this hash
+     */
+    std::unique_lock<std::mutex> lockShard(uint64_t hash, Shard*& shard);
+
+    /// Distribute the maximum size over the shards -- all shards have to be locked
+    void distribute(size_t maxSize);
+
+    /// Remove least recently used entries until the size bound holds
+    void evict(Shard& shard);
+
+    std::vector< shared_ptr<Shard> > mShards;
+    std::atomic<size_t> mMaxSize;
+    /// Number of shards in use, i.e., min(number of shards, maximum size)
+    std::atomic<size_t> mActiveShards;
+
+    std::atomic<uint64_t> mHits;
+    std::atomic<uint64_t> mMisses;
+    std::atomic<uint64_t> mEvictions;
+    std::atomic<uint64_t> mCollisions;
+};
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_TRANSSHIPMENT_MIN_COST_FLOW_CACHE_HPP
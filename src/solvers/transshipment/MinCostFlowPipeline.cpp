@@ -0,0 +1,85 @@
+#include "MinCostFlowPipeline.hpp"
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+MinCostFlowPipeline::MinCostFlowPipeline(size_t numberOfWorkers, size_t maxQueueSize)
+    : mMaxQueueSize(std::max<size_t>(1, maxQueueSize))
+    , mStop(false)
+{
+    numberOfWorkers = std::max<size_t>(1, numberOfWorkers);
+    for(size_t i = 0; i < numberOfWorkers; ++i)
+    {
+        mWorkers.push_back(std::thread(&MinCostFlowPipeline::work, this));
+    }
+}
+
+MinCostFlowPipeline::~MinCostFlowPipeline()
+{
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStop = true;
+        mQueue.clear();
+    }
+    mJobAvailable.notify_all();
+    mSlotAvailable.notify_all();
+
+    for(std::thread& worker : mWorkers)
+    {
+        worker.join();
+    }
+}
+
+MinCostFlowPipeline::Future MinCostFlowPipeline::submit(const Job& job)
+{
+    shared_ptr<Task> task = make_shared<Task>(job);
+    Future future = task->get_future().share();
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        mSlotAvailable.wait(lock, [this]{ return mStop || mQueue.size() < mMaxQueueSize; });
+        if(mStop)
+        {
+            throw std::runtime_error("templ::solvers::transshipment::MinCostFlowPipeline::submit: "
+                    "pipeline has been stopped");
+        }
+        mQueue.push_back(task);
+    }
+    mJobAvailable.notify_one();
+    return future;
+}
+
+bool MinCostFlowPipeline::isReady(const Future& future)
+{
+    return future.valid() &&
+        future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void MinCostFlowPipeline::work()
+{
+    while(true)
+    {
+        shared_ptr<Task> task;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            mJobAvailable.wait(lock, [this]{ return mStop || !mQueue.empty(); });
+            if(mStop)
+            {
+                return;
+            }
+            task = mQueue.front();
+            mQueue.pop_front();
+        }
+        mSlotAvailable.notify_one();
+
+        // exceptions are forwarded through the future
+        (*task)();
+    }
+}
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
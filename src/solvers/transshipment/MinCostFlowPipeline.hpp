@@ -0,0 +1,78 @@
+#ifndef TEMPL_SOLVERS_TRANSSHIPMENT_MIN_COST_FLOW_PIPELINE_HPP
+#define TEMPL_SOLVERS_TRANSSHIPMENT_MIN_COST_FLOW_PIPELINE_HPP
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <functional>
+#include <condition_variable>
+#include "MinCostFlowCache.hpp"
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+/**
+ * Pool of worker threads which evaluate min cost flow problems
+ * asynchronously
+ *
+ * Jobs are collected in a bounded queue: submitting a job blocks while the
+ * queue is full, so that the producer (the CSP search) cannot run arbitrarily
+ * far ahead of the LP evaluation
+ */
+class MinCostFlowPipeline
+{
+public:
+    typedef shared_ptr<MinCostFlowPipeline> Ptr;
+    /// Result: flaws and the resulting space time network
+    typedef MinCostFlowCache::Value Result;
+    typedef std::shared_future<Result> Future;
+    typedef std::function<Result()> Job;
+
+    /**
+     * Start the workers
+     * \param numberOfWorkers Number of worker threads
+     * \param maxQueueSize Maximum number of jobs waiting for evaluation
+     */
+    MinCostFlowPipeline(size_t numberOfWorkers = 2, size_t maxQueueSize = 4);
+
+    /**
+     * Stop the workers -- jobs which have not been started are dropped, i.e.
+     * their future will report a broken promise
+     */
+    ~MinCostFlowPipeline();
+
+    /**
+     * Add a job to the queue -- blocks while the queue is full
+     * \return future to retrieve the result or the exception thrown by the job
+     */
+    Future submit(const Job& job);
+
+    size_t getNumberOfWorkers() const { return mWorkers.size(); }
+    size_t getMaxQueueSize() const { return mMaxQueueSize; }
+
+    /**
+     * Check whether the result of a future is available
+     */
+    static bool isReady(const Future& future);
+
+private:
+    typedef std::packaged_task<Result()> Task;
+
+    void work();
+
+    size_t mMaxQueueSize;
+    std::vector<std::thread> mWorkers;
+
+    std::mutex mMutex;
+    std::condition_variable mJobAvailable;
+    std::condition_variable mSlotAvailable;
+    std::deque< shared_ptr<Task> > mQueue;
+    bool mStop;
+};
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_TRANSSHIPMENT_MIN_COST_FLOW_PIPELINE_HPP
@@ -0,0 +1,630 @@
+#include "PersistentMinCostFlowCache.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include <boost/archive/text_oarchive.hpp>
+#include <boost/archive/text_iarchive.hpp>
+#include <boost/serialization/vector.hpp>
+#include <boost/serialization/set.hpp>
+#include <boost/serialization/string.hpp>
+#include <base-logging/Logging.hpp>
+#include <moreorg/facades/Robot.hpp>
+
+namespace pa = templ::solvers::temporal::point_algebra;
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+namespace {
+
+const char FILE_MAGIC[8] = { 'T','E','M','P','L','L','P','C' };
+const uint32_t FILE_VERSION = 2;
+const uint32_t RECORD_MAGIC = 0x4c504352; // LPCR
+
+struct FileHeader
+{
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+};
+
+/// A record header is followed by the canonical key and the payload
+struct RecordHeader
+{
+    uint32_t magic;
+    uint32_t keySize;
+    uint64_t fingerprint;
+    uint64_t hash;
+    uint64_t payloadSize;
+    /// Checksum of canonical key and payload
+    uint64_t checksum;
+};
+
+// FNV-1a 64-bit
+uint64_t fnv1a(uint64_t h, const void* data, size_t size)
+{
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for(size_t i = 0; i < size; ++i)
+    {
+        h ^= bytes[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+uint64_t fnv1a(uint64_t h, const std::string& s)
+{
+    h = fnv1a(h, s.data(), s.size());
+    uint64_t size = s.size();
+    return fnv1a(h, &size, sizeof(size));
+}
+
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ULL;
+
+/// Location and timepoint by name
+struct PointRecord
+{
+    std::string location;
+    std::string timepoint;
+
+    PointRecord() {}
+
+    PointRecord(const SpaceTime::Point& point)
+        : location(point.first ? point.first->getInstanceName() : std::string())
+        , timepoint(point.second ? point.second->getLabel() : std::string())
+    {}
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & location;
+        ar & timepoint;
+    }
+};
+
+struct FlawRecord
+{
+    int type;
+    int32_t delta;
+    uint32_t inFlow;
+    std::set<uint32_t> commodities;
+    std::vector<Role> roles;
+    PointRecord from;
+    PointRecord to;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & type;
+        ar & delta;
+        ar & inFlow;
+        ar & commodities;
+        ar & roles;
+        ar & from;
+        ar & to;
+    }
+};
+
+struct TupleRecord
+{
+    PointRecord point;
+    std::string roles;
+    std::string taggedRoles;
+    std::string attributes;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & point;
+        ar & roles;
+        ar & taggedRoles;
+        ar & attributes;
+    }
+};
+
+struct EdgeRecord
+{
+    uint32_t source;
+    uint32_t target;
+    double weight;
+    std::string roles;
+    std::string taggedRoles;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & source;
+        ar & target;
+        ar & weight;
+        ar & roles;
+        ar & taggedRoles;
+    }
+};
+
+struct Record
+{
+    std::vector<FlawRecord> flaws;
+    std::vector<TupleRecord> tuples;
+    std::vector<EdgeRecord> edges;
+
+    template<class Archive>
+    void serialize(Archive& ar, const unsigned int version)
+    {
+        ar & flaws;
+        ar & tuples;
+        ar & edges;
+    }
+};
+
+std::string toPayload(const PersistentMinCostFlowCache::Value& value)
+{
+    using namespace graph_analysis;
+
+    Record record;
+    for(const Flaw& flaw : value.first)
+    {
+        algorithms::ConstraintViolation violation = flaw.getViolation();
+
+        FlawRecord flawRecord;
+        flawRecord.type = static_cast<int>(violation.getType());
+        flawRecord.delta = violation.getDelta();
+        flawRecord.inFlow = violation.getInFlow();
+        flawRecord.commodities = violation.getCommodities();
+        flawRecord.from = PointRecord(flaw.getFromSpaceTime());
+        flawRecord.to = PointRecord(flaw.getToSpaceTime());
+        flawRecord.roles = std::vector<Role>(flaw.getAffectedRoles().begin(), flaw.getAffectedRoles().end());
+        record.flaws.push_back(flawRecord);
+    }
+
+    const SpaceTime::Network& network = value.second;
+    std::map<Vertex::Ptr, uint32_t> vertexIndex;
+    VertexIterator::Ptr vertexIt = network.getGraph()->getVertexIterator();
+    while(vertexIt->next())
+    {
+        SpaceTime::Network::tuple_t::Ptr tuple =
+            dynamic_pointer_cast<SpaceTime::Network::tuple_t>(vertexIt->current());
+        if(!tuple)
+        {
+            throw std::invalid_argument("templ::solvers::transshipment::PersistentMinCostFlowCache: "
+                    "space time network contains vertex which is not a tuple");
+        }
+
+        TupleRecord tupleRecord;
+        tupleRecord.point = PointRecord(tuple->getPair());
+        tupleRecord.roles = tuple->serializeRoles();
+        tupleRecord.taggedRoles = tuple->serializeTaggedRoles();
+        tupleRecord.attributes = tuple->serializeRoleInfoAttributes();
+
+        vertexIndex[tuple] = record.tuples.size();
+        record.tuples.push_back(tupleRecord);
+    }
+
+    EdgeIterator::Ptr edgeIt = network.getGraph()->getEdgeIterator();
+    while(edgeIt->next())
+    {
+        RoleInfoWeightedEdge::Ptr edge = dynamic_pointer_cast<RoleInfoWeightedEdge>(edgeIt->current());
+        if(!edge)
+        {
+            continue;
+        }
+        EdgeRecord edgeRecord;
+        edgeRecord.source = vertexIndex[edge->getSourceVertex()];
+        edgeRecord.target = vertexIndex[edge->getTargetVertex()];
+        edgeRecord.weight = edge->getWeight();
+        edgeRecord.roles = edge->serializeRoles();
+        edgeRecord.taggedRoles = edge->serializeTaggedRoles();
+        record.edges.push_back(edgeRecord);
+    }
+
+    std::stringstream ss;
+    boost::archive::text_oarchive oarch(ss);
+    oarch << record;
+    return ss.str();
+}
+
+} // end anonymous namespace
+
+PersistentMinCostFlowCache::PersistentMinCostFlowCache(const std::string& filename, size_t maxFileSize)
+    : mFilename(filename)
+    , mMaxFileSize(maxFileSize)
+    , mFileDescriptor(-1)
+    , mpData(NULL)
+    , mMappedSize(0)
+    , mIndexedSize(sizeof(FileHeader))
+    , mHits(0)
+    , mMisses(0)
+    , mWrites(0)
+{
+    mFileDescriptor = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if(mFileDescriptor < 0)
+    {
+        throw std::runtime_error("templ::solvers::transshipment::PersistentMinCostFlowCache: "
+                "failed to open cache file '" + filename + "': " + strerror(errno));
+    }
+
+    if(flock(mFileDescriptor, LOCK_EX) != 0)
+    {
+        std::string error = strerror(errno);
+        close(mFileDescriptor);
+        throw std::runtime_error("templ::solvers::transshipment::PersistentMinCostFlowCache: "
+                "failed to lock cache file '" + filename + "': " + error);
+    }
+    struct stat fileStat;
+    fstat(mFileDescriptor, &fileStat);
+
+    FileHeader header;
+    if(fileStat.st_size == 0)
+    {
+        memcpy(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC));
+        header.version = FILE_VERSION;
+        header.reserved = 0;
+        if(pwrite(mFileDescriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header)))
+        {
+            flock(mFileDescriptor, LOCK_UN);
+            close(mFileDescriptor);
+            throw std::runtime_error("templ::solvers::transshipment::PersistentMinCostFlowCache: "
+                    "failed to initialize cache file '" + filename + "'");
+        }
+    } else if(pread(mFileDescriptor, &header, sizeof(header), 0) != static_cast<ssize_t>(sizeof(header))
+            || memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0
+            || header.version != FILE_VERSION)
+    {
+        flock(mFileDescriptor, LOCK_UN);
+        close(mFileDescriptor);
+        throw std::runtime_error("templ::solvers::transshipment::PersistentMinCostFlowCache: "
+                "'" + filename + "' is not a cache file of a compatible version");
+    }
+
+    update();
+    flock(mFileDescriptor, LOCK_UN);
+
+    LOG_INFO_S << "Opened persistent min cost flow cache: " << filename
+        << " with " << mIndex.size() << " records";
+}
+
+PersistentMinCostFlowCache::~PersistentMinCostFlowCache()
+{
+    unmap();
+    if(mFileDescriptor >= 0)
+    {
+        close(mFileDescriptor);
+    }
+}
+
+uint64_t PersistentMinCostFlowCache::fingerprint(const Mission& mission,
+        const symbols::constants::Location::PtrList& locations,
+        const pa::TimePoint::PtrList& timepoints,
+        const std::string& options)
+{
+    uint64_t h = FNV_OFFSET_BASIS;
+    h = fnv1a(h, &FILE_VERSION, sizeof(FILE_VERSION));
+    h = fnv1a(h, mission.getName());
+    for(const symbols::constants::Location::Ptr& location : locations)
+    {
+        h = fnv1a(h, location->getInstanceName());
+    }
+    for(const pa::TimePoint::Ptr& timepoint : timepoints)
+    {
+        h = fnv1a(h, timepoint->getLabel());
+    }
+    for(const owlapi::model::IRI& model : mission.getModels())
+    {
+        h = fnv1a(h, model.toString());
+
+        // organization model properties which define the flow network
+        moreorg::facades::Robot robot = moreorg::facades::Robot::getInstance(model, mission.getOrganizationModelAsk());
+        uint32_t mobile = robot.isMobile() ? 1 : 0;
+        uint32_t transportCapacity = robot.getTransportCapacity();
+        h = fnv1a(h, &mobile, sizeof(mobile));
+        h = fnv1a(h, &transportCapacity, sizeof(transportCapacity));
+    }
+    h = fnv1a(h, mission.getAvailableResources().toString(0));
+    for(const solvers::temporal::PersistenceCondition::Ptr& condition : mission.getPersistenceConditions())
+    {
+        h = fnv1a(h, condition->toString(0));
+    }
+    for(const Constraint::Ptr& constraint : mission.getConstraints())
+    {
+        h = fnv1a(h, constraint->toString(0));
+    }
+    h = fnv1a(h, options);
+    return h;
+}
+
+void PersistentMinCostFlowCache::unmap()
+{
+    if(mpData)
+    {
+        munmap(const_cast<char*>(mpData), mMappedSize);
+        mpData = NULL;
+        mMappedSize = 0;
+    }
+}
+
+void PersistentMinCostFlowCache::update()
+{
+    struct stat fileStat;
+    if(fstat(mFileDescriptor, &fileStat) != 0)
+    {
+        return;
+    }
+
+    size_t fileSize = fileStat.st_size;
+    if(fileSize <= mIndexedSize)
+    {
+        return;
+    }
+
+    if(fileSize != mMappedSize)
+    {
+        // The index refers to the current mapping, so that it is only
+        // replaced once the larger region has been mapped
+        void* data = mmap(NULL, fileSize, PROT_READ, MAP_SHARED, mFileDescriptor, 0);
+        if(data == MAP_FAILED)
+        {
+            LOG_WARN_S << "Failed to map persistent min cost flow cache: " << mFilename
+                << ": " << strerror(errno);
+            return;
+        }
+        unmap();
+        mpData = static_cast<const char*>(data);
+        mMappedSize = fileSize;
+    }
+
+    while(mIndexedSize + sizeof(RecordHeader) <= mMappedSize)
+    {
+        RecordHeader header;
+        memcpy(&header, mpData + mIndexedSize, sizeof(header));
+        size_t keyOffset = mIndexedSize + sizeof(RecordHeader);
+        if(header.magic != RECORD_MAGIC
+                || header.keySize > mMappedSize - keyOffset
+                || header.payloadSize > mMappedSize - keyOffset - header.keySize
+                || fnv1a(FNV_OFFSET_BASIS, mpData + keyOffset, header.keySize + header.payloadSize) != header.checksum)
+        {
+            // incomplete record
+            break;
+        }
+
+        RecordLocation location;
+        location.keyOffset = keyOffset;
+        location.keySize = header.keySize;
+        location.payloadOffset = keyOffset + header.keySize;
+        location.payloadSize = header.payloadSize;
+        mIndexedSize = location.payloadOffset + location.payloadSize;
+
+        // a later record for the same key replaces the earlier one
+        Index::const_iterator cit = find(header.fingerprint, header.hash,
+                std::string(mpData + location.keyOffset, location.keySize));
+        if(cit != mIndex.end())
+        {
+            mIndex.erase(cit);
+        }
+        mIndex.insert(std::make_pair(Key(header.fingerprint, header.hash), location));
+    }
+}
+
+PersistentMinCostFlowCache::Index::const_iterator PersistentMinCostFlowCache::find(uint64_t fingerprint,
+        uint64_t hash,
+        const std::string& canonicalKey) const
+{
+    std::pair<Index::const_iterator, Index::const_iterator> range = mIndex.equal_range(Key(fingerprint, hash));
+    for(Index::const_iterator cit = range.first; cit != range.second; ++cit)
+    {
+        const RecordLocation& location = cit->second;
+        if(location.keySize == canonicalKey.size()
+                && memcmp(mpData + location.keyOffset, canonicalKey.data(), canonicalKey.size()) == 0)
+        {
+            return cit;
+        }
+    }
+    return mIndex.end();
+}
+
+bool PersistentMinCostFlowCache::lookup(uint64_t fingerprint, uint64_t hash,
+        const std::string& canonicalKey,
+        const symbols::constants::Location::PtrList& locations,
+        const pa::TimePoint::PtrList& timepoints,
+        Value& value)
+{
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        Index::const_iterator cit = find(fingerprint, hash, canonicalKey);
+        if(cit == mIndex.end())
+        {
+            // check for records of other processes -- without the lock a
+            // record might still be written, so only known records are used
+            if(flock(mFileDescriptor, LOCK_SH) == 0)
+            {
+                update();
+                flock(mFileDescriptor, LOCK_UN);
+                cit = find(fingerprint, hash, canonicalKey);
+            } else {
+                LOG_WARN_S << "Failed to lock persistent min cost flow cache: " << mFilename
+                    << ": " << strerror(errno);
+            }
+        }
+
+        if(cit == mIndex.end())
+        {
+            ++mMisses;
+            return false;
+        }
+        payload = std::string(mpData + cit->second.payloadOffset, cit->second.payloadSize);
+    }
+
+    std::map<std::string, symbols::constants::Location::Ptr> locationsByName;
+    for(const symbols::constants::Location::Ptr& location : locations)
+    {
+        locationsByName[location->getInstanceName()] = location;
+    }
+    std::map<std::string, pa::TimePoint::Ptr> timepointsByLabel;
+    for(const pa::TimePoint::Ptr& timepoint : timepoints)
+    {
+        timepointsByLabel[timepoint->getLabel()] = timepoint;
+    }
+
+    try {
+        Record record;
+        std::stringstream ss(payload);
+        boost::archive::text_iarchive iarch(ss);
+        iarch >> record;
+
+        auto toPoint = [&locationsByName, &timepointsByLabel](const PointRecord& r) -> SpaceTime::Point
+        {
+            SpaceTime::Point point;
+            if(!r.location.empty())
+            {
+                point.first = locationsByName.at(r.location);
+            }
+            if(!r.timepoint.empty())
+            {
+                point.second = timepointsByLabel.at(r.timepoint);
+            }
+            return point;
+        };
+
+        std::vector<Flaw> flaws;
+        for(const FlawRecord& flawRecord : record.flaws)
+        {
+            namespace ga = graph_analysis::algorithms;
+            // The violation cannot be linked to the vertex of the (transient)
+            // flow graph, it only retains type, commodities and flow
+            ga::ConstraintViolation violation(ga::MultiCommodityMinCostFlow::edge_t::Ptr(),
+                    flawRecord.commodities,
+                    flawRecord.delta,
+                    flawRecord.inFlow,
+                    0,
+                    static_cast<ga::ConstraintViolation::Type>(flawRecord.type));
+
+            Role::List roles(flawRecord.roles.begin(), flawRecord.roles.end());
+            if(flawRecord.to.timepoint.empty())
+            {
+                flaws.push_back(Flaw(violation, roles, toPoint(flawRecord.from)));
+            } else {
+                flaws.push_back(Flaw(violation, roles, toPoint(flawRecord.from),
+                            toPoint(flawRecord.to)));
+            }
+        }
+
+        SpaceTime::Network network(locations, timepoints);
+        std::vector<SpaceTime::Network::tuple_t::Ptr> tuples;
+        for(const TupleRecord& tupleRecord : record.tuples)
+        {
+            SpaceTime::Point point = toPoint(tupleRecord.point);
+            SpaceTime::Network::tuple_t::Ptr tuple = network.tupleByKeys(point.first, point.second);
+            tuple->deserializeRoles(tupleRecord.roles);
+            tuple->deserializeTaggedRoles(tupleRecord.taggedRoles);
+            tuple->deserializeRoleInfoAttributes(tupleRecord.attributes);
+            tuples.push_back(tuple);
+        }
+
+        for(const EdgeRecord& edgeRecord : record.edges)
+        {
+            const SpaceTime::Network::tuple_t::Ptr& source = tuples.at(edgeRecord.source);
+            const SpaceTime::Network::tuple_t::Ptr& target = tuples.at(edgeRecord.target);
+
+            RoleInfoWeightedEdge::Ptr edge;
+            std::vector<RoleInfoWeightedEdge::Ptr> edges =
+                network.getGraph()->getEdges<RoleInfoWeightedEdge>(source, target);
+            if(edges.empty())
+            {
+                edge = make_shared<RoleInfoWeightedEdge>(source, target, edgeRecord.weight);
+                network.getMutableGraph()->addEdge(edge);
+            } else {
+                edge = edges.front();
+                edge->setWeight(edgeRecord.weight);
+            }
+            edge->deserializeRoles(edgeRecord.roles);
+            edge->deserializeTaggedRoles(edgeRecord.taggedRoles);
+        }
+
+        value = Value(flaws, network);
+    } catch(const std::exception& e)
+    {
+        // e.g. location or timepoint does not exist in this mission
+        LOG_WARN_S << "Failed to restore record from persistent min cost flow cache: "
+            << mFilename << ": " << e.what();
+        ++mMisses;
+        return false;
+    }
+
+    ++mHits;
+    return true;
+}
+
+bool PersistentMinCostFlowCache::store(uint64_t fingerprint, uint64_t hash,
+        const std::string& canonicalKey,
+        const Value& value)
+{
+    std::string keyAndPayload = canonicalKey + toPayload(value);
+
+    RecordHeader header;
+    header.magic = RECORD_MAGIC;
+    header.keySize = canonicalKey.size();
+    header.fingerprint = fingerprint;
+    header.hash = hash;
+    header.payloadSize = keyAndPayload.size() - canonicalKey.size();
+    header.checksum = fnv1a(FNV_OFFSET_BASIS, keyAndPayload.data(), keyAndPayload.size());
+
+    std::string data(reinterpret_cast<const char*>(&header), sizeof(header));
+    data += keyAndPayload;
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    if(flock(mFileDescriptor, LOCK_EX) != 0)
+    {
+        LOG_WARN_S << "Failed to lock persistent min cost flow cache: " << mFilename
+            << ": " << strerror(errno) << " -- skipping store";
+        return false;
+    }
+    update();
+
+    if(mIndexedSize + data.size() > mMaxFileSize)
+    {
+        flock(mFileDescriptor, LOCK_UN);
+        LOG_INFO_S << "Persistent min cost flow cache: " << mFilename
+            << " reached size limit of " << mMaxFileSize << " bytes";
+        return false;
+    }
+
+    // Overwrite any incomplete record at the end of the file
+    if(ftruncate(mFileDescriptor, mIndexedSize) != 0
+            || pwrite(mFileDescriptor, data.data(), data.size(), mIndexedSize) != static_cast<ssize_t>(data.size()))
+    {
+        LOG_WARN_S << "Failed to write to persistent min cost flow cache: " << mFilename
+            << ": " << strerror(errno);
+        flock(mFileDescriptor, LOCK_UN);
+        return false;
+    }
+    update();
+    flock(mFileDescriptor, LOCK_UN);
+
+    ++mWrites;
+    return true;
+}
+
+PersistentMinCostFlowCache::Statistics PersistentMinCostFlowCache::getStatistics() const
+{
+    Statistics statistics;
+    statistics.hits = mHits.load();
+    statistics.misses = mMisses.load();
+    statistics.writes = mWrites.load();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    statistics.size = mIndex.size();
+    statistics.fileSize = mIndexedSize;
+    return statistics;
+}
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
@@ -0,0 +1,149 @@
+#ifndef TEMPL_SOLVERS_TRANSSHIPMENT_PERSISTENT_MIN_COST_FLOW_CACHE_HPP
+#define TEMPL_SOLVERS_TRANSSHIPMENT_PERSISTENT_MIN_COST_FLOW_CACHE_HPP
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <atomic>
+#include "../../Mission.hpp"
+#include "MinCostFlowCache.hpp"
+
+namespace templ {
+namespace solvers {
+namespace transshipment {
+
+/**
+ * Persistent cache for the results of the min cost flow optimization, which
+ * can be shared between multiple planner runs and processes
+ *
+ * Results are appended as records to a single cache file, which is memory
+ * mapped for reading. A record is indexed by the fingerprint of the
+ * mission and the hash of the timelines (see MinCostFlowCache::hash), and
+ * stores the canonical key of the timelines
+ * (see MinCostFlowCache::canonicalKey), which is verified on every hit.
+ * Locations and timepoints are stored by name, so that a record can be mapped
+ * back onto the objects of the mission in a later run.
+ *
+ * Appending is guarded by an exclusive file lock. Records which have been
+ * only partially written, e.g., due to a crashed process, are ignored. If
+ * the file cannot be locked, lookups of new records count as miss and
+ * records are not stored.
+ */
+class PersistentMinCostFlowCache
+{
+public:
+    typedef shared_ptr<PersistentMinCostFlowCache> Ptr;
+    typedef MinCostFlowCache::Value Value;
+
+    struct Statistics
+    {
+        uint64_t hits;
+        uint64_t misses;
+        uint64_t writes;
+        /// Number of distinct records in the cache file
+        size_t size;
+        /// Size of the cache file in bytes
+        size_t fileSize;
+    };
+
+    /**
+     * Open (or create) a cache file
+     * \param filename Path to the cache file
+     * \param maxFileSize Maximum size of the cache file in bytes, when the
+     * limit is reached no further records are appended
+     * \throw std::runtime_error if the file cannot be opened or locked, or is
+     * not a cache file
+     */
+    PersistentMinCostFlowCache(const std::string& filename, size_t maxFileSize = 256*1024*1024);
+
+    ~PersistentMinCostFlowCache();
+
+    /**
+     * Compute the fingerprint of a mission, i.e., of all inputs of the min
+     * cost flow optimization apart from the timelines
+     *
+     * This includes the mission constraints and persistence conditions, and
+     * the properties of the required models that enter the flow network
+     * (mobility and transport capacity)
+     * \param mission Mission
+     * \param locations Locations of the space time network
+     * \param timepoints Sorted timepoints of the space time network
+     * \param options Additional options that affect the result, e.g., the
+     * solver type
+     */
+    static uint64_t fingerprint(const Mission& mission,
+            const symbols::constants::Location::PtrList& locations,
+            const temporal::point_algebra::TimePoint::PtrList& timepoints,
+            const std::string& options = "");
+
+    /**
+     * Lookup a record and map it onto the given locations and timepoints
+     * \param canonicalKey Canonical key of the timelines, which has to match
+     * the key of the record
+     * \param value Result, only valid if the record has been found
+     * \return true if the record has been found, false otherwise
+     */
+    bool lookup(uint64_t fingerprint, uint64_t hash,
+            const std::string& canonicalKey,
+            const symbols::constants::Location::PtrList& locations,
+            const temporal::point_algebra::TimePoint::PtrList& timepoints,
+            Value& value);
+
+    /**
+     * Append a record to the cache file
+     * \return true if the record has been written, false if the size limit
+     * has been reached or the file could not be locked or written
+     */
+    bool store(uint64_t fingerprint, uint64_t hash,
+            const std::string& canonicalKey,
+            const Value& value);
+
+    const std::string& getFilename() const { return mFilename; }
+
+    Statistics getStatistics() const;
+
+private:
+    typedef std::pair<uint64_t, uint64_t> Key;
+
+    /// Location of a record in the file
+    struct RecordLocation
+    {
+        size_t keyOffset;
+        size_t keySize;
+        size_t payloadOffset;
+        size_t payloadSize;
+    };
+    typedef std::multimap<Key, RecordLocation> Index;
+
+    /// Find the record with the given canonical key (requires mMutex)
+    Index::const_iterator find(uint64_t fingerprint, uint64_t hash,
+            const std::string& canonicalKey) const;
+
+    /// Map the current file content and index all records that have not
+    /// been seen yet (requires mMutex)
+    void update();
+
+    void unmap();
+
+    std::string mFilename;
+    size_t mMaxFileSize;
+    int mFileDescriptor;
+
+    mutable std::mutex mMutex;
+    const char* mpData;
+    size_t mMappedSize;
+    /// Offset up to which the file has been indexed
+    size_t mIndexedSize;
+    /// Records by fingerprint and hash -- different canonical keys can share
+    /// the same hash
+    Index mIndex;
+
+    std::atomic<uint64_t> mHits;
+    std::atomic<uint64_t> mMisses;
+    std::atomic<uint64_t> mWrites;
+};
+
+} // end namespace transshipment
+} // end namespace solvers
+} // end namespace templ
+#endif // TEMPL_SOLVERS_TRANSSHIPMENT_PERSISTENT_MIN_COST_FLOW_CACHE_HPP
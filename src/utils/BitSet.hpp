@@ -0,0 +1,211 @@
+#ifndef TEMPL_UTILS_BIT_SET_HPP
+#define TEMPL_UTILS_BIT_SET_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+namespace templ {
+namespace utils {
+
+/**
+ * Dynamically growing set of non-negative integers stored as bits
+ *
+ * Set operations work on whole words, so that union, intersection and
+ * difference of two sets are linear in the number of words, not in the
+ * number of elements
+ * \verbatim
+ utils::BitSet a;
+ a.set(3);
+ a.set(70);
+ for(size_t i = a.findNext(0); i != utils::BitSet::npos; i = a.findNext(i+1))
+ {
+     ...
+ }
+ \endverbatim
+ */
+class BitSet
+{
+public:
+    typedef uint64_t word_t;
+    static const size_t npos = static_cast<size_t>(-1);
+
+    void set(size_t pos)
+    {
+        size_t word = pos / BITS_PER_WORD;
+        if(word >= mWords.size())
+        {
+            mWords.resize(word + 1, 0);
+        }
+        mWords[word] |= mask(pos);
+    }
+
+    void reset(size_t pos)
+    {
+        size_t word = pos / BITS_PER_WORD;
+        if(word < mWords.size())
+        {
+            mWords[word] &= ~mask(pos);
+        }
+    }
+
+    bool test(size_t pos) const
+    {
+        size_t word = pos / BITS_PER_WORD;
+        return word < mWords.size() && (mWords[word] & mask(pos));
+    }
+
+    bool any() const
+    {
+        for(word_t w : mWords)
+        {
+            if(w)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool none() const { return !any(); }
+
+    /**
+     * Number of elements in the set
+     */
+    size_t count() const
+    {
+        size_t c = 0;
+        for(word_t w : mWords)
+        {
+            c += __builtin_popcountll(w);
+        }
+        return c;
+    }
+
+    void clear() { mWords.clear(); }
+
+    /**
+     * Get the smallest element which is greater or equal to pos
+     * \return element or npos if there is none
+     */
+    size_t findNext(size_t pos) const
+    {
+        size_t word = pos / BITS_PER_WORD;
+        if(word >= mWords.size())
+        {
+            return npos;
+        }
+        word_t w = mWords[word] & (~word_t(0) << (pos % BITS_PER_WORD));
+        while(!w)
+        {
+            if(++word == mWords.size())
+            {
+                return npos;
+            }
+            w = mWords[word];
+        }
+        return word*BITS_PER_WORD + __builtin_ctzll(w);
+    }
+
+    /// Union
+    BitSet& operator|=(const BitSet& other)
+    {
+        if(other.mWords.size() > mWords.size())
+        {
+            mWords.resize(other.mWords.size(), 0);
+        }
+        for(size_t i = 0; i < other.mWords.size(); ++i)
+        {
+            mWords[i] |= other.mWords[i];
+        }
+        return *this;
+    }
+
+    /// Intersection
+    BitSet& operator&=(const BitSet& other)
+    {
+        if(other.mWords.size() < mWords.size())
+        {
+            mWords.resize(other.mWords.size());
+        }
+        for(size_t i = 0; i < mWords.size(); ++i)
+        {
+            mWords[i] &= other.mWords[i];
+        }
+        return *this;
+    }
+
+    /// Relative complement, i.e. remove all elements of other
+    BitSet& operator-=(const BitSet& other)
+    {
+        size_t n = std::min(mWords.size(), other.mWords.size());
+        for(size_t i = 0; i < n; ++i)
+        {
+            mWords[i] &= ~other.mWords[i];
+        }
+        return *this;
+    }
+
+    /// Symmetric difference
+    BitSet& operator^=(const BitSet& other)
+    {
+        if(other.mWords.size() > mWords.size())
+        {
+            mWords.resize(other.mWords.size(), 0);
+        }
+        for(size_t i = 0; i < other.mWords.size(); ++i)
+        {
+            mWords[i] ^= other.mWords[i];
+        }
+        return *this;
+    }
+
+    /**
+     * Check whether both sets have at least one element in common
+     */
+    bool intersects(const BitSet& other) const
+    {
+        size_t n = std::min(mWords.size(), other.mWords.size());
+        for(size_t i = 0; i < n; ++i)
+        {
+            if(mWords[i] & other.mWords[i])
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool operator==(const BitSet& other) const
+    {
+        const std::vector<word_t>& shorter = mWords.size() < other.mWords.size() ? mWords : other.mWords;
+        const std::vector<word_t>& longer = mWords.size() < other.mWords.size() ? other.mWords : mWords;
+        for(size_t i = 0; i < longer.size(); ++i)
+        {
+            if(longer[i] != (i < shorter.size() ? shorter[i] : 0))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool operator!=(const BitSet& other) const { return !(*this == other); }
+
+private:
+    static const size_t BITS_PER_WORD = 64;
+
+    static word_t mask(size_t pos) { return word_t(1) << (pos % BITS_PER_WORD); }
+
+    std::vector<word_t> mWords;
+};
+
+inline BitSet operator|(BitSet a, const BitSet& b) { return a |= b; }
+inline BitSet operator&(BitSet a, const BitSet& b) { return a &= b; }
+inline BitSet operator-(BitSet a, const BitSet& b) { return a -= b; }
+inline BitSet operator^(BitSet a, const BitSet& b) { return a ^= b; }
+
+} // end namespace utils
+} // end namespace templ
+#endif // TEMPL_UTILS_BIT_SET_HPP
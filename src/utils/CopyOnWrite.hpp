@@ -0,0 +1,82 @@
+#ifndef TEMPL_UTILS_COPY_ON_WRITE_HPP
+#define TEMPL_UTILS_COPY_ON_WRITE_HPP
+
+#include <utility>
+#include "../SharedPtr.hpp"
+
+namespace templ {
+namespace utils {
+
+/**
+ * Value wrapper which shares its data between copies until one of the copies
+ * is modified
+ *
+ * This is intended for members of Gecode spaces which are set once when
+ * posting and afterwards only read, so that cloning a space only increases a
+ * reference count.
+ *
+ * Read access is provided through operator* and operator->, write access
+ * through write() or by assigning a new value.
+ * \verbatim
+ utils::CopyOnWrite< std::vector<int> > a = std::vector<int>(10,0);
+ utils::CopyOnWrite< std::vector<int> > b = a; // shares the data of a
+ size_t size = b->size();
+ b.write()[0] = 1; // b gets its own copy
+ \endverbatim
+ */
+template<typename T>
+class CopyOnWrite
+{
+public:
+    CopyOnWrite()
+        : mpData(make_shared<T>())
+    {}
+
+    CopyOnWrite(const T& data)
+        : mpData(make_shared<T>(data))
+    {}
+
+    CopyOnWrite(T&& data)
+        : mpData(make_shared<T>(std::move(data)))
+    {}
+
+    CopyOnWrite& operator=(const T& data)
+    {
+        mpData = make_shared<T>(data);
+        return *this;
+    }
+
+    CopyOnWrite& operator=(T&& data)
+    {
+        mpData = make_shared<T>(std::move(data));
+        return *this;
+    }
+
+    const T& operator*() const { return *mpData; }
+    const T* operator->() const { return mpData.get(); }
+
+    /**
+     * Get write access to the data, the data is copied first if it is shared
+     * with another instance
+     */
+    T& write()
+    {
+        if(mpData.use_count() > 1)
+        {
+            mpData = make_shared<T>(*mpData);
+        }
+        return *mpData;
+    }
+
+    /**
+     * Check whether the data is shared with another instance
+     */
+    bool isShared() const { return mpData.use_count() > 1; }
+
+private:
+    shared_ptr<T> mpData;
+};
+
+} // end namespace utils
+} // end namespace templ
+#endif // TEMPL_UTILS_COPY_ON_WRITE_HPP
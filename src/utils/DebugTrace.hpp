@@ -0,0 +1,57 @@
+#ifndef TEMPL_UTILS_DEBUG_TRACE_HPP
+#define TEMPL_UTILS_DEBUG_TRACE_HPP
+
+#include <sstream>
+#include <base-logging/Logging.hpp>
+
+/**
+ * Compile-time gated debug output
+ *
+ * Debug output is compiled in only if TEMPL_DEBUG_TRACE is defined, which is
+ * the case for Debug builds or when configuring with -DDEBUG_TRACE=ON.
+ * Otherwise the macros expand to nothing and their arguments are never
+ * evaluated.
+ * When compiled in, the arguments are only evaluated if the output is
+ * actually requested, so that expensive formatting, e.g., toString() of
+ * larger structures, does not slow down the search
+ *
+ * \verbatim
+ TEMPL_DEBUG_LOG("Timelines: " << RoleTimeline::toString(timelines));
+ TEMPL_DEBUG_TRACE_IF(msInteractive, breakpoint, "Remaining flaws: " << flaws.size());
+ \endverbatim
+ */
+#ifdef TEMPL_DEBUG_TRACE
+
+#define TEMPL_DEBUG_TRACE_ENABLED true
+
+/**
+ * Stream the given expression into a string and pass it to the sink, if
+ * condition holds
+ */
+#define TEMPL_DEBUG_TRACE_IF(condition, sink, ...) \
+    do { \
+        if(condition) \
+        { \
+            std::ostringstream templDebugTraceStream; \
+            templDebugTraceStream << __VA_ARGS__; \
+            sink(templDebugTraceStream.str()); \
+        } \
+    } while(0)
+
+/**
+ * Log the given expression with info level
+ */
+#define TEMPL_DEBUG_LOG(...) \
+    do { \
+        LOG_INFO_S << __VA_ARGS__; \
+    } while(0)
+
+#else
+
+#define TEMPL_DEBUG_TRACE_ENABLED false
+#define TEMPL_DEBUG_TRACE_IF(condition, sink, ...) do {} while(0)
+#define TEMPL_DEBUG_LOG(...) do {} while(0)
+
+#endif // TEMPL_DEBUG_TRACE
+
+#endif // TEMPL_UTILS_DEBUG_TRACE_HPP
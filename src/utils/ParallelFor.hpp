@@ -0,0 +1,81 @@
+#ifndef TEMPL_UTILS_PARALLEL_FOR_HPP
+#define TEMPL_UTILS_PARALLEL_FOR_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace templ {
+namespace utils {
+
+/**
+ * Call f(0), ..., f(count-1) using up to the given number of threads
+ *
+ * The indices are handed out one by one, so that the threads remain busy
+ * even if the cost per index varies. If f throws, the remaining indices are
+ * skipped and the first exception is rethrown in the calling thread.
+ * \verbatim
+ std::vector<double> results(items.size());
+ utils::parallelFor(items.size(), 4, [&](size_t i)
+     {
+         results[i] = evaluate(items[i]);
+     });
+ \endverbatim
+ */
+template<typename F>
+void parallelFor(size_t count, size_t numberOfThreads, const F& f)
+{
+    size_t numberOfWorkers = std::min(numberOfThreads, count);
+    if(numberOfWorkers <= 1)
+    {
+        for(size_t i = 0; i < count; ++i)
+        {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> nextIndex(0);
+    std::mutex mutex;
+    std::exception_ptr error;
+
+    std::vector<std::thread> workers;
+    for(size_t w = 0; w < numberOfWorkers; ++w)
+    {
+        workers.push_back( std::thread([&]()
+            {
+                size_t i;
+                while((i = nextIndex++) < count)
+                {
+                    try {
+                        f(i);
+                    } catch(...)
+                    {
+                        std::lock_guard<std::mutex> lock(mutex);
+                        if(!error)
+                        {
+                            error = std::current_exception();
+                        }
+                        nextIndex = count;
+                        return;
+                    }
+                }
+            }) );
+    }
+    for(std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    if(error)
+    {
+        std::rethrow_exception(error);
+    }
+}
+
+} // end namespace utils
+} // end namespace templ
+#endif // TEMPL_UTILS_PARALLEL_FOR_HPP
@@ -0,0 +1,140 @@
+#include "PhaseTimer.hpp"
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace templ {
+namespace utils {
+
+namespace {
+
+struct PhaseCounter
+{
+    std::atomic<uint64_t> count;
+    std::atomic<uint64_t> totalInNs;
+    std::atomic<uint64_t> maxInNs;
+};
+
+PhaseCounter gPhaseCounters[PhaseTimer::PHASE_END];
+std::atomic<bool> gEnabled(true);
+
+} // end anonymous namespace
+
+std::map<PhaseTimer::Phase, std::string> PhaseTimer::PhaseTxt = {
+    { PhaseTimer::POST_TEMPORAL_CONSTRAINTS, "postTemporalConstraints" },
+    { PhaseTimer::POST_MIN_MAX_CONSTRAINTS, "postMinMaxConstraints" },
+    { PhaseTimer::POST_ROLE_ASSIGNMENTS, "postRoleAssignments" },
+    { PhaseTimer::POST_TIMELINES, "postTimelines" },
+    { PhaseTimer::POST_MIN_COST_FLOW, "postMinCostFlow" },
+    { PhaseTimer::SOLUTION_ANALYSIS, "SolutionAnalysis::analyse" },
+    { PhaseTimer::SAVE_SOLUTION, "saveSolution" }
+};
+
+PhaseTimer::Scope::Scope(Phase phase)
+    : mPhase(phase)
+    , mEnabled(gEnabled.load(std::memory_order_relaxed))
+{
+    if(mEnabled)
+    {
+        mStart = std::chrono::steady_clock::now();
+    }
+}
+
+PhaseTimer::Scope::~Scope()
+{
+    if(mEnabled)
+    {
+        PhaseTimer::add(mPhase, std::chrono::steady_clock::now() - mStart);
+    }
+}
+
+void PhaseTimer::setEnabled(bool enabled)
+{
+    gEnabled = enabled;
+}
+
+bool PhaseTimer::isEnabled()
+{
+    return gEnabled;
+}
+
+void PhaseTimer::add(Phase phase, const std::chrono::steady_clock::duration& duration)
+{
+    if(phase >= PHASE_END)
+    {
+        throw std::invalid_argument("templ::utils::PhaseTimer::add: invalid phase");
+    }
+
+    uint64_t ns = std::chrono::duration_cast<std::chrono::nanoseconds>(duration).count();
+    PhaseCounter& counter = gPhaseCounters[phase];
+    counter.count.fetch_add(1, std::memory_order_relaxed);
+    counter.totalInNs.fetch_add(ns, std::memory_order_relaxed);
+    uint64_t max = counter.maxInNs.load(std::memory_order_relaxed);
+    while(ns > max && !counter.maxInNs.compare_exchange_weak(max, ns, std::memory_order_relaxed))
+    {}
+}
+
+PhaseTimer::Statistics PhaseTimer::getStatistics(Phase phase)
+{
+    if(phase >= PHASE_END)
+    {
+        throw std::invalid_argument("templ::utils::PhaseTimer::getStatistics: invalid phase");
+    }
+
+    const PhaseCounter& counter = gPhaseCounters[phase];
+    Statistics statistics;
+    statistics.count = counter.count.load();
+    statistics.totalInS = counter.totalInNs.load()*1E-9;
+    statistics.maxInS = counter.maxInNs.load()*1E-9;
+    return statistics;
+}
+
+void PhaseTimer::reset()
+{
+    for(size_t i = 0; i < PHASE_END; ++i)
+    {
+        gPhaseCounters[i].count = 0;
+        gPhaseCounters[i].totalInNs = 0;
+        gPhaseCounters[i].maxInNs = 0;
+    }
+}
+
+std::string PhaseTimer::toJSON()
+{
+    std::stringstream ss;
+    ss << "{" << std::endl;
+    ss << "  \"phases\": [" << std::endl;
+    for(size_t i = 0; i < PHASE_END; ++i)
+    {
+        Phase phase = static_cast<Phase>(i);
+        Statistics statistics = getStatistics(phase);
+        ss << "    { \"name\": \"" << PhaseTxt[phase] << "\""
+            << ", \"count\": " << statistics.count
+            << ", \"total_s\": " << statistics.totalInS
+            << ", \"mean_s\": " << statistics.meanInS()
+            << ", \"max_s\": " << statistics.maxInS
+            << " }";
+        if(i + 1 < PHASE_END)
+        {
+            ss << ",";
+        }
+        ss << std::endl;
+    }
+    ss << "  ]" << std::endl;
+    ss << "}" << std::endl;
+    return ss.str();
+}
+
+void PhaseTimer::saveJSON(const std::string& filename)
+{
+    std::ofstream file(filename);
+    if(!file.is_open())
+    {
+        throw std::runtime_error("templ::utils::PhaseTimer::saveJSON: failed to open file '" + filename + "'");
+    }
+    file << toJSON();
+}
+
+} // end namespace utils
+} // end namespace templ
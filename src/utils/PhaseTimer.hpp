@@ -0,0 +1,101 @@
+#ifndef TEMPL_UTILS_PHASE_TIMER_HPP
+#define TEMPL_UTILS_PHASE_TIMER_HPP
+
+#include <map>
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+namespace templ {
+namespace utils {
+
+/**
+ * Process wide timing statistics for the phases of the planning pipeline
+ *
+ * Timing a phase requires two reads of the steady clock and three relaxed
+ * atomic updates, so that the timers can be left enabled, also with parallel
+ * search.
+ *
+ * \verbatim
+ void TransportNetwork::postTimelines()
+ {
+     utils::PhaseTimer::Scope timer(utils::PhaseTimer::POST_TIMELINES);
+     ...
+ }
+ \endverbatim
+ */
+class PhaseTimer
+{
+public:
+    enum Phase { POST_TEMPORAL_CONSTRAINTS = 0,
+        POST_MIN_MAX_CONSTRAINTS,
+        POST_ROLE_ASSIGNMENTS,
+        POST_TIMELINES,
+        POST_MIN_COST_FLOW,
+        SOLUTION_ANALYSIS,
+        SAVE_SOLUTION,
+        PHASE_END
+    };
+
+    static std::map<Phase, std::string> PhaseTxt;
+
+    struct Statistics
+    {
+        uint64_t count;
+        double totalInS;
+        double maxInS;
+
+        double meanInS() const { return count == 0 ? 0.0 : totalInS/count; }
+    };
+
+    /**
+     * Measure the time from construction to destruction of this object
+     */
+    class Scope
+    {
+    public:
+        Scope(Phase phase);
+        ~Scope();
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        Phase mPhase;
+        bool mEnabled;
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    /**
+     * Enable/disable the timers (enabled by default)
+     */
+    static void setEnabled(bool enabled);
+    static bool isEnabled();
+
+    /**
+     * Account the duration of a single execution of a phase
+     */
+    static void add(Phase phase, const std::chrono::steady_clock::duration& duration);
+
+    static Statistics getStatistics(Phase phase);
+
+    /**
+     * Reset the statistics of all phases
+     */
+    static void reset();
+
+    /**
+     * Get the statistics of all phases as JSON object
+     */
+    static std::string toJSON();
+
+    /**
+     * Write the statistics as JSON to the given file
+     * \throw std::runtime_error if the file cannot be written
+     */
+    static void saveJSON(const std::string& filename);
+};
+
+} // end namespace utils
+} // end namespace templ
+#endif // TEMPL_UTILS_PHASE_TIMER_HPP
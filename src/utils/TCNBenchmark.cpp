@@ -54,6 +54,8 @@ int main(int argc, char** argv)
     stats["gq"];
 #endif
     stats["incremental"];
+    stats["matrix"];
+    stats["matrix_parallel"];
 
     std::cout << "# <number-of-timepoints> ";
     for(std::pair<std::string, numeric::Stats<double> > p : stats)
@@ -86,16 +88,32 @@ int main(int argc, char** argv)
             stats["gq"].update(gqDuration);
 #endif // WITH_GQR
 
+            // the consistency checks tighten the network and the relation
+            // matrix is cached by the network, so that each mode requires a
+            // fresh network for a fair comparison
+            QualitativeTemporalConstraintNetwork::Ptr incrementalTcn = createTCN(i);
             start = base::Time::now();
-            tcn->isConsistent(QualitativeTemporalConstraintNetwork::TCN_INCREMENTAL);
+            incrementalTcn->isConsistent(QualitativeTemporalConstraintNetwork::TCN_INCREMENTAL);
             double incremental = (base::Time::now() - start).toSeconds();
             stats["incremental"].update(incremental);
 
+            QualitativeTemporalConstraintNetwork::Ptr matrixTcn = createTCN(i);
+            start = base::Time::now();
+            matrixTcn->isConsistent(QualitativeTemporalConstraintNetwork::TCN_MATRIX);
+            double matrix = (base::Time::now() - start).toSeconds();
+            stats["matrix"].update(matrix);
+
+            QualitativeTemporalConstraintNetwork::Ptr parallelTcn = createTCN(i);
+            start = base::Time::now();
+            parallelTcn->isConsistent(QualitativeTemporalConstraintNetwork::TCN_MATRIX_PARALLEL);
+            double matrixParallel = (base::Time::now() - start).toSeconds();
+            stats["matrix_parallel"].update(matrixParallel);
+
             std::cout << i << " " << duration << " ";
 #ifdef WITH_GQR
             std::cout << gqWithOverheadDuration << " " << gqDuration << " ";
 #endif // WITH_GQR
-            std::cout << incremental << std::endl;
+            std::cout << incremental << " " << matrix << " " << matrixParallel << std::endl;
         }
         //std::cout << i <<  " ";
         //for(std::pair<std::string, numeric::Stats<double> > p: stats)
@@ -0,0 +1,219 @@
+#include "Tracer.hpp"
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <fstream>
+#include <stdexcept>
+#include <unistd.h>
+
+namespace templ {
+namespace utils {
+
+namespace {
+
+struct Event
+{
+    std::string name;
+    std::string category;
+    /// 'X' for complete events, 'i' for instant events
+    char phase;
+    int64_t timestampInUs;
+    int64_t durationInUs;
+    uint32_t threadId;
+};
+
+std::atomic<bool> gEnabled(false);
+std::atomic<uint32_t> gNextThreadId(1);
+std::mutex gMutex;
+std::vector<Event> gEvents;
+std::string gFilename;
+std::chrono::steady_clock::time_point gStart;
+
+int64_t toMicroseconds(const std::chrono::steady_clock::duration& duration)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+}
+
+void addEvent(Event& event, const std::chrono::steady_clock::time_point& start)
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    if(!gEnabled)
+    {
+        return;
+    }
+    event.timestampInUs = toMicroseconds(start - gStart);
+    gEvents.push_back(event);
+}
+
+std::string escape(const std::string& s)
+{
+    std::string escaped;
+    for(char c : s)
+    {
+        if(c == '"' || c == '\\')
+        {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+} // end anonymous namespace
+
+Tracer::Scope::Scope(const char* name, const char* category)
+    : mName(name)
+    , mCategory(category)
+    , mEnabled(gEnabled.load(std::memory_order_relaxed))
+{
+    if(mEnabled)
+    {
+        mStart = std::chrono::steady_clock::now();
+    }
+}
+
+Tracer::Scope::~Scope()
+{
+    if(mEnabled)
+    {
+        Tracer::complete(mName, mCategory, mStart, std::chrono::steady_clock::now());
+    }
+}
+
+Tracer::Recording::Recording(const std::string& filename)
+    : mActive(!filename.empty())
+{
+    if(mActive)
+    {
+        Tracer::start(filename);
+    }
+}
+
+Tracer::Recording::~Recording()
+{
+    try {
+        stop();
+    } catch(const std::runtime_error&)
+    {
+    }
+}
+
+void Tracer::Recording::stop()
+{
+    if(mActive)
+    {
+        mActive = false;
+        Tracer::stop();
+    }
+}
+
+void Tracer::start(const std::string& filename)
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    gEvents.clear();
+    gFilename = filename;
+    gStart = std::chrono::steady_clock::now();
+    gEnabled = true;
+}
+
+void Tracer::stop()
+{
+    std::vector<Event> events;
+    std::string filename;
+    {
+        std::lock_guard<std::mutex> lock(gMutex);
+        if(!gEnabled)
+        {
+            return;
+        }
+        gEnabled = false;
+        events.swap(gEvents);
+        filename = gFilename;
+    }
+
+    std::ofstream file(filename);
+    if(!file.is_open())
+    {
+        throw std::runtime_error("templ::utils::Tracer::stop: failed to open file '" + filename + "'");
+    }
+
+    int pid = getpid();
+    file << "{\"traceEvents\":[" << std::endl;
+    for(size_t i = 0; i < events.size(); ++i)
+    {
+        const Event& event = events[i];
+        file << "{\"name\":\"" << escape(event.name) << "\""
+            << ",\"cat\":\"" << escape(event.category) << "\""
+            << ",\"ph\":\"" << event.phase << "\""
+            << ",\"ts\":" << event.timestampInUs;
+        if(event.phase == 'X')
+        {
+            file << ",\"dur\":" << event.durationInUs;
+        } else {
+            // thread scoped instant event
+            file << ",\"s\":\"t\"";
+        }
+        file << ",\"pid\":" << pid
+            << ",\"tid\":" << event.threadId << "}";
+        if(i + 1 < events.size())
+        {
+            file << ",";
+        }
+        file << std::endl;
+    }
+    file << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+}
+
+bool Tracer::isEnabled()
+{
+    return gEnabled.load(std::memory_order_relaxed);
+}
+
+void Tracer::instant(const std::string& name, const std::string& category)
+{
+    if(!isEnabled())
+    {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'i';
+    event.durationInUs = 0;
+    event.threadId = getThreadId();
+    addEvent(event, std::chrono::steady_clock::now());
+}
+
+void Tracer::complete(const std::string& name, const std::string& category,
+        const std::chrono::steady_clock::time_point& start,
+        const std::chrono::steady_clock::time_point& end)
+{
+    if(!isEnabled())
+    {
+        return;
+    }
+
+    Event event;
+    event.name = name;
+    event.category = category;
+    event.phase = 'X';
+    event.durationInUs = toMicroseconds(end - start);
+    event.threadId = getThreadId();
+    addEvent(event, start);
+}
+
+uint32_t Tracer::getThreadId()
+{
+    static thread_local uint32_t threadId = gNextThreadId++;
+    return threadId;
+}
+
+size_t Tracer::getNumberOfEvents()
+{
+    std::lock_guard<std::mutex> lock(gMutex);
+    return gEvents.size();
+}
+
+} // end namespace utils
+} // end namespace templ
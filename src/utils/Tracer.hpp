@@ -0,0 +1,128 @@
+#ifndef TEMPL_UTILS_TRACER_HPP
+#define TEMPL_UTILS_TRACER_HPP
+
+#include <string>
+#include <chrono>
+#include <cstdint>
+
+namespace templ {
+namespace utils {
+
+/**
+ * Process wide recorder for timeline events, which are written in the Chrome
+ * trace event format (JSON), so that a planning run can be inspected with
+ * chrome://tracing or Perfetto
+ *
+ * Tracing is disabled by default; when disabled, a Scope costs a single
+ * atomic read.
+ *
+ * \verbatim
+ Tracer::start("/tmp/trace.json");
+ {
+     Tracer::Scope scope("postMinCostFlow", "lp");
+     ...
+ }
+ Tracer::instant("restart", "search");
+ Tracer::stop();
+ \endverbatim
+ */
+class Tracer
+{
+public:
+    /**
+     * Record a complete event covering the lifetime of this object
+     */
+    class Scope
+    {
+    public:
+        /**
+         * \param name Event name, has to outlive the scope (typically a
+         * string literal)
+         * \param category Event category, has to outlive the scope
+         */
+        Scope(const char* name, const char* category);
+        ~Scope();
+
+    private:
+        Scope(const Scope&);
+        Scope& operator=(const Scope&);
+
+        const char* mName;
+        const char* mCategory;
+        bool mEnabled;
+        std::chrono::steady_clock::time_point mStart;
+    };
+
+    /**
+     * Record events for the lifetime of this object, so that recording is
+     * also stopped when the recorded code throws
+     */
+    class Recording
+    {
+    public:
+        /**
+         * Start recording
+         * \param filename Trace file, an empty filename disables recording
+         */
+        Recording(const std::string& filename);
+
+        /**
+         * Stop recording if stop() has not been called; errors when writing
+         * the trace are ignored
+         */
+        ~Recording();
+
+        /**
+         * Stop recording and write all recorded events
+         * \throw std::runtime_error if the file cannot be written
+         */
+        void stop();
+
+    private:
+        Recording(const Recording&);
+        Recording& operator=(const Recording&);
+
+        bool mActive;
+    };
+
+    /**
+     * Start recording events, which will be written to the given file
+     * on stop()
+     */
+    static void start(const std::string& filename);
+
+    /**
+     * Stop recording and write all recorded events
+     * \throw std::runtime_error if the file cannot be written
+     */
+    static void stop();
+
+    static bool isEnabled();
+
+    /**
+     * Record an instant event
+     */
+    static void instant(const std::string& name, const std::string& category);
+
+    /**
+     * Record a complete event
+     */
+    static void complete(const std::string& name, const std::string& category,
+            const std::chrono::steady_clock::time_point& start,
+            const std::chrono::steady_clock::time_point& end);
+
+    /**
+     * Get a small id for the calling thread, which is used as tid in the
+     * trace
+     */
+    static uint32_t getThreadId();
+
+    /**
+     * Get the number of events recorded since start()
+     */
+    static size_t getNumberOfEvents();
+};
+
+} // end namespace utils
+} // end namespace templ
+#endif // TEMPL_UTILS_TRACER_HPP
@@ -403,8 +403,8 @@ BOOST_AUTO_TEST_CASE(flaw_resolution)
     {
         FlawResolution flawResolution;
         flawResolution.prepare(flaws);
-        BOOST_REQUIRE_MESSAGE(flawResolution.remainingDraws().size() == 1, "Flaw resolution options should be 1 but was " <<
-                flawResolution.remainingDraws().size());
+        BOOST_REQUIRE_MESSAGE(flawResolution.remainingDraws() == 1, "Flaw resolution options should be 1 but was " <<
+                flawResolution.remainingDraws());
 
         while(flawResolution.next(false))
         {
@@ -422,8 +422,8 @@ BOOST_AUTO_TEST_CASE(flaw_resolution)
 
         FlawResolution flawResolution;
         flawResolution.prepare(flaws);
-        BOOST_REQUIRE_MESSAGE(flawResolution.remainingDraws().size() == 1, "Flaw resolution options should be 1 but was " <<
-                flawResolution.remainingDraws().size());
+        BOOST_REQUIRE_MESSAGE(flawResolution.remainingDraws() == 1, "Flaw resolution options should be 1 but was " <<
+                flawResolution.remainingDraws());
 
         while(flawResolution.next())
         {
@@ -439,4 +439,49 @@ BOOST_AUTO_TEST_CASE(flaw_resolution)
     }
 }
 
+BOOST_AUTO_TEST_CASE(flaw_resolution_lazy_draws)
+{
+    using namespace templ::solvers::csp;
+    using namespace templ::solvers;
+    using namespace graph_analysis::algorithms;
+
+    constants::Location::Ptr loc0 = make_shared<constants::Location>("loc0", base::Point(0,0,0));
+    pa::TimePoint::Ptr t0 = pa::QualitativeTimePoint::getInstance("t0");
+    SpaceTime::Point spacetime(loc0,t0);
+
+    // 2^40 combinations cannot be enumerated upfront
+    size_t numberOfFlaws = 40;
+    std::vector<transshipment::Flaw> flaws;
+    for(size_t i = 0; i < numberOfFlaws; ++i)
+    {
+        ConstraintViolation violation(MultiCommodityVertex::Ptr(),
+                0,i,1,1,ConstraintViolation::TransFlow);
+        flaws.push_back( transshipment::Flaw(violation, Role(), spacetime) );
+    }
+
+    FlawResolution flawResolution;
+    flawResolution.prepare(flaws);
+    BOOST_REQUIRE_MESSAGE(flawResolution.remainingDraws() == (static_cast<uint64_t>(1) << numberOfFlaws) - 1,
+            "Expected 2^40-1 draws, but was " << flawResolution.remainingDraws());
+
+    // single flaws come first, ordered by decreasing severity
+    double lastSeverity = std::numeric_limits<double>::max();
+    for(size_t i = 0; i < numberOfFlaws; ++i)
+    {
+        BOOST_REQUIRE(flawResolution.next(false));
+        FlawResolution::ResolutionOptions draw = flawResolution.current();
+        BOOST_REQUIRE_MESSAGE(draw.size() == 1, "Expected draw of size 1, but was " << draw.size());
+        double severity = FlawResolution::getSeverity(draw.front().first);
+        BOOST_REQUIRE_MESSAGE(severity <= lastSeverity, "Draws should be ordered by decreasing severity");
+        lastSeverity = severity;
+    }
+
+    BOOST_REQUIRE(flawResolution.next(false));
+    FlawResolution::ResolutionOptions draw = flawResolution.current();
+    BOOST_REQUIRE_MESSAGE(draw.size() == 2, "Expected draw of size 2, but was " << draw.size());
+    BOOST_REQUIRE(flawResolution.next(true));
+    BOOST_REQUIRE_MESSAGE(flawResolution.remainingDraws() == (static_cast<uint64_t>(1) << numberOfFlaws) - 1 - numberOfFlaws - 2,
+            "Remaining draws not updated");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
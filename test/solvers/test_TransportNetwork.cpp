@@ -2,7 +2,9 @@
 #include <templ/Mission.hpp>
 #include <templ/io/MissionReader.hpp>
 #include <templ/solvers/csp/TransportNetwork.hpp>
+#include <templ/solvers/transshipment/GLPKMinCostFlow.hpp>
 #include <moreorg/vocabularies/OM.hpp>
+#include <boost/filesystem.hpp>
 
 #include "../test_utils.hpp"
 
@@ -525,4 +527,386 @@ BOOST_AUTO_TEST_CASE(mission_4)
         BOOST_REQUIRE_MESSAGE(!solutions.empty(), "Solutions found " << solutions);
     }
 }
+
+BOOST_FIXTURE_TEST_CASE(min_cost_flow_cache, TransportNetworkSetup)
+{
+    using namespace solvers;
+    typedef transshipment::MinCostFlowCache Cache;
+
+    std::vector<Cache::Key> keys;
+    for(size_t i = 0; i < 5; ++i)
+    {
+        Role role(i, "http://model/instance#");
+        csp::RoleTimeline roleTimeline;
+        roleTimeline.setRole(role);
+        roleTimeline.add(SpaceTime::Point(l[0], t[0]));
+        roleTimeline.add(SpaceTime::Point(l[i], t[1]));
+
+        Cache::Timelines timelines;
+        timelines[role] = roleTimeline;
+        keys.push_back(Cache::Key(timelines, timelines));
+    }
+
+    BOOST_REQUIRE_MESSAGE(Cache::hash(keys[0].first, keys[0].second) ==
+            Cache::hash(keys[0].first, keys[0].second), "Hash is deterministic");
+    BOOST_REQUIRE_MESSAGE(Cache::hash(keys[0].first, keys[0].second) !=
+            Cache::hash(keys[1].first, keys[1].second), "Hash differs for different timelines");
+
+    Cache cache(2, 1);
+    for(size_t i = 0; i < 3; ++i)
+    {
+        const Cache::Key& key = keys[i];
+        uint64_t hash = Cache::hash(key.first, key.second);
+        BOOST_REQUIRE_MESSAGE(!cache.lookup(hash, key), "Entry not yet cached");
+        cache.insert(hash, key, Cache::Value());
+        BOOST_REQUIRE_MESSAGE(cache.lookup(hash, key), "Entry cached");
+    }
+
+    Cache::Statistics statistics = cache.getStatistics();
+    BOOST_REQUIRE_EQUAL(statistics.size, 2);
+    BOOST_REQUIRE_EQUAL(statistics.evictions, 1);
+    BOOST_REQUIRE_EQUAL(statistics.hits, 3);
+    BOOST_REQUIRE_EQUAL(statistics.misses, 3);
+
+    // least recently used entry has been evicted
+    BOOST_REQUIRE(!cache.lookup(Cache::hash(keys[0].first, keys[0].second), keys[0]));
+
+    // a hash hit for a different key must not return the entry
+    BOOST_REQUIRE(!cache.lookup(Cache::hash(keys[2].first, keys[2].second), keys[3]));
+
+    // the maximum size holds exactly, even with fewer entries than shards
+    Cache shardedCache(3, 16);
+    for(const Cache::Key& key : keys)
+    {
+        shardedCache.insert(Cache::hash(key.first, key.second), key, Cache::Value());
+        BOOST_REQUIRE_LE(shardedCache.getStatistics().size, 3);
+    }
+    shardedCache.setMaxSize(1);
+    BOOST_REQUIRE_LE(shardedCache.getStatistics().size, 1);
+    shardedCache.setMaxSize(20);
+    const Cache::Key& key = keys.back();
+    shardedCache.insert(Cache::hash(key.first, key.second), key, Cache::Value());
+    BOOST_REQUIRE_MESSAGE(shardedCache.lookup(Cache::hash(key.first, key.second), key), "Entry cached after resizing");
+}
+
+BOOST_FIXTURE_TEST_CASE(persistent_min_cost_flow_cache, TransportNetworkSetup)
+{
+    using namespace solvers;
+    typedef transshipment::PersistentMinCostFlowCache Cache;
+
+    owlapi::model::IRI organizationModelIRI = "http://www.rock-robotics.org/2015/12/projects/TransTerrA";
+    moreorg::OrganizationModel::Ptr om = moreorg::OrganizationModel::getInstance(organizationModelIRI);
+    Mission mission(om);
+
+    symbols::constants::Location::PtrList locations(l.begin(), l.begin() + 3);
+    pa::TimePoint::PtrList timepoints(t.begin(), t.begin() + 3);
+
+    uint64_t fingerprint = Cache::fingerprint(mission, locations, timepoints);
+    BOOST_REQUIRE_MESSAGE(fingerprint == Cache::fingerprint(mission, locations, timepoints),
+            "Fingerprint is deterministic");
+    BOOST_REQUIRE_MESSAGE(fingerprint != Cache::fingerprint(mission, locations, timepoints, "CLP_SOLVER"),
+            "Fingerprint depends on options");
+    {
+        Mission constrainedMission(mission);
+        constrainedMission.addConstraint(make_shared<pa::QualitativeTimePointConstraint>(t[0], t[1], pa::QualitativeTimePointConstraint::Less));
+        BOOST_REQUIRE_MESSAGE(fingerprint != Cache::fingerprint(constrainedMission, locations, timepoints),
+                "Fingerprint depends on mission constraints");
+    }
+
+    Role role(0, "http://model/instance#");
+    SpaceTime::Network network(locations, timepoints);
+    network.tupleByKeys(l[0], t[0])->addRole(role, RoleInfo::ASSIGNED);
+    RoleInfoWeightedEdge::Ptr edge = make_shared<RoleInfoWeightedEdge>(
+            network.tupleByKeys(l[0], t[0]),
+            network.tupleByKeys(l[1], t[1]), 5);
+    edge->addRole(role, RoleInfo::ASSIGNED);
+    network.getGraph()->addEdge(edge);
+
+    std::vector<transshipment::Flaw> flaws;
+    graph_analysis::algorithms::ConstraintViolation violation(
+            graph_analysis::algorithms::MultiCommodityMinCostFlow::edge_t::Ptr(),
+            std::set<uint32_t>(), 2, 1, 0,
+            graph_analysis::algorithms::ConstraintViolation::TotalMinFlow);
+    flaws.push_back(transshipment::Flaw(violation, Role::List(1, role), SpaceTime::Point(l[2], t[2])));
+
+    std::string canonicalKey = "timelines";
+    boost::filesystem::path filename = boost::filesystem::temp_directory_path() /
+        boost::filesystem::unique_path("templ-lp-cache-%%%%-%%%%.bin");
+    {
+        Cache cache(filename.string());
+        Cache::Value value;
+        BOOST_REQUIRE_MESSAGE(!cache.lookup(fingerprint, 42, canonicalKey, locations, timepoints, value),
+                "Entry not yet cached");
+        BOOST_REQUIRE(cache.store(fingerprint, 42, canonicalKey, Cache::Value(flaws, network)));
+    }
+
+    // Reopen to simulate a subsequent planner run
+    Cache cache(filename.string());
+    BOOST_REQUIRE_EQUAL(cache.getStatistics().size, 1);
+
+    Cache::Value value;
+    BOOST_REQUIRE(!cache.lookup(fingerprint + 1, 42, canonicalKey, locations, timepoints, value));
+    BOOST_REQUIRE_MESSAGE(!cache.lookup(fingerprint, 42, "other-timelines", locations, timepoints, value),
+            "A hash hit for a different canonical key must not return the record");
+    BOOST_REQUIRE(cache.lookup(fingerprint, 42, canonicalKey, locations, timepoints, value));
+
+    BOOST_REQUIRE_EQUAL(value.first.size(), 1);
+    const transshipment::Flaw& flaw = value.first.front();
+    BOOST_REQUIRE(flaw.getViolation().getType() == graph_analysis::algorithms::ConstraintViolation::TotalMinFlow);
+    BOOST_REQUIRE_EQUAL(flaw.getViolation().getDelta(), 2);
+    BOOST_REQUIRE_MESSAGE(flaw.getSpaceTime().first == l[2] && flaw.getSpaceTime().second == t[2],
+            "Flaw is mapped to the locations and timepoints of the mission");
+    BOOST_REQUIRE(flaw.affectedRole() == role);
+
+    BOOST_REQUIRE(value.second.tupleByKeys(l[0], t[0])->hasRole(role, RoleInfo::ASSIGNED));
+    BOOST_REQUIRE(!value.second.tupleByKeys(l[1], t[0])->hasRole(role, RoleInfo::ASSIGNED));
+    std::vector<RoleInfoWeightedEdge::Ptr> edges = value.second.getGraph()->getEdges<RoleInfoWeightedEdge>(
+            value.second.tupleByKeys(l[0], t[0]),
+            value.second.tupleByKeys(l[1], t[1]));
+    BOOST_REQUIRE_EQUAL(edges.size(), 1);
+    BOOST_REQUIRE_EQUAL(edges[0]->getWeight(), 5);
+    BOOST_REQUIRE(edges[0]->hasRole(role, RoleInfo::ASSIGNED));
+
+    // A record which references unknown locations is not restored
+    symbols::constants::Location::PtrList otherLocations(l.begin() + 3, l.begin() + 6);
+    BOOST_REQUIRE(!cache.lookup(fingerprint, 42, canonicalKey, otherLocations, timepoints, value));
+
+    boost::filesystem::remove(filename);
+}
+
+BOOST_AUTO_TEST_CASE(min_cost_flow_pipeline)
+{
+    using namespace solvers;
+    typedef transshipment::MinCostFlowPipeline Pipeline;
+
+    Pipeline pipeline(2, 1);
+    BOOST_REQUIRE_EQUAL(pipeline.getNumberOfWorkers(), 2);
+
+    std::vector<Pipeline::Future> futures;
+    for(size_t i = 0; i < 5; ++i)
+    {
+        futures.push_back(pipeline.submit([i]()
+                    {
+                        if(i == 3)
+                        {
+                            throw std::runtime_error("evaluation failed");
+                        }
+                        return Pipeline::Result();
+                    }));
+    }
+
+    for(size_t i = 0; i < futures.size(); ++i)
+    {
+        if(i == 3)
+        {
+            BOOST_REQUIRE_THROW(futures[i].get(), std::runtime_error);
+        } else {
+            BOOST_REQUIRE_NO_THROW(futures[i].get());
+            BOOST_REQUIRE(Pipeline::isReady(futures[i]));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(glpk_in_memory_min_cost_flow)
+{
+    using namespace graph_analysis;
+    using namespace graph_analysis::algorithms;
+    typedef MultiCommodityMinCostFlow::vertex_t MultiCommodityVertex;
+    typedef MultiCommodityMinCostFlow::edge_t MultiCommodityEdge;
+
+    // Two commodities from s to t: the cheap path via a is limited to one
+    // unit in total, and commodity 0 has to pass b
+    uint32_t commodities = 2;
+    MultiCommodityVertex::Ptr s = make_shared<MultiCommodityVertex>(commodities);
+    MultiCommodityVertex::Ptr a = make_shared<MultiCommodityVertex>(commodities);
+    MultiCommodityVertex::Ptr b = make_shared<MultiCommodityVertex>(commodities);
+    MultiCommodityVertex::Ptr t = make_shared<MultiCommodityVertex>(commodities);
+    for(size_t k = 0; k < commodities; ++k)
+    {
+        s->setCommoditySupply(k, 1);
+        t->setCommoditySupply(k, -1);
+    }
+    b->setCommodityMinTransFlow(0, 1);
+
+    BaseGraph::Ptr flowGraph = BaseGraph::getInstance();
+    auto addEdge = [&flowGraph, commodities](const Vertex::Ptr& source, const Vertex::Ptr& target,
+            uint32_t capacity, double cost)
+    {
+        MultiCommodityEdge::Ptr edge = make_shared<MultiCommodityEdge>(commodities);
+        edge->setSourceVertex(source);
+        edge->setTargetVertex(target);
+        edge->setCapacityUpperBound(capacity);
+        for(size_t k = 0; k < commodities; ++k)
+        {
+            edge->setCommodityCapacityUpperBound(k, capacity);
+            edge->setCommodityCost(k, cost);
+        }
+        flowGraph->addEdge(edge);
+        return edge;
+    };
+    MultiCommodityEdge::Ptr sa = addEdge(s, a, 1, 1);
+    MultiCommodityEdge::Ptr at = addEdge(a, t, 2, 1);
+    MultiCommodityEdge::Ptr ab = addEdge(a, b, 2, 0);
+    MultiCommodityEdge::Ptr sb = addEdge(s, b, 2, 9);
+    MultiCommodityEdge::Ptr bt = addEdge(b, t, 2, 1);
+    MultiCommodityEdge::Ptr st = addEdge(s, t, std::numeric_limits<uint32_t>::max(), 6);
+
+    solvers::transshipment::GLPKMinCostFlow solver(flowGraph, commodities);
+    if(!solvers::transshipment::GLPKMinCostFlow::isAvailable())
+    {
+        BOOST_REQUIRE_THROW(solver.solve(), std::runtime_error);
+        return;
+    }
+
+    BOOST_REQUIRE_EQUAL(solver.solve(), LPSolver::STATUS_OPTIMAL);
+    // commodity 0: s -> a -> b -> t, commodity 1: s -> t
+    BOOST_REQUIRE_EQUAL(sa->getCommodityFlow(0), 1);
+    BOOST_REQUIRE_EQUAL(ab->getCommodityFlow(0), 1);
+    BOOST_REQUIRE_EQUAL(bt->getCommodityFlow(0), 1);
+    BOOST_REQUIRE_EQUAL(sa->getCommodityFlow(1), 0);
+    BOOST_REQUIRE_EQUAL(at->getCommodityFlow(1), 0);
+    BOOST_REQUIRE_EQUAL(st->getCommodityFlow(1), 1);
+    BOOST_REQUIRE_EQUAL(sb->getCommodityFlow(0) + sb->getCommodityFlow(1), 0);
+
+    MultiCommodityMinCostFlow minCostFlow(flowGraph, commodities, LPSolver::GLPK_SOLVER);
+    BOOST_REQUIRE_MESSAGE(minCostFlow.validateInflow().empty(), "Solution satisfies the min trans flow");
+
+    // Without a feasible solution the previous flows are reset
+    t->setCommoditySupply(0, 0);
+    BOOST_REQUIRE_EQUAL(solver.solve(), LPSolver::STATUS_INFEASIBLE);
+    BOOST_REQUIRE_EQUAL(sa->getCommodityFlow(0), 0);
+    BOOST_REQUIRE_EQUAL(st->getCommodityFlow(1), 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(async_min_cost_flow, TransportNetworkSetup)
+{
+    owlapi::model::IRI organizationModelIRI = "http://www.rock-robotics.org/2015/12/projects/TransTerrA";
+    moreorg::OrganizationModel::Ptr om = moreorg::OrganizationModel::getInstance(organizationModelIRI);
+    owlapi::model::IRI location_image_provider = vocabulary::OM::resolve("ImageProvider");
+
+    Mission baseMission(om);
+    baseMission.addResourceLocationCardinalityConstraint(l[0], t[0], t[1], location_image_provider);
+    baseMission.addResourceLocationCardinalityConstraint(l[1], t[2], t[3], location_image_provider);
+    baseMission.addConstraint(make_shared<pa::QualitativeTimePointConstraint>(t[1],t[2], pa::QualitativeTimePointConstraint::Less));
+    baseMission.prepareTimeIntervals();
+
+    moreorg::ModelPool modelPool;
+    modelPool[ vocabulary::OM::resolve("Sherpa") ] = 2;
+    modelPool[ vocabulary::OM::resolve("CREX") ] = 2;
+    baseMission.setAvailableResources(modelPool);
+
+    // The random branching has to be seeded identically for both runs
+    qxcfg::Configuration syncConfiguration;
+    syncConfiguration.setValue("TransportNetwork/search/options/portfolio/seed", "42");
+
+    using namespace solvers;
+    csp::TransportNetwork::SolutionList solutions;
+    {
+        Mission::Ptr mission = make_shared<Mission>(baseMission);
+        solutions = csp::TransportNetwork::solve(mission, 1, syncConfiguration);
+        BOOST_REQUIRE_MESSAGE(!solutions.empty(), "Solution found with synchronous evaluation");
+    }
+
+    csp::TransportNetwork::SolutionList asyncSolutions;
+    {
+        qxcfg::Configuration configuration = syncConfiguration;
+        configuration.setValue("TransportNetwork/search/options/lp/async/enabled", "true");
+        configuration.setValue("TransportNetwork/search/options/lp/async/workers", "2");
+
+        Mission::Ptr mission = make_shared<Mission>(baseMission);
+        asyncSolutions = csp::TransportNetwork::solve(mission, 1, configuration);
+        BOOST_REQUIRE_MESSAGE(!asyncSolutions.empty(), "Solution found with asynchronous evaluation");
+    }
+
+    // Candidates are completed in search order, so that the first solution
+    // is the same as for the synchronous evaluation
+    const csp::TransportNetwork::Solution& solution = solutions.front();
+    const csp::TransportNetwork::Solution& asyncSolution = asyncSolutions.front();
+    BOOST_REQUIRE_EQUAL(solution.toString(), asyncSolution.toString());
+    BOOST_REQUIRE_EQUAL(solution.getSolutionAnalysis().getCost(), asyncSolution.getSolutionAnalysis().getCost());
+    BOOST_REQUIRE_EQUAL(solution.getMinCostFlowSolution().getGraph()->size(),
+            asyncSolution.getMinCostFlowSolution().getGraph()->size());
+}
+
+BOOST_FIXTURE_TEST_CASE(mission_upper_bound_violated, TransportNetworkSetup)
+{
+    owlapi::model::IRI organizationModelIRI = "http://www.rock-robotics.org/2015/12/projects/TransTerrA";
+    moreorg::OrganizationModel::Ptr om = moreorg::OrganizationModel::getInstance(organizationModelIRI);
+    owlapi::model::IRI location_image_provider = vocabulary::OM::resolve("ImageProvider");
+
+    Mission::Ptr mission = make_shared<Mission>(om);
+    mission->addResourceLocationCardinalityConstraint(l[0], t[0], t[1], location_image_provider);
+    mission->addResourceLocationCardinalityConstraint(l[1], t[2], t[3], location_image_provider);
+    mission->addConstraint(make_shared<pa::QualitativeTimePointConstraint>(t[1],t[2], pa::QualitativeTimePointConstraint::Less));
+
+    // travelling from loc0 to loc1 takes longer than allowed
+    solvers::temporal::IntervalConstraint::Ptr maxDuration = make_shared<solvers::temporal::IntervalConstraint>(t[1], t[2]);
+    maxDuration->addInterval(solvers::temporal::Bounds(0, 0.001));
+    mission->addConstraint(maxDuration);
+    mission->prepareTimeIntervals();
+
+    moreorg::ModelPool modelPool;
+    modelPool[ vocabulary::OM::resolve("Sherpa") ] = 1;
+    mission->setAvailableResources(modelPool);
+
+    using namespace solvers;
+    csp::TransportNetwork::SolutionList solutions;
+    BOOST_REQUIRE_NO_THROW(solutions = csp::TransportNetwork::solve(mission, 1));
+    BOOST_REQUIRE_MESSAGE(!solutions.empty(), "Solution found despite violated upper bound");
+
+    const SolutionAnalysis& analysis = solutions.front().getSolutionAnalysis();
+    BOOST_REQUIRE_MESSAGE(!analysis.isTimeConsistent(), "Solution violates the upper bound");
+    BOOST_REQUIRE_MESSAGE(analysis.getTimeHorizon() > 0.001, "Time horizon accounts for the travel time, but was " << analysis.getTimeHorizon());
+}
+
+BOOST_AUTO_TEST_CASE(stopping_criteria)
+{
+    using namespace templ::solvers;
+
+    {
+        StoppingCriteria criteria;
+        criteria.add( StoppingCriteria::targetCost(10) )
+            .add( StoppingCriteria::nodeLimit(100) );
+        criteria.start();
+        BOOST_REQUIRE_MESSAGE(!criteria.isMet(), "Criteria should not be met without progress");
+
+        // copies share the progress
+        StoppingCriteria copy = criteria;
+        BOOST_REQUIRE(copy.updateSolution(20, 2));
+        BOOST_REQUIRE(!copy.updateSolution(25, 1));
+        BOOST_REQUIRE_MESSAGE(!criteria.isMet(), "Cost is above target");
+        BOOST_REQUIRE(copy.updateSolution(5, 1));
+        BOOST_REQUIRE_MESSAGE(criteria.isMet(), "Target cost should be met");
+        BOOST_TEST_MESSAGE("Reason: " << criteria.getReason());
+
+        criteria.start();
+        BOOST_REQUIRE_MESSAGE(!criteria.isMet(), "Criteria should not be met after reset");
+        criteria.updateSearchStatistics(100, 0);
+        BOOST_REQUIRE_MESSAGE(criteria.isMet(), "Node limit should be met");
+    }
+    {
+        // all of: no flaws and stagnation
+        StoppingCriteria criteria;
+        criteria.add( StoppingCriteria::allOf({ StoppingCriteria::targetFlaws(0),
+                    StoppingCriteria::stagnation(0) }) );
+        criteria.start();
+        criteria.updateSolution(10, 1);
+        BOOST_REQUIRE_MESSAGE(!criteria.isMet(), "Flaws remain");
+        criteria.updateSolution(10, 0);
+        BOOST_REQUIRE_MESSAGE(criteria.isMet(), "No flaws and no improvement");
+    }
+    {
+        StoppingCriteria criteria;
+        criteria.add( StoppingCriteria::memoryLimit(1) );
+        criteria.start();
+        BOOST_REQUIRE_MESSAGE(StoppingCriteria::getMemoryUsage() > 0, "Memory usage should be available");
+        BOOST_REQUIRE_MESSAGE(criteria.isMet(), "Memory limit should be met");
+    }
+    {
+        qxcfg::Configuration configuration;
+        StoppingCriteria criteria = StoppingCriteria::fromConfiguration(configuration);
+        BOOST_REQUIRE_MESSAGE(criteria.empty(), "No criteria should be configured by default");
+    }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -466,6 +466,15 @@ BOOST_AUTO_TEST_CASE(example_network_1)
 
     graph_analysis::io::GraphIO::write("/tmp/templ-test-loose_path_consistency-example_1-network-result.gexf", graph);
     BOOST_REQUIRE_MESSAGE(expected.equals(graph), "Expected equal graphs, actual: "<<expected.equals(graph));
+
+    // in place computation has to yield the same network
+    for(size_t threads = 1; threads <= 2; ++threads)
+    {
+        TemporalConstraintNetwork network(tcn);
+        network.setNumberOfThreads(threads);
+        BOOST_REQUIRE_MESSAGE(LoosePathConsistency::enforce(network), "Network is consistent using " << threads << " threads");
+        BOOST_REQUIRE_MESSAGE(expected.equals(network.getDistanceGraph()), "Expected equal graphs for in place computation using " << threads << " threads");
+    }
 }
 
 
@@ -1,4 +1,5 @@
 #include <boost/test/unit_test.hpp>
+#include <algorithm>
 #include <templ/solvers/temporal/QualitativeTemporalConstraintNetwork.hpp>
 #include <templ/solvers/temporal/point_algebra/TimePointComparator.hpp>
 #include <templ/Constraint.hpp>
@@ -171,5 +172,64 @@ BOOST_AUTO_TEST_CASE(consistency_checking)
     }
 }
 
+BOOST_AUTO_TEST_CASE(relation_matrix)
+{
+    using namespace point_algebra;
+    BOOST_REQUIRE(RelationMatrix::composition(RelationMatrix::LESS, RelationMatrix::LESS | RelationMatrix::EQUAL) == RelationMatrix::LESS);
+    BOOST_REQUIRE(RelationMatrix::composition(RelationMatrix::LESS, RelationMatrix::GREATER) == RelationMatrix::UNIVERSAL);
+    BOOST_REQUIRE(RelationMatrix::converse(RelationMatrix::LESS | RelationMatrix::EQUAL) == (RelationMatrix::GREATER | RelationMatrix::EQUAL));
+    for(int t = QualitativeTimePointConstraint::Empty; t < QualitativeTimePointConstraint::TypeEndMarker; ++t)
+    {
+        QualitativeTimePointConstraint::Type type = static_cast<QualitativeTimePointConstraint::Type>(t);
+        BOOST_REQUIRE(RelationMatrix::toType(RelationMatrix::fromType(type)) == type);
+    }
+
+    QualitativeTemporalConstraintNetwork qtcn;
+    TimePoint::Ptr tp0(new QualitativeTimePoint("tp0"));
+    TimePoint::Ptr tp1(new QualitativeTimePoint("tp1"));
+    TimePoint::Ptr tp2(new QualitativeTimePoint("tp2"));
+
+    qtcn.addQualitativeConstraint(tp0, tp1, QualitativeTimePointConstraint::Less);
+    qtcn.addQualitativeConstraint(tp1, tp2, QualitativeTimePointConstraint::LessOrEqual);
+    BOOST_REQUIRE_MESSAGE(qtcn.isConsistent(QualitativeTemporalConstraintNetwork::TCN_MATRIX), "qtcn is consistent");
+
+    const std::vector<graph_analysis::Vertex::Ptr>& vertices = qtcn.getRelationMatrixVertices();
+    size_t i0 = std::find(vertices.begin(), vertices.end(), tp0) - vertices.begin();
+    size_t i2 = std::find(vertices.begin(), vertices.end(), tp2) - vertices.begin();
+    BOOST_REQUIRE(i0 < vertices.size() && i2 < vertices.size());
+    BOOST_REQUIRE_MESSAGE(qtcn.getRelationMatrix().get(i0, i2) == RelationMatrix::LESS, "tp0 < tp2 is entailed");
+
+    qtcn.synchronizeGraph();
+    BOOST_REQUIRE_MESSAGE(qtcn.getQualitativeConstraint(tp0, tp2) == QualitativeTimePointConstraint::Less, "tp0 < tp2 written back to the graph");
+
+    qtcn.addQualitativeConstraint(tp2, tp0, QualitativeTimePointConstraint::Less);
+    BOOST_REQUIRE_MESSAGE(!qtcn.isConsistent(QualitativeTemporalConstraintNetwork::TCN_MATRIX), "qtcn is inconsistent: tp2 < tp0 contradicts tp0 < tp2");
+}
+
+BOOST_AUTO_TEST_CASE(relation_matrix_parallel)
+{
+    using namespace point_algebra;
+    size_t size = 100;
+    RelationMatrix matrix(size);
+    for(size_t i = 0; i + 1 < size; ++i)
+    {
+        matrix.constrain(i, i + 1, (i % 3) ? RelationMatrix::LESS : (RelationMatrix::LESS | RelationMatrix::EQUAL));
+    }
+
+    RelationMatrix sequential = matrix;
+    RelationMatrix parallel = matrix;
+    BOOST_REQUIRE_MESSAGE(sequential.pathConsistency(), "chain is consistent");
+    BOOST_REQUIRE_MESSAGE(parallel.pathConsistency(4), "chain is consistent using 4 threads");
+    for(size_t i = 0; i < size; ++i)
+    {
+        for(size_t j = 0; j < size; ++j)
+        {
+            BOOST_REQUIRE_MESSAGE(sequential.get(i,j) == parallel.get(i,j), "relation (" << i << "," << j << ") is independent of the number of threads");
+        }
+    }
+
+    matrix.constrain(size - 1, 0, RelationMatrix::LESS);
+    BOOST_REQUIRE_MESSAGE(!matrix.pathConsistency(4), "cycle is inconsistent using 4 threads");
+}
 
 BOOST_AUTO_TEST_SUITE_END()
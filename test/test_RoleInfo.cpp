@@ -1,5 +1,7 @@
 #include <boost/test/unit_test.hpp>
 #include <sstream>
+#include <thread>
+#include <atomic>
 #include <templ/RoleInfo.hpp>
 
 using namespace templ;
@@ -40,4 +42,81 @@ BOOST_AUTO_TEST_CASE(relative_complement)
     }
 }
 
+BOOST_AUTO_TEST_CASE(role_sets)
+{
+    std::vector<Role> roles;
+    for(size_t i = 0; i < 100; ++i)
+    {
+        Role role(i, "http://model/instance#0");
+        roles.push_back(role);
+    }
+
+    RoleInfo a;
+    a.addRole(roles[0], RoleInfo::ASSIGNED);
+    a.addRole(roles[80], RoleInfo::ASSIGNED);
+    a.addRole(roles[1], RoleInfo::REQUIRED);
+    a.addRole(roles[80], RoleInfo::REQUIRED);
+
+    BOOST_REQUIRE_EQUAL(a.getRoles(RoleInfo::ASSIGNED).size(), 2u);
+    a.addRole(roles[2], "assigned");
+    BOOST_REQUIRE_EQUAL(a.getRoles(RoleInfo::ASSIGNED).size(), 3u);
+    BOOST_REQUIRE_EQUAL(a.getRoleIds(RoleInfo::ASSIGNED).count(), 3u);
+    a.removeRole(roles[2], RoleInfo::ASSIGNED);
+    BOOST_REQUIRE_EQUAL(a.getRoles(RoleInfo::ASSIGNED).size(), 2u);
+    BOOST_REQUIRE_EQUAL(a.getAllRoleIds().count(), 4u);
+    BOOST_REQUIRE(!a.hasRole(roles[2], RoleInfo::ASSIGNED));
+
+    BOOST_REQUIRE(a.getStatus(roles[80]) == RoleInfo::REQUIRED_ASSIGNED);
+    BOOST_REQUIRE(a.getStatus(roles[1]) == RoleInfo::REQUIRED_UNASSIGNED);
+    BOOST_REQUIRE(a.getStatus(roles[0]) == RoleInfo::NOTREQUIRED_ASSIGNED);
+    BOOST_REQUIRE(a.getStatus(roles[50]) == RoleInfo::UNKNOWN_STATUS);
+
+    BOOST_REQUIRE_EQUAL(a.getRoles(std::set<RoleInfo::Tag>({RoleInfo::ASSIGNED, RoleInfo::REQUIRED})).size(), 3u);
+    BOOST_REQUIRE_EQUAL(a.getIntersection("assigned","required").size(), 1u);
+    BOOST_REQUIRE_EQUAL(a.getSymmetricDifference("assigned","required").size(), 2u);
+    BOOST_REQUIRE_EQUAL(a.getModelPool({RoleInfo::ASSIGNED})[roles[0].getModel()], 2u);
+
+    RoleRegistry::Id id;
+    BOOST_REQUIRE(RoleRegistry::getInstance().findId(roles[80], id));
+    BOOST_REQUIRE(RoleRegistry::getInstance().getRole(id) == roles[80]);
+    BOOST_REQUIRE(a.getRoleIds(RoleInfo::ASSIGNED).test(id));
+}
+
+BOOST_AUTO_TEST_CASE(role_registry_concurrent_access)
+{
+    RoleRegistry& registry = RoleRegistry::getInstance();
+    // Boost.Test assertions must not be used from multiple threads
+    std::atomic<size_t> mismatches(0);
+    std::vector<std::thread> threads;
+    for(size_t t = 0; t < 4; ++t)
+    {
+        threads.push_back(std::thread([&registry, &mismatches]()
+                {
+                    for(size_t i = 0; i < 2000; ++i)
+                    {
+                        Role role(i, "http://model/instance#registry");
+                        RoleRegistry::Id id = registry.getId(role);
+                        RoleRegistry::Id foundId;
+                        if(!registry.findId(role, foundId) || foundId != id
+                                || !(registry.getRole(id) == role))
+                        {
+                            ++mismatches;
+                        }
+                    }
+                }));
+    }
+    for(std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    BOOST_REQUIRE_EQUAL(mismatches.load(), 0u);
+
+    for(size_t i = 0; i < 2000; ++i)
+    {
+        RoleRegistry::Id id;
+        BOOST_REQUIRE(registry.findId(Role(i, "http://model/instance#registry"), id));
+    }
+    BOOST_REQUIRE_THROW(registry.getRole(registry.size()), std::out_of_range);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -133,4 +133,39 @@ BOOST_AUTO_TEST_CASE(value_propagation_3)
     }
 }
 
+BOOST_AUTO_TEST_CASE(incremental_consistency)
+{
+    bool incremental = true;
+    SimpleTemporalNetwork stn(incremental);
+
+    point_algebra::TimePoint::Ptr tp0(new point_algebra::TimePoint(0,100));
+    point_algebra::TimePoint::Ptr tp1(new point_algebra::TimePoint(0,100));
+    point_algebra::TimePoint::Ptr tp2(new point_algebra::TimePoint(0,100));
+
+    BOOST_REQUIRE_MESSAGE(stn.addInterval(tp0, tp1, Bounds(10,20)), "tp0 -> tp1 is consistent");
+    BOOST_REQUIRE_MESSAGE(stn.addInterval(tp1, tp2, Bounds(10,20)), "tp1 -> tp2 is consistent");
+    BOOST_REQUIRE_MESSAGE(!stn.addInterval(tp0, tp2, Bounds(50,60)), "tp0 -> tp2 with [50,60] contradicts [20,40]");
+    BOOST_REQUIRE(!stn.isConsistent());
+    BOOST_REQUIRE_MESSAGE(!stn.addInterval(tp0, tp2, Bounds(30,35)), "network remains inconsistent until retraction");
+
+    stn.retractLastInterval();
+    stn.retractLastInterval();
+    BOOST_REQUIRE_MESSAGE(stn.isConsistent(), "consistent after retraction");
+    BOOST_REQUIRE_EQUAL(stn.getEdgeNumber(), 4);
+
+    BOOST_REQUIRE_MESSAGE(stn.addInterval(tp0, tp2, Bounds(30,35)), "tp0 -> tp2 with [30,35] is consistent");
+    BOOST_REQUIRE_MESSAGE(!stn.addInterval(tp2, tp0, Bounds(0,10)), "tp2 before tp0 contradicts tp0 -> tp2");
+
+    SimpleTemporalNetwork full;
+    full.addInterval(tp0, tp1, Bounds(10,20));
+    full.addInterval(tp1, tp2, Bounds(10,20));
+    full.addInterval(tp0, tp2, Bounds(30,35));
+    full.addInterval(tp2, tp0, Bounds(0,10));
+    BOOST_REQUIRE_MESSAGE(!full.isConsistent(), "full check agrees with incremental check");
+
+    stn.retractLastInterval();
+    BOOST_REQUIRE(stn.isConsistent());
+    BOOST_REQUIRE_THROW(full.retractLastInterval(), std::runtime_error);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
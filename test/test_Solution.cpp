@@ -1,4 +1,6 @@
 #include <templ/solvers/Solution.hpp>
+#include <templ/solvers/Session.hpp>
+#include <thread>
 #include <templ/Mission.hpp>
 #include <templ/io/MissionWriter.hpp>
 #include <templ/io/MissionReader.hpp>
@@ -103,6 +105,66 @@ BOOST_FIXTURE_TEST_CASE(should_add_role, SolutionFixture)
 
 }
 
+BOOST_FIXTURE_TEST_CASE(space_time_network_copy_on_write, SolutionFixture)
+{
+    owlapi::model::IRI organizationModelIRI = "http://www.rock-robotics.org/2017/11/vrp";
+    moreorg::OrganizationModel::Ptr om = moreorg::OrganizationModel::getInstance(organizationModelIRI);
+    prepareSolution(om);
+
+    SpaceTime::Network copy(network);
+    BOOST_REQUIRE_MESSAGE(copy.getGraph() == network.getGraph(), "Copy shares the graph");
+    BOOST_REQUIRE(copy.tupleByKeys(locations[0], timepoints[0]) == network.tupleByKeys(locations[0], timepoints[0]));
+
+    SpaceTime::Network::tuple_t::Ptr source = copy.tupleByKeys(locations[0], timepoints[0]);
+    SpaceTime::Network::tuple_t::Ptr target = copy.tupleByKeys(locations[1], timepoints[1]);
+    RoleInfoWeightedEdge::Ptr edge = make_shared<RoleInfoWeightedEdge>(source, target, 1);
+    copy.getMutableGraph()->addEdge(edge);
+
+    BOOST_REQUIRE_MESSAGE(copy.getGraph() != network.getGraph(), "Modified copy has its own graph");
+    BOOST_REQUIRE_EQUAL(copy.getGraph()->getEdges<RoleInfoWeightedEdge>(source, target).size(), 1);
+    BOOST_REQUIRE_MESSAGE(network.getGraph()->getEdges<RoleInfoWeightedEdge>(source, target).empty(),
+            "Original network is not modified");
+
+    solvers::Solution solution(network, om);
+    solvers::Solution solutionCopy = solution;
+    solutionCopy.getMutableGraph()->addEdge(make_shared<RoleInfoWeightedEdge>(source, target, 1));
+    BOOST_REQUIRE_EQUAL(solutionCopy.getGraph()->getEdges<RoleInfoWeightedEdge>(source, target).size(), 1);
+    BOOST_REQUIRE_MESSAGE(solution.getGraph()->getEdges<RoleInfoWeightedEdge>(source, target).empty(),
+            "Original solution is not modified");
+}
+
+BOOST_FIXTURE_TEST_CASE(space_time_network_index_access, SolutionFixture)
+{
+    owlapi::model::IRI organizationModelIRI = "http://www.rock-robotics.org/2017/11/vrp";
+    moreorg::OrganizationModel::Ptr om = moreorg::OrganizationModel::getInstance(organizationModelIRI);
+    prepareSolution(om);
+
+    for(size_t t = 0; t < timepoints.size(); ++t)
+    {
+        for(size_t l = 0; l < locations.size(); ++l)
+        {
+            BOOST_REQUIRE(network.tryTupleByIndex(l,t) == network.tupleByKeys(locations[l], timepoints[t]));
+        }
+
+        BOOST_REQUIRE_EQUAL(static_cast<size_t>(std::distance(network.layerBegin(t), network.layerEnd(t))), locations.size());
+        SpaceTime::Network::tuple_t::PtrList::const_iterator cit = network.layerBegin(t);
+        for(; cit != network.layerEnd(t); ++cit)
+        {
+            BOOST_REQUIRE((*cit)->second() == timepoints[t]);
+        }
+    }
+
+    BOOST_REQUIRE_MESSAGE(!network.tryTupleByIndex(locations.size(), 0), "Out of range index yields no tuple");
+    BOOST_REQUIRE_MESSAGE(!network.tryTupleByKeys(sym::Location::create("unknown"), timepoints[0]), "Unknown location yields no tuple");
+    BOOST_REQUIRE_THROW(network.tupleByKeys(sym::Location::create("unknown"), timepoints[0]), std::invalid_argument);
+    BOOST_REQUIRE_THROW(network.layerBegin(timepoints.size()), std::out_of_range);
+
+    SpaceTime::Network::tuple_t::Ptr tuple = network.tupleByKeys(locations[2], timepoints[3]);
+    BOOST_REQUIRE(network.getValue(tuple) == locations[2]);
+    BOOST_REQUIRE_EQUAL(network.getColumn(tuple), 2u);
+    BOOST_REQUIRE_EQUAL(network.getRow(tuple), 3u);
+}
+
 BOOST_FIXTURE_TEST_CASE(load_solution, SolutionFixture)
 {
     owlapi::model::IRI organizationModelIRI = "http://www.rock-robotics.org/2017/11/vrp";
@@ -140,4 +202,42 @@ BOOST_AUTO_TEST_CASE(narrow_mission)
     io::MissionWriter::write("/tmp/test-templ-solution-narrowed-mission.xml", *narrowedMission.get());
 }
 
+BOOST_AUTO_TEST_CASE(session_streaming)
+{
+    using namespace templ::solvers;
+
+    Session::Ptr session = make_shared<Session>();
+    size_t callbackCount = 0;
+    session->setSolutionCallback([&callbackCount](const Solution& solution)
+            {
+                // stop after the second solution
+                return ++callbackCount < 2;
+            });
+
+    std::thread producer([session]()
+            {
+                for(size_t i = 0; i < 5; ++i)
+                {
+                    if(!session->addSolution(Solution()))
+                    {
+                        break;
+                    }
+                }
+                session->setFinished();
+            });
+
+    Solution solution;
+    size_t count = 0;
+    while(session->waitForSolution(count, solution))
+    {
+        ++count;
+    }
+    producer.join();
+
+    BOOST_REQUIRE_MESSAGE(session->isStopRequested(), "Callback should have requested the stop");
+    BOOST_REQUIRE_MESSAGE(count == 2, "Expected 2 solutions, but got " << count);
+    BOOST_REQUIRE_MESSAGE(session->getSolutions().size() == 2, "Expected 2 solutions in session");
+    BOOST_REQUIRE_MESSAGE(!session->waitForSolution(2, solution), "Finished session should not block");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
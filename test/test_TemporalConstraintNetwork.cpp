@@ -130,6 +130,83 @@ BOOST_AUTO_TEST_CASE(ult)
 
 }
 
+BOOST_AUTO_TEST_CASE(ult_inconsistent)
+{
+    TemporalConstraintNetwork tcn;
+    point_algebra::TimePoint::Ptr v0(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+    point_algebra::TimePoint::Ptr v1(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+    point_algebra::TimePoint::Ptr v2(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+
+    IntervalConstraint::Ptr i0(new IntervalConstraint(v0,v1));
+    i0->addInterval(Bounds(10,20));
+    IntervalConstraint::Ptr i1(new IntervalConstraint(v1,v2));
+    i1->addInterval(Bounds(10,20));
+    IntervalConstraint::Ptr i2(new IntervalConstraint(v0,v2));
+    i2->addInterval(Bounds(0,5));
+    i2->addInterval(Bounds(50,60));
+
+    tcn.addIntervalConstraint(i0);
+    tcn.addIntervalConstraint(i1);
+    tcn.addIntervalConstraint(i2);
+
+    BOOST_REQUIRE_THROW(tcn.upperLowerTightening(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(earliest_assignment)
+{
+    TemporalConstraintNetwork tcn;
+    point_algebra::TimePoint::Ptr v0(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+    point_algebra::TimePoint::Ptr v1(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+    point_algebra::TimePoint::Ptr v2(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+    point_algebra::TimePoint::Ptr v3(new point_algebra::TimePoint(0,std::numeric_limits<uint64_t>::max()));
+
+    double max = std::numeric_limits<double>::max();
+    IntervalConstraint::Ptr i0(new IntervalConstraint(v0,v1));
+    i0->addInterval(Bounds(10,max));
+    IntervalConstraint::Ptr i1(new IntervalConstraint(v1,v3));
+    i1->addInterval(Bounds(5,max));
+    IntervalConstraint::Ptr i2(new IntervalConstraint(v0,v2));
+    i2->addInterval(Bounds(30,max));
+    i2->addInterval(Bounds(20,max));
+    IntervalConstraint::Ptr i3(new IntervalConstraint(v2,v3));
+    i3->addInterval(Bounds(0,max));
+
+    tcn.addIntervalConstraint(i0);
+    tcn.addIntervalConstraint(i1);
+    tcn.addIntervalConstraint(i2);
+    tcn.addIntervalConstraint(i3);
+
+    TemporalConstraintNetwork::Assignment assignment;
+    BOOST_REQUIRE_MESSAGE(tcn.getEarliestAssignment(assignment), "Earliest assignment of acyclic network");
+    BOOST_REQUIRE_EQUAL(assignment[v0], 0);
+    BOOST_REQUIRE_EQUAL(assignment[v1], 10);
+    BOOST_REQUIRE_EQUAL(assignment[v2], 30);
+    BOOST_REQUIRE_EQUAL(assignment[v3], 30);
+    BOOST_REQUIRE_EQUAL(TemporalConstraintNetwork::getTimeHorizon(assignment), 30);
+
+    // an upper bound that delays v1
+    IntervalConstraint::Ptr i4(new IntervalConstraint(v1,v2));
+    i4->addInterval(Bounds(0,12));
+    tcn.addIntervalConstraint(i4);
+    BOOST_REQUIRE_MESSAGE(tcn.getEarliestAssignment(assignment), "Earliest assignment with upper bound");
+    BOOST_REQUIRE_EQUAL(assignment[v1], 18);
+    BOOST_REQUIRE_EQUAL(assignment[v3], 30);
+
+    // upper bound that cannot be met
+    IntervalConstraint::Ptr i5(new IntervalConstraint(v0,v3));
+    i5->addInterval(Bounds(0,25));
+    tcn.addIntervalConstraint(i5);
+    BOOST_REQUIRE_MESSAGE(!tcn.getEarliestAssignment(assignment), "Inconsistent network has no earliest assignment");
+    BOOST_REQUIRE_MESSAGE(tcn.getEarliestAssignment(assignment, true), "Earliest assignment without upper bounds");
+    BOOST_REQUIRE_EQUAL(assignment[v1], 10);
+    BOOST_REQUIRE_EQUAL(assignment[v3], 30);
+
+    tcn.stpWithConjunctiveIntervals();
+    int numberOfEdges = tcn.getEdgeNumber();
+    BOOST_REQUIRE_MESSAGE(!tcn.minNetwork(), "Inconsistent network has no minimal network");
+    BOOST_REQUIRE_EQUAL(tcn.getEdgeNumber(), numberOfEdges);
+}
+
 BOOST_AUTO_TEST_CASE(io)
 {
     using namespace templ::solvers::temporal;
@@ -225,5 +302,69 @@ BOOST_AUTO_TEST_CASE(comparator_validation)
 
 }
 
+BOOST_AUTO_TEST_CASE(comparator_order_cache)
+{
+    using namespace templ::solvers::temporal;
+    using namespace templ::solvers::temporal::point_algebra;
+
+    QualitativeTemporalConstraintNetwork::Ptr tpc(new QualitativeTemporalConstraintNetwork());
+    typedef QualitativeTimePointConstraint QTPC;
+
+    QualitativeTimePoint::Ptr t0 = make_shared<QualitativeTimePoint>("t0");
+    QualitativeTimePoint::Ptr t1 = make_shared<QualitativeTimePoint>("t1");
+    QualitativeTimePoint::Ptr t2 = make_shared<QualitativeTimePoint>("t2");
+    QualitativeTimePoint::Ptr t3 = make_shared<QualitativeTimePoint>("t3");
+
+    tpc->addQualitativeConstraint(t0, t1, QTPC::Less);
+    tpc->addQualitativeConstraint(t3, t2, QTPC::Greater);
+
+    point_algebra::TimePointComparator comparator(tpc);
+    BOOST_REQUIRE_MESSAGE(comparator.lessThan(t0, t1) && !comparator.greaterThan(t0, t1), "Expected t0 < t1");
+    BOOST_REQUIRE_MESSAGE(comparator.greaterThan(t2, t1) && comparator.lessThan(t2, t1), "Expected t1 and t2 to be unordered");
+    BOOST_REQUIRE_EQUAL(comparator.getRank(t1), 2u);
+
+    // the cached order has to be updated
+    tpc->addQualitativeConstraint(t2, t1, QTPC::Less);
+    tpc->addQualitativeConstraint(t3, t1, QTPC::LessOrEqual);
+    BOOST_REQUIRE_MESSAGE(!comparator.greaterThan(t2, t1), "Expected t2 < t1 after adding constraint");
+    BOOST_REQUIRE_EQUAL(comparator.getRank(t1), 4u);
+
+    TimePoint::PtrList timepoints = { t1, t3, t0, t2 };
+    comparator.sort(timepoints);
+    BOOST_REQUIRE_MESSAGE(timepoints.back() == t1, "Expected t1 to be last, but was " << timepoints.back()->toString());
+    BOOST_REQUIRE_MESSAGE(std::find(timepoints.begin(), timepoints.end(), t2) < std::find(timepoints.begin(), timepoints.end(), t3),
+            "Expected t2 before t3");
+}
+
+BOOST_AUTO_TEST_CASE(dense_distance_matrix)
+{
+    // Chain over more than one block, where the backward edges allow to
+    // reach each vertex from its successor
+    size_t size = 100;
+    DenseDistanceMatrix distances(size);
+    for(size_t i = 0; i + 1 < size; ++i)
+    {
+        distances.relax(i, i + 1, 10);
+        distances.relax(i, i + 1, 5);
+        distances.relax(i + 1, i, -1);
+    }
+
+    DenseDistanceMatrix sequential = distances;
+    BOOST_REQUIRE_MESSAGE(sequential.allShortestPaths(1), "chain has no negative cycle");
+    BOOST_REQUIRE_MESSAGE(distances.allShortestPaths(4), "chain has no negative cycle using 4 threads");
+    for(size_t i = 0; i < size; ++i)
+    {
+        for(size_t j = 0; j < size; ++j)
+        {
+            double expected = j >= i ? 5.0*(j - i) : -1.0*(i - j);
+            BOOST_REQUIRE_MESSAGE(distances.get(i,j) == expected, "distance (" << i << "," << j << "): expected " << expected << ", actual " << distances.get(i,j));
+            BOOST_REQUIRE_EQUAL(sequential.get(i,j), distances.get(i,j));
+        }
+    }
+
+    distances.relax(size - 1, 0, -5.0*size);
+    BOOST_REQUIRE_MESSAGE(!distances.allShortestPaths(4), "closing the chain creates a negative cycle");
+    BOOST_REQUIRE(distances.hasNegativeCycle());
+}
 
 BOOST_AUTO_TEST_SUITE_END()
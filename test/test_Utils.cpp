@@ -1,6 +1,13 @@
 #include <boost/test/unit_test.hpp>
 
+#include <templ/utils/BitSet.hpp>
 #include <templ/utils/CSVLogger.hpp>
+#include <templ/utils/CopyOnWrite.hpp>
+#include <templ/utils/PhaseTimer.hpp>
+#include <templ/utils/Tracer.hpp>
+#include <boost/filesystem.hpp>
+#include <fstream>
+#include <thread>
 #include <sstream>
 
 using namespace templ;
@@ -42,4 +49,147 @@ BOOST_AUTO_TEST_CASE(csv_logger)
 
 }
 
+BOOST_AUTO_TEST_CASE(phase_timer)
+{
+    using namespace templ::utils;
+
+    PhaseTimer::reset();
+    for(size_t i = 0; i < 3; ++i)
+    {
+        PhaseTimer::Scope timer(PhaseTimer::POST_TIMELINES);
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+
+    PhaseTimer::Statistics statistics = PhaseTimer::getStatistics(PhaseTimer::POST_TIMELINES);
+    BOOST_REQUIRE_MESSAGE(statistics.count == 3, "Expected 3 executions, but got " << statistics.count);
+    BOOST_REQUIRE_MESSAGE(statistics.totalInS >= 0.006, "Expected at least 6ms, but got " << statistics.totalInS);
+    BOOST_REQUIRE(statistics.maxInS <= statistics.totalInS);
+    BOOST_REQUIRE(PhaseTimer::getStatistics(PhaseTimer::SAVE_SOLUTION).count == 0);
+
+    PhaseTimer::setEnabled(false);
+    {
+        PhaseTimer::Scope timer(PhaseTimer::POST_TIMELINES);
+    }
+    PhaseTimer::setEnabled(true);
+    BOOST_REQUIRE_MESSAGE(PhaseTimer::getStatistics(PhaseTimer::POST_TIMELINES).count == 3, "Disabled timer should not count");
+
+    std::string json = PhaseTimer::toJSON();
+    BOOST_REQUIRE_MESSAGE(json.find("\"postTimelines\", \"count\": 3") != std::string::npos, "JSON summary: " << json);
+
+    PhaseTimer::reset();
+    BOOST_REQUIRE(PhaseTimer::getStatistics(PhaseTimer::POST_TIMELINES).count == 0);
+}
+
+BOOST_AUTO_TEST_CASE(tracer)
+{
+    using namespace templ::utils;
+
+    std::string filename = (boost::filesystem::temp_directory_path() / boost::filesystem::unique_path("templ-trace-%%%%-%%%%.json")).string();
+
+    BOOST_REQUIRE(!Tracer::isEnabled());
+    {
+        Tracer::Scope scope("disabled", "test");
+    }
+
+    Tracer::start(filename);
+    BOOST_REQUIRE(Tracer::isEnabled());
+    {
+        Tracer::Scope scope("main", "test");
+        std::thread worker([]()
+                {
+                    Tracer::Scope scope("worker", "test");
+                    Tracer::instant("restart", "test");
+                });
+        BOOST_REQUIRE(Tracer::getThreadId() != 0);
+        worker.join();
+    }
+    BOOST_REQUIRE_MESSAGE(Tracer::getNumberOfEvents() == 3, "Expected 3 events, but got " << Tracer::getNumberOfEvents());
+    Tracer::stop();
+    BOOST_REQUIRE(!Tracer::isEnabled());
+
+    std::ifstream file(filename);
+    std::stringstream content;
+    content << file.rdbuf();
+    std::string trace = content.str();
+    BOOST_REQUIRE_MESSAGE(trace.find("\"traceEvents\"") != std::string::npos, "Trace: " << trace);
+    BOOST_REQUIRE_MESSAGE(trace.find("\"name\":\"worker\"") != std::string::npos, "Trace: " << trace);
+    BOOST_REQUIRE_MESSAGE(trace.find("\"name\":\"disabled\"") == std::string::npos, "Trace: " << trace);
+    boost::filesystem::remove(filename);
+
+    // Recording stops when the recorded code throws
+    try {
+        Tracer::Recording recording(filename);
+        BOOST_REQUIRE(Tracer::isEnabled());
+        throw std::runtime_error("test");
+    } catch(const std::runtime_error&)
+    {
+    }
+    BOOST_REQUIRE(!Tracer::isEnabled());
+    BOOST_REQUIRE(boost::filesystem::exists(filename));
+    boost::filesystem::remove(filename);
+
+    {
+        Tracer::Recording recording("");
+        BOOST_REQUIRE(!Tracer::isEnabled());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(copy_on_write)
+{
+    using namespace templ::utils;
+
+    CopyOnWrite< std::vector<int> > a = std::vector<int>(10,0);
+    CopyOnWrite< std::vector<int> > b = a;
+    BOOST_REQUIRE(a.isShared() && b.isShared());
+    BOOST_REQUIRE(&(*a) == &(*b));
+
+    b.write()[0] = 1;
+    BOOST_REQUIRE(!a.isShared() && !b.isShared());
+    BOOST_REQUIRE_MESSAGE((*a)[0] == 0, "Expected original to be unchanged, but got " << (*a)[0]);
+    BOOST_REQUIRE_MESSAGE((*b)[0] == 1, "Expected copy to be changed, but got " << (*b)[0]);
+
+    // no copy if the data is not shared
+    const int* data = b->data();
+    b.write()[1] = 2;
+    BOOST_REQUIRE(b->data() == data);
+
+    a = std::vector<int>(3,5);
+    BOOST_REQUIRE(a->size() == 3);
+    BOOST_REQUIRE(b->size() == 10);
+}
+
+BOOST_AUTO_TEST_CASE(bit_set)
+{
+    using namespace templ::utils;
+
+    BitSet a;
+    a.set(1);
+    a.set(64);
+    a.set(130);
+    BitSet b;
+    b.set(1);
+    b.set(65);
+
+    BOOST_REQUIRE(a.test(64) && !a.test(65) && !a.test(1000));
+    BOOST_REQUIRE_EQUAL(a.count(), 3u);
+    BOOST_REQUIRE_EQUAL((a | b).count(), 4u);
+    BOOST_REQUIRE_EQUAL((a & b).count(), 1u);
+    BOOST_REQUIRE_EQUAL((a - b).count(), 2u);
+    BOOST_REQUIRE_EQUAL((a ^ b).count(), 3u);
+    BOOST_REQUIRE(a.intersects(b));
+
+    std::vector<size_t> elements;
+    for(size_t i = a.findNext(0); i != BitSet::npos; i = a.findNext(i+1))
+    {
+        elements.push_back(i);
+    }
+    BOOST_REQUIRE(elements == std::vector<size_t>({1,64,130}));
+
+    a.reset(130);
+    BitSet c;
+    c.set(64);
+    c.set(1);
+    BOOST_REQUIRE_MESSAGE(a == c, "Sets with different number of words are equal");
+}
+
 BOOST_AUTO_TEST_SUITE_END()